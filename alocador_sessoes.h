@@ -0,0 +1,263 @@
+/*
+ * TETRIS STACK - ALOCADOR DE SESSÕES
+ *
+ * Alocador de blocos de tamanho fixo para hospedar muitas sessões
+ * (FilaPecas + PilhaReserva) com alta rotatividade, sem passar pelo malloc:
+ * - uma arena grande reservada com mmap (opcionalmente com hugepages),
+ *   da qual os slots são recortados sob demanda
+ * - lista livre intrusiva: o slot liberado guarda o ponteiro para o próximo
+ * - cache por thread com dois "pentes" de até SESSOES_POR_PENTE slots; a
+ *   lista global só é tocada para trocar pentes inteiros, em O(1)
+ *
+ * Uma thread que encerra deve chamar devolverCacheSessoes() para devolver
+ * os slots do seu cache à arena.
+ */
+
+#ifndef ALOCADOR_SESSOES_H
+#define ALOCADOR_SESSOES_H
+
+#include <pthread.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <sys/mman.h>
+
+#define SESSOES_POR_PENTE  64       // Slots movidos de uma vez entre a thread e a arena
+#define ALINHAMENTO_SLOT   16       // Mesmo alinhamento garantido pelo malloc
+
+/**
+ * Slot livre: os primeiros campos do próprio slot formam as listas
+ */
+typedef struct NoLivre {
+    struct NoLivre* proximo;        // Próximo slot do mesmo pente
+    struct NoLivre* proximoPente;   // Próximo pente na lista global (só no primeiro slot)
+    size_t quantidade;              // Slots do pente (só no primeiro slot)
+} NoLivre;
+
+/**
+ * Arena de slots de tamanho fixo
+ */
+typedef struct {
+    unsigned char* memoria;         // Início da região reservada
+    size_t tamanhoSlot;             // Tamanho de cada slot (múltiplo de ALINHAMENTO_SLOT)
+    size_t maxSlots;                // Capacidade da arena
+    size_t slotsRecortados;         // Slots já entregues alguma vez (protegido pela trava)
+    NoLivre* pentes;                // Lista global de pentes devolvidos pelas threads
+    pthread_mutex_t trava;          // Protege pentes e slotsRecortados
+    int hugepages;                  // 1 se a arena usa hugepages explícitas
+} ArenaSessoes;
+
+/**
+ * Cache de uma thread: pente em uso e pente reserva
+ */
+typedef struct {
+    ArenaSessoes* arena;
+    NoLivre* atual;
+    int quantidadeAtual;
+    NoLivre* reserva;
+    int quantidadeReserva;
+} CacheSessoes;
+
+static _Thread_local CacheSessoes cacheSessoes;
+
+// ============================================================================
+// ARENA
+// ============================================================================
+
+/**
+ * Reserva a arena de sessões
+ * @param arena Ponteiro para a arena a inicializar
+ * @param tamanhoSessao Tamanho de cada sessão em bytes
+ * @param maxSessoes Número máximo de sessões vivas ao mesmo tempo
+ * @param usarHugepages 1 para tentar hugepages explícitas (MAP_HUGETLB)
+ * @return 1 se bem-sucedido, 0 caso contrário
+ */
+static inline int criarArenaSessoes(ArenaSessoes* arena, size_t tamanhoSessao, size_t maxSessoes,
+                                    int usarHugepages) {
+    size_t tamanhoSlot = tamanhoSessao < sizeof(NoLivre) ? sizeof(NoLivre) : tamanhoSessao;
+    tamanhoSlot = (tamanhoSlot + ALINHAMENTO_SLOT - 1) & ~(size_t)(ALINHAMENTO_SLOT - 1);
+
+    // Arredonda para 2 MiB para permitir páginas grandes
+    size_t tamanho = (tamanhoSlot * maxSessoes + (2u << 20) - 1) & ~(size_t)((2u << 20) - 1);
+    void* memoria = MAP_FAILED;
+
+    arena->hugepages = 0;
+#ifdef MAP_HUGETLB
+    if (usarHugepages) {
+        // Sem MAP_NORESERVE: se não houver páginas grandes reservadas o mmap
+        // falha aqui, em vez de o processo receber SIGBUS no primeiro acesso
+        memoria = mmap(NULL, tamanho, PROT_READ | PROT_WRITE,
+                       MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        arena->hugepages = memoria != MAP_FAILED;
+    }
+#endif
+    if (memoria == MAP_FAILED) {
+        memoria = mmap(NULL, tamanho, PROT_READ | PROT_WRITE,
+                       MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+        if (memoria == MAP_FAILED) {
+            return 0;
+        }
+#ifdef MADV_HUGEPAGE
+        if (usarHugepages) {
+            madvise(memoria, tamanho, MADV_HUGEPAGE); // Hugepages transparentes, se houver
+        }
+#endif
+    }
+
+    arena->memoria = memoria;
+    arena->tamanhoSlot = tamanhoSlot;
+    arena->maxSlots = tamanho / tamanhoSlot;
+    arena->slotsRecortados = 0;
+    arena->pentes = NULL;
+    pthread_mutex_init(&arena->trava, NULL);
+    return 1;
+}
+
+/**
+ * Libera toda a memória da arena (todas as sessões deixam de existir)
+ * @param arena Ponteiro para a arena
+ */
+static inline void destruirArenaSessoes(ArenaSessoes* arena) {
+    size_t tamanho = (arena->tamanhoSlot * arena->maxSlots + (2u << 20) - 1) & ~(size_t)((2u << 20) - 1);
+    munmap(arena->memoria, tamanho);
+    pthread_mutex_destroy(&arena->trava);
+    arena->memoria = NULL;
+}
+
+/**
+ * Obtém um pente da arena: da lista global ou recortando slots novos
+ * @param arena Ponteiro para a arena
+ * @param quantidade Retorna o número de slots do pente
+ * @return Primeiro slot do pente (NULL se a arena esgotou)
+ */
+static inline NoLivre* obterPente(ArenaSessoes* arena, int* quantidade) {
+    NoLivre* pente = NULL;
+    *quantidade = 0;
+
+    pthread_mutex_lock(&arena->trava);
+    if (arena->pentes != NULL) {
+        pente = arena->pentes;
+        arena->pentes = pente->proximoPente;
+        *quantidade = (int)pente->quantidade;
+        pthread_mutex_unlock(&arena->trava);
+        return pente;
+    }
+
+    size_t inicio = arena->slotsRecortados;
+    size_t fim = inicio + SESSOES_POR_PENTE < arena->maxSlots ? inicio + SESSOES_POR_PENTE : arena->maxSlots;
+    arena->slotsRecortados = fim;
+    pthread_mutex_unlock(&arena->trava);
+
+    // Encadeia os slots novos fora da trava
+    for (size_t i = fim; i > inicio; i--) {
+        NoLivre* no = (NoLivre*)(arena->memoria + (i - 1) * arena->tamanhoSlot);
+        no->proximo = pente;
+        pente = no;
+    }
+    *quantidade = (int)(fim - inicio);
+    return pente;
+}
+
+/**
+ * Devolve um pente à lista global
+ * @param arena Ponteiro para a arena
+ * @param pente Primeiro slot do pente
+ * @param quantidade Número de slots do pente
+ */
+static inline void devolverPente(ArenaSessoes* arena, NoLivre* pente, int quantidade) {
+    pente->quantidade = (size_t)quantidade;
+    pthread_mutex_lock(&arena->trava);
+    pente->proximoPente = arena->pentes;
+    arena->pentes = pente;
+    pthread_mutex_unlock(&arena->trava);
+}
+
+// ============================================================================
+// ALOCAÇÃO E LIBERAÇÃO
+// ============================================================================
+
+/**
+ * Devolve à arena os slots guardados no cache da thread atual
+ * (chamar antes de a thread terminar ou antes de trocar de arena)
+ */
+static inline void devolverCacheSessoes(void) {
+    CacheSessoes* cache = &cacheSessoes;
+    if (cache->arena == NULL) {
+        return;
+    }
+
+    if (cache->quantidadeAtual > 0) {
+        devolverPente(cache->arena, cache->atual, cache->quantidadeAtual);
+    }
+    if (cache->quantidadeReserva > 0) {
+        devolverPente(cache->arena, cache->reserva, cache->quantidadeReserva);
+    }
+    cache->arena = NULL;
+    cache->atual = cache->reserva = NULL;
+    cache->quantidadeAtual = cache->quantidadeReserva = 0;
+}
+
+/**
+ * Aloca o espaço de uma sessão
+ * @param arena Ponteiro para a arena
+ * @return Ponteiro para o slot (não inicializado), ou NULL se a arena esgotou
+ */
+static inline void* alocarSessao(ArenaSessoes* arena) {
+    CacheSessoes* cache = &cacheSessoes;
+
+    if (cache->arena != arena) {
+        devolverCacheSessoes();
+        cache->arena = arena;
+    }
+
+    if (cache->quantidadeAtual == 0) {
+        if (cache->quantidadeReserva > 0) {
+            // Troca para o pente reserva
+            cache->atual = cache->reserva;
+            cache->quantidadeAtual = cache->quantidadeReserva;
+            cache->reserva = NULL;
+            cache->quantidadeReserva = 0;
+        } else {
+            cache->atual = obterPente(arena, &cache->quantidadeAtual);
+            if (cache->atual == NULL) {
+                return NULL; // Arena esgotada
+            }
+        }
+    }
+
+    NoLivre* no = cache->atual;
+    cache->atual = no->proximo;
+    cache->quantidadeAtual--;
+    return no;
+}
+
+/**
+ * Libera o espaço de uma sessão
+ * @param arena Ponteiro para a arena de onde a sessão foi alocada
+ * @param sessao Ponteiro retornado por alocarSessao
+ */
+static inline void liberarSessao(ArenaSessoes* arena, void* sessao) {
+    CacheSessoes* cache = &cacheSessoes;
+
+    if (cache->arena != arena) {
+        devolverCacheSessoes();
+        cache->arena = arena;
+    }
+
+    if (cache->quantidadeAtual == SESSOES_POR_PENTE) {
+        // Pente atual cheio: vira reserva; a reserva anterior (cheia) vai para a arena
+        if (cache->quantidadeReserva == SESSOES_POR_PENTE) {
+            devolverPente(arena, cache->reserva, cache->quantidadeReserva);
+        }
+        cache->reserva = cache->atual;
+        cache->quantidadeReserva = cache->quantidadeAtual;
+        cache->atual = NULL;
+        cache->quantidadeAtual = 0;
+    }
+
+    NoLivre* no = sessao;
+    no->proximo = cache->atual;
+    cache->atual = no;
+    cache->quantidadeAtual++;
+}
+
+#endif // ALOCADOR_SESSOES_H
@@ -0,0 +1,525 @@
+/*
+ * TETRIS STACK - ANALISADOR DE SEQUÊNCIAS DE PEÇAS
+ *
+ * Ferramenta que valida o gerador de peças a partir de sequências muito longas,
+ * processadas em blocos com memória constante:
+ * - frequência de cada tipo de peça
+ * - secas: distância entre peças 'I' consecutivas
+ * - contagem de bigramas e trigramas
+ * - testes qui-quadrado de uniformidade (frequências, teste serial e secas)
+ *
+ * Os tipos são processados como bytes (0 = I, 1 = O, 2 = T, 3 = L, na mesma
+ * ordem de gerarPeca) e as contagens usam SIMD (AVX2 ou SSE2) quando disponível.
+ *
+ * Fontes de peças:
+ *   --gerador SEMENTE N   N peças do gerador do jogo (srand(SEMENTE) + rand() % 4)
+ *   --arquivo ARQ         arquivo com um byte por peça ('I','O','T','L' ou 0..3)
+ *   --eventos ARQ         peças geradas de um fluxo de eventos binário (eventos.h)
+ *   --sequencia ARQ       arquivo de sequência pré-gerado, 2 bits por peça (sequencia.h)
+ *
+ * Compilação: gcc -O2 -march=native analisador.c -o analisador -lm
+ */
+
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+#include "eventos.h"
+#include "sequencia.h"
+
+// ============================================================================
+// DEFINIÇÕES E ESTRUTURAS
+// ============================================================================
+
+#define NUM_TIPOS        4
+#define TAMANHO_BLOCO    (1 << 16)   // Peças processadas por bloco
+#define MAX_SECA         64          // Secas >= MAX_SECA vão para o último balde
+
+static const char tiposPecas[NUM_TIPOS] = {'I', 'O', 'T', 'L'};
+
+/**
+ * Acumuladores da análise (tamanho fixo, independente do número de peças)
+ */
+typedef struct {
+    uint64_t total;                          // Peças analisadas
+    uint64_t frequencias[NUM_TIPOS];         // Contagem por tipo
+    uint64_t trigramas[NUM_TIPOS * NUM_TIPOS * NUM_TIPOS];
+    uint64_t secas[MAX_SECA + 1];            // Histograma de secas
+    uint64_t maiorSeca;                      // Maior seca observada
+    uint64_t posicaoUltimoI;                 // Posição global do último 'I' (+1; 0 = nenhum)
+    unsigned int historico;                  // Últimas duas peças (para n-gramas entre blocos)
+    unsigned char ultimas[2];                // Duas últimas peças da sequência
+} Analise;
+
+/**
+ * Fonte de peças: preenche um bloco com códigos de tipo 0..3
+ */
+typedef struct {
+    FILE* arquivo;
+    int eventos;            // 1 se o arquivo é um fluxo de eventos binário
+    uint64_t restantes;     // Peças restantes no modo gerador
+    SequenciaPecas sequencia;   // Sequência mapeada (--sequencia)
+    uint64_t posicao;           // Próxima peça da sequência mapeada
+} FontePecas;
+
+// ============================================================================
+// KERNELS DE CONTAGEM
+// ============================================================================
+
+/**
+ * Conta quantos bytes do bloco são iguais a cada tipo
+ * @param tipos Bloco de códigos de tipo
+ * @param n Número de peças no bloco
+ * @param contagens Contagens acumuladas por tipo
+ */
+static void contarTipos(const unsigned char* tipos, size_t n, uint64_t contagens[NUM_TIPOS]) {
+    size_t i = 0;
+    uint64_t parciais[NUM_TIPOS] = {0, 0, 0, 0};
+
+#if defined(__AVX2__)
+    // Cada comparação gera -1 nos bytes iguais; subtrair acumula +1 por byte.
+    // A cada 255 iterações os acumuladores de 8 bits são somados com SAD.
+    const __m256i zero = _mm256_setzero_si256();
+    while (i + 32 <= n) {
+        __m256i acumulador[3] = {zero, zero, zero};
+        size_t limite = i + 32 * 255 < n ? i + 32 * 255 : n;
+        for (; i + 32 <= limite; i += 32) {
+            __m256i v = _mm256_loadu_si256((const __m256i*)(tipos + i));
+            for (int t = 1; t < NUM_TIPOS; t++) {
+                acumulador[t - 1] = _mm256_sub_epi8(acumulador[t - 1],
+                    _mm256_cmpeq_epi8(v, _mm256_set1_epi8((char)t)));
+            }
+        }
+        for (int t = 1; t < NUM_TIPOS; t++) {
+            __m256i soma = _mm256_sad_epu8(acumulador[t - 1], zero);
+            parciais[t] += (uint64_t)_mm256_extract_epi64(soma, 0) + (uint64_t)_mm256_extract_epi64(soma, 1) +
+                           (uint64_t)_mm256_extract_epi64(soma, 2) + (uint64_t)_mm256_extract_epi64(soma, 3);
+        }
+    }
+#elif defined(__SSE2__)
+    const __m128i zero = _mm_setzero_si128();
+    while (i + 16 <= n) {
+        __m128i acumulador[3] = {zero, zero, zero};
+        size_t limite = i + 16 * 255 < n ? i + 16 * 255 : n;
+        for (; i + 16 <= limite; i += 16) {
+            __m128i v = _mm_loadu_si128((const __m128i*)(tipos + i));
+            for (int t = 1; t < NUM_TIPOS; t++) {
+                acumulador[t - 1] = _mm_sub_epi8(acumulador[t - 1],
+                    _mm_cmpeq_epi8(v, _mm_set1_epi8((char)t)));
+            }
+        }
+        for (int t = 1; t < NUM_TIPOS; t++) {
+            __m128i soma = _mm_sad_epu8(acumulador[t - 1], zero);
+            parciais[t] += (uint64_t)_mm_cvtsi128_si32(soma) +
+                           (uint64_t)_mm_cvtsi128_si32(_mm_srli_si128(soma, 8));
+        }
+    }
+#endif
+
+    // O tipo 0 ('I') é o complemento dos demais na parte vetorizada
+    parciais[0] = i - parciais[1] - parciais[2] - parciais[3];
+
+    // Restante do bloco (ou todo ele, sem SIMD)
+    for (; i < n; i++) {
+        parciais[tipos[i]]++;
+    }
+    for (int t = 0; t < NUM_TIPOS; t++) {
+        contagens[t] += parciais[t];
+    }
+}
+
+/**
+ * Obtém a máscara de bits das posições com peça 'I' em uma janela do bloco
+ * @param tipos Início da janela
+ * @param largura Retorna o número de posições cobertas pela máscara
+ * @param n Peças restantes a partir do início da janela
+ * @return Máscara com o bit k ligado se tipos[k] == 0
+ */
+static inline uint64_t mascaraPecasI(const unsigned char* tipos, size_t n, size_t* largura) {
+#if defined(__AVX2__)
+    if (n >= 32) {
+        __m256i v = _mm256_loadu_si256((const __m256i*)tipos);
+        *largura = 32;
+        return (uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, _mm256_setzero_si256()));
+    }
+#elif defined(__SSE2__)
+    if (n >= 16) {
+        __m128i v = _mm_loadu_si128((const __m128i*)tipos);
+        *largura = 16;
+        return (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(v, _mm_setzero_si128()));
+    }
+#endif
+    *largura = n < 64 ? n : 64;
+    uint64_t mascara = 0;
+    for (size_t k = 0; k < *largura; k++) {
+        mascara |= (uint64_t)(tipos[k] == 0) << k;
+    }
+    return mascara;
+}
+
+/**
+ * Registra as secas (distâncias entre peças 'I') de um bloco
+ * @param analise Acumuladores da análise
+ * @param tipos Bloco de códigos de tipo
+ * @param n Número de peças no bloco
+ */
+static void contarSecas(Analise* analise, const unsigned char* tipos, size_t n) {
+    size_t i = 0;
+    while (i < n) {
+        size_t largura;
+        uint64_t mascara = mascaraPecasI(tipos + i, n - i, &largura);
+        while (mascara != 0) {
+            uint64_t posicao = analise->total + i + (uint64_t)__builtin_ctzll(mascara) + 1;
+            if (analise->posicaoUltimoI != 0) {
+                uint64_t seca = posicao - analise->posicaoUltimoI - 1;
+                analise->secas[seca < MAX_SECA ? seca : MAX_SECA]++;
+                if (seca > analise->maiorSeca) {
+                    analise->maiorSeca = seca;
+                }
+            }
+            analise->posicaoUltimoI = posicao;
+            mascara &= mascara - 1;
+        }
+        i += largura;
+    }
+}
+
+/**
+ * Conta os trigramas de um bloco, continuando os n-gramas do bloco anterior.
+ * Usa quatro tabelas parciais para evitar dependências entre incrementos seguidos.
+ * @param analise Acumuladores da análise
+ * @param tipos Bloco de códigos de tipo
+ * @param n Número de peças no bloco
+ */
+static void contarTrigramas(Analise* analise, const unsigned char* tipos, size_t n) {
+    uint32_t parciais[4][64];
+    unsigned int h = analise->historico;
+    uint64_t vistas = analise->total;
+    size_t i = 0;
+
+    memset(parciais, 0, sizeof(parciais));
+
+    // Primeiras peças: completa os trigramas iniciados no bloco anterior
+    for (; i < n && (vistas + i < 2 || i < 2); i++) {
+        h = ((h << 2) | tipos[i]) & 63;
+        if (vistas + i >= 2) {
+            parciais[0][h]++;
+        }
+    }
+    for (; i + 4 <= n; i += 4) {
+        parciais[0][((tipos[i - 2] << 4) | (tipos[i - 1] << 2) | tipos[i]) & 63]++;
+        parciais[1][((tipos[i - 1] << 4) | (tipos[i] << 2) | tipos[i + 1]) & 63]++;
+        parciais[2][((tipos[i] << 4) | (tipos[i + 1] << 2) | tipos[i + 2]) & 63]++;
+        parciais[3][((tipos[i + 1] << 4) | (tipos[i + 2] << 2) | tipos[i + 3]) & 63]++;
+    }
+    for (; i < n; i++) {
+        parciais[0][((tipos[i - 2] << 4) | (tipos[i - 1] << 2) | tipos[i]) & 63]++;
+    }
+
+    for (int c = 0; c < 64; c++) {
+        analise->trigramas[c] += (uint64_t)parciais[0][c] + parciais[1][c] + parciais[2][c] + parciais[3][c];
+    }
+
+    // Guarda as duas últimas peças para o próximo bloco
+    for (size_t k = n > 2 ? n - 2 : 0; k < n; k++) {
+        analise->ultimas[0] = analise->ultimas[1];
+        analise->ultimas[1] = tipos[k];
+    }
+    analise->historico = ((unsigned int)analise->ultimas[0] << 2 | analise->ultimas[1]) & 15;
+}
+
+/**
+ * Processa um bloco de peças em todos os acumuladores
+ * @param analise Acumuladores da análise
+ * @param tipos Bloco de códigos de tipo
+ * @param n Número de peças no bloco
+ */
+static void analisarBloco(Analise* analise, const unsigned char* tipos, size_t n) {
+    contarTipos(tipos, n, analise->frequencias);
+    contarSecas(analise, tipos, n);
+    contarTrigramas(analise, tipos, n);
+    analise->total += n;
+}
+
+// ============================================================================
+// FONTES DE PEÇAS
+// ============================================================================
+
+/**
+ * Converte um byte de arquivo de sequência em código de tipo
+ * @param valor Byte lido ('I','O','T','L' ou 0..3)
+ * @return Código 0..3, ou -1 se o byte deve ser ignorado (quebras de linha etc.)
+ */
+static int codigoDoByte(unsigned char valor) {
+    switch (valor) {
+        case 0: case 'I': return 0;
+        case 1: case 'O': return 1;
+        case 2: case 'T': return 2;
+        case 3: case 'L': return 3;
+        default: return -1;
+    }
+}
+
+/**
+ * Preenche o próximo bloco de peças da fonte
+ * @param fonte Fonte de peças
+ * @param tipos Bloco a preencher (TAMANHO_BLOCO posições)
+ * @return Número de peças lidas (0 ao fim da fonte)
+ */
+static size_t lerBloco(FontePecas* fonte, unsigned char* tipos) {
+    size_t n = 0;
+
+    if (fonte->sequencia.mapa != NULL) {
+        // Desempacota 4 peças por byte com uma tabela de 256 entradas
+        static uint32_t tabela[256];
+        if (tabela[255] == 0) {
+            for (int b = 0; b < 256; b++) {
+                tabela[b] = (uint32_t)(b & 3) | (uint32_t)((b >> 2) & 3) << 8 |
+                            (uint32_t)((b >> 4) & 3) << 16 | (uint32_t)((b >> 6) & 3) << 24;
+            }
+        }
+        uint64_t restantes = fonte->sequencia.numPecas - fonte->posicao;
+        n = restantes < TAMANHO_BLOCO ? (size_t)restantes : TAMANHO_BLOCO;
+        const unsigned char* origem = fonte->sequencia.dados + fonte->posicao / 4;
+        for (size_t k = 0; k < (n + 3) / 4; k++) {
+            memcpy(tipos + 4 * k, &tabela[origem[k]], 4);
+        }
+        fonte->posicao += n;
+        return n;
+    }
+
+    if (fonte->arquivo == NULL) {
+        // Gerador do jogo: mesmo sorteio de gerarPeca()
+        while (n < TAMANHO_BLOCO && fonte->restantes > 0) {
+            tipos[n++] = (unsigned char)(rand() % 4);
+            fonte->restantes--;
+        }
+        return n;
+    }
+
+    if (fonte->eventos) {
+        unsigned char quadros[4096 * EVENTOS_TAM_QUADRO];
+        while (n + 4096 <= TAMANHO_BLOCO) {
+            size_t lidos = fread(quadros, EVENTOS_TAM_QUADRO, 4096, fonte->arquivo);
+            for (size_t k = 0; k < lidos; k++) {
+                Evento evento;
+                decodificarEvento(quadros + k * EVENTOS_TAM_QUADRO, &evento);
+                int codigo = codigoDoByte((unsigned char)evento.nomeA);
+                if (evento.tipo == EVT_PECA_GERADA && codigo >= 0) {
+                    tipos[n++] = (unsigned char)codigo;
+                }
+            }
+            if (lidos < 4096) {
+                break;
+            }
+        }
+        return n;
+    }
+
+    size_t lidos = fread(tipos, 1, TAMANHO_BLOCO, fonte->arquivo);
+    for (size_t k = 0; k < lidos; k++) {
+        int codigo = codigoDoByte(tipos[k]);
+        if (codigo >= 0) {
+            tipos[n++] = (unsigned char)codigo;
+        }
+    }
+    return n;
+}
+
+// ============================================================================
+// ESTATÍSTICAS
+// ============================================================================
+
+/**
+ * Probabilidade de uma variável qui-quadrado com k graus de liberdade
+ * exceder x (aproximação de Wilson-Hilferty)
+ * @param x Estatística qui-quadrado
+ * @param k Graus de liberdade
+ * @return Valor-p aproximado
+ */
+static double valorP(double x, double k) {
+    if (x <= 0) {
+        return 1.0;
+    }
+    double z = (pow(x / k, 1.0 / 3.0) - (1.0 - 2.0 / (9.0 * k))) / sqrt(2.0 / (9.0 * k));
+    return 0.5 * erfc(z / sqrt(2.0));
+}
+
+/**
+ * Estatística psi-quadrado dos m-gramas sobrepostos (teste serial de Good)
+ * @param contagens Contagens observadas
+ * @param categorias Número de categorias (4^m)
+ * @param amostras Número de m-gramas observados
+ * @return Soma de (observado - esperado)^2 / esperado
+ */
+static double psiQuadrado(const uint64_t* contagens, int categorias, uint64_t amostras) {
+    double esperado = (double)amostras / categorias;
+    double soma = 0;
+    for (int c = 0; c < categorias; c++) {
+        double d = (double)contagens[c] - esperado;
+        soma += d * d / esperado;
+    }
+    return soma;
+}
+
+/**
+ * Exibe o relatório da análise
+ * @param analise Acumuladores da análise
+ */
+static void exibirRelatorio(const Analise* analise) {
+    uint64_t n = analise->total;
+
+    printf("=== ANALISE DA SEQUENCIA ===\n");
+    printf("Pecas analisadas: %llu\n", (unsigned long long)n);
+    if (n < 3) {
+        printf("Sequencia curta demais para analise.\n");
+        return;
+    }
+
+    printf("\nFrequencias:\n");
+    for (int t = 0; t < NUM_TIPOS; t++) {
+        printf("  %c: %llu (%.4f%%)\n", tiposPecas[t],
+               (unsigned long long)analise->frequencias[t], 100.0 * analise->frequencias[t] / n);
+    }
+
+    // Bigramas a partir dos trigramas, mais o último par da sequência
+    uint64_t bigramas[16];
+    for (int b = 0; b < 16; b++) {
+        bigramas[b] = 0;
+        for (int c = 0; c < NUM_TIPOS; c++) {
+            bigramas[b] += analise->trigramas[b * 4 + c];
+        }
+    }
+    bigramas[analise->ultimas[0] * 4 + analise->ultimas[1]]++;
+
+    printf("\nBigramas (linha = peca anterior):\n     ");
+    for (int t = 0; t < NUM_TIPOS; t++) {
+        printf("%14c", tiposPecas[t]);
+    }
+    printf("\n");
+    for (int a = 0; a < NUM_TIPOS; a++) {
+        printf("  %c: ", tiposPecas[a]);
+        for (int b = 0; b < NUM_TIPOS; b++) {
+            printf("%14llu", (unsigned long long)bigramas[a * 4 + b]);
+        }
+        printf("\n");
+    }
+
+    // Secas: esperado geométrico, P(seca = g) = (3/4)^g * 1/4
+    uint64_t numSecas = 0;
+    double somaSecas = 0;
+    for (int g = 0; g <= MAX_SECA; g++) {
+        numSecas += analise->secas[g];
+        somaSecas += (double)g * analise->secas[g];
+    }
+    printf("\nSecas de I: %llu (media %.3f, esperado 3.000; maior %llu)\n",
+           (unsigned long long)numSecas, numSecas ? somaSecas / numSecas : 0.0,
+           (unsigned long long)analise->maiorSeca);
+
+    // Qui-quadrado das frequências e teste serial (diferenças de psi-quadrado)
+    double psi1 = psiQuadrado(analise->frequencias, 4, n);
+    double psi2 = psiQuadrado(bigramas, 16, n - 1);
+    double psi3 = psiQuadrado(analise->trigramas, 64, n - 2);
+
+    double chiSecas = 0;
+    int baldesSecas = 0;
+    if (numSecas > 0) {
+        double probabilidade = 0.25, restante = 1.0;
+        for (int g = 0; g < MAX_SECA; g++) {
+            double esperado = numSecas * probabilidade;
+            if (esperado < 5) {
+                break;
+            }
+            double d = analise->secas[g] - esperado;
+            chiSecas += d * d / esperado;
+            restante -= probabilidade;
+            probabilidade *= 0.75;
+            baldesSecas++;
+        }
+        uint64_t cauda = 0;
+        for (int g = baldesSecas; g <= MAX_SECA; g++) {
+            cauda += analise->secas[g];
+        }
+        double esperado = numSecas * restante;
+        if (esperado > 0) {
+            chiSecas += (cauda - esperado) * (cauda - esperado) / esperado;
+        }
+    }
+
+    printf("\nTestes de uniformidade (valor-p aproximado):\n");
+    printf("  Frequencias      chi2 = %12.3f  gl = %2d  p = %.4f\n", psi1, 3, valorP(psi1, 3));
+    printf("  Serial (pares)   chi2 = %12.3f  gl = %2d  p = %.4f\n", psi2 - psi1, 12, valorP(psi2 - psi1, 12));
+    printf("  Serial (trincas) chi2 = %12.3f  gl = %2d  p = %.4f\n", psi3 - psi2, 48, valorP(psi3 - psi2, 48));
+    if (baldesSecas > 0) {
+        printf("  Secas            chi2 = %12.3f  gl = %2d  p = %.4f\n",
+               chiSecas, baldesSecas, valorP(chiSecas, baldesSecas));
+    }
+}
+
+// ============================================================================
+// PROGRAMA PRINCIPAL
+// ============================================================================
+
+/**
+ * Função principal do analisador
+ * Lê a fonte de peças em blocos e exibe o relatório ao final
+ */
+int main(int argc, char* argv[]) {
+    FontePecas fonte;
+    memset(&fonte, 0, sizeof(fonte));
+
+    if (argc == 4 && strcmp(argv[1], "--gerador") == 0) {
+        srand((unsigned int)strtoul(argv[2], NULL, 10));
+        fonte.restantes = strtoull(argv[3], NULL, 10);
+    } else if (argc == 3 && strcmp(argv[1], "--sequencia") == 0) {
+        if (!abrirSequencia(argv[2], &fonte.sequencia)) {
+            fprintf(stderr, "Erro: arquivo de sequencia invalido '%s'.\n", argv[2]);
+            return 1;
+        }
+    } else if (argc == 3 && (strcmp(argv[1], "--arquivo") == 0 || strcmp(argv[1], "--eventos") == 0)) {
+        fonte.arquivo = fopen(argv[2], "rb");
+        if (fonte.arquivo == NULL) {
+            fprintf(stderr, "Erro: nao foi possivel abrir '%s'.\n", argv[2]);
+            return 1;
+        }
+        if (strcmp(argv[1], "--eventos") == 0) {
+            unsigned char cabecalho[EVENTOS_TAM_CABECALHO];
+            if (fread(cabecalho, 1, sizeof(cabecalho), fonte.arquivo) != sizeof(cabecalho) ||
+                memcmp(cabecalho, EVENTOS_MAGICO, 4) != 0) {
+                fprintf(stderr, "Erro: '%s' nao e um fluxo de eventos binario.\n", argv[2]);
+                return 1;
+            }
+            fonte.eventos = 1;
+        }
+    } else {
+        fprintf(stderr, "Uso: %s --gerador SEMENTE N | --arquivo ARQ | --eventos ARQ | --sequencia ARQ\n",
+                argv[0]);
+        return 1;
+    }
+
+    static Analise analise;
+    unsigned char* tipos = malloc(TAMANHO_BLOCO + 4);
+    if (tipos == NULL) {
+        return 1;
+    }
+
+    size_t n;
+    while ((n = lerBloco(&fonte, tipos)) > 0) {
+        analisarBloco(&analise, tipos, n);
+    }
+
+    exibirRelatorio(&analise);
+
+    free(tipos);
+    if (fonte.arquivo != NULL) {
+        fclose(fonte.arquivo);
+    }
+    fecharSequencia(&fonte.sequencia);
+    return 0;
+}
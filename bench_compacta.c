@@ -0,0 +1,341 @@
+/*
+ * TETRIS STACK - BENCHMARK DA SESSÃO COMPACTA
+ *
+ * Aplica a mesma sequência de operações sorteadas a muitas sessões, cada
+ * operação em uma sessão sorteada, com dois layouts:
+ *   mestre:   FilaPecas + PilhaReserva + gerador, operadas pelas funções do
+ *             mestre.c (104 bytes por sessão, sem alinhamento)
+ *   compacta: SessaoCompacta de sessao_compacta.h (64 bytes alinhados)
+ * Mede o tempo, as linhas de cache ocupadas por sessão e, via
+ * perf_event_open, as falhas de cache L1d, de último nível e de TLB por
+ * operação. Ao final confere que os dois layouts terminaram com o mesmo
+ * estado em todas as sessões.
+ *
+ * Sem acesso aos contadores (ex.: perf_event_paranoid alto ou contêiner),
+ * mostra apenas os tempos e as linhas de cache.
+ *
+ * Uso: bench_compacta [SESSOES] [OPERACOES] [SEMENTE]
+ * Compilação: gcc -O2 bench_compacta.c -o bench_compacta
+ */
+
+#define MESTRE_SEM_MAIN
+#include "mestre.c"
+
+#include <linux/perf_event.h>
+#include <stdint.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+
+#include "sessao_compacta.h"
+
+// ============================================================================
+// LAYOUT DO MESTRE
+// ============================================================================
+
+/**
+ * Sessão no layout do mestre.c, com o mesmo gerador da sessão compacta
+ */
+typedef struct {
+    FilaPecas fila;
+    PilhaReserva pilha;
+    uint64_t rng;
+    uint32_t proximoId;
+} SessaoMestre;
+
+/**
+ * Gera a próxima peça da sessão (mesma sequência de enqueueCompacta)
+ */
+static inline Peca gerarPecaSessao(SessaoMestre* sessao) {
+    static const char tipos[4] = {'I', 'O', 'T', 'L'};
+    uint64_t x = sessao->rng;
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    sessao->rng = x;
+
+    Peca peca = { tipos[x >> 62], (int)sessao->proximoId++ };
+    return peca;
+}
+
+/**
+ * Inicializa a sessão como iniciarSessaoCompacta
+ */
+static void iniciarSessaoMestre(SessaoMestre* sessao, uint64_t semente, uint32_t primeiroId) {
+    sessao->rng = semente != 0 ? semente : 0x9E3779B97F4A7C15ULL;
+    sessao->proximoId = primeiroId;
+    sessao->fila.frente = 0;
+    sessao->fila.tras = 0;
+    sessao->fila.tamanho = 0;
+    sessao->fila.sujo = SUJO_TUDO;
+    inicializarPilha(&sessao->pilha);
+    for (int i = 0; i < CAPACIDADE_FILA; i++) {
+        enqueueFila(&sessao->fila, gerarPecaSessao(sessao));
+    }
+}
+
+// ============================================================================
+// CARGA
+// ============================================================================
+
+static inline uint64_t sortearCompacta(uint64_t* estado) {
+    uint64_t x = *estado;
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    return *estado = x;
+}
+
+// Operação sorteada: bits baixos escolhem a sessão, bits altos a operação e o k
+#define OPERACAO_SORTEADA(r)    ((int)(((r) >> 58) % 6))
+#define K_SORTEADO(r)           (1 + (int)(((r) >> 32) % CAPACIDADE_PILHA))
+
+/**
+ * Executa a carga no layout do mestre.c
+ * @return Operações bem-sucedidas
+ */
+static uint64_t cargaMestre(SessaoMestre* sessoes, size_t numSessoes, uint64_t operacoes, uint64_t semente) {
+    uint64_t rng = semente | 1;
+    uint64_t aplicadas = 0;
+    Peca peca;
+
+    for (uint64_t i = 0; i < operacoes; i++) {
+        uint64_t r = sortearCompacta(&rng);
+        SessaoMestre* sessao = &sessoes[(uint32_t)r % numSessoes];
+        switch (OPERACAO_SORTEADA(r)) {
+            case 0:
+                if (dequeueFila(&sessao->fila, &peca)) {
+                    enqueueFila(&sessao->fila, gerarPecaSessao(sessao));
+                    aplicadas++;
+                }
+                break;
+            case 1:
+                if (!pilhaCheia(&sessao->pilha) && dequeueFila(&sessao->fila, &peca)) {
+                    pushPilha(&sessao->pilha, peca);
+                    enqueueFila(&sessao->fila, gerarPecaSessao(sessao));
+                    aplicadas++;
+                }
+                break;
+            case 2:
+                aplicadas += (uint64_t)popPilha(&sessao->pilha, &peca);
+                break;
+            case 3:
+                aplicadas += (uint64_t)trocarSimples(&sessao->fila, &sessao->pilha);
+                break;
+            case 4:
+                aplicadas += (uint64_t)trocarMultipla(&sessao->fila, &sessao->pilha);
+                break;
+            default:
+                aplicadas += (uint64_t)trocarBloco(&sessao->fila, &sessao->pilha, K_SORTEADO(r));
+                break;
+        }
+    }
+    return aplicadas;
+}
+
+/**
+ * Executa a mesma carga no layout compacto
+ * @return Operações bem-sucedidas
+ */
+static uint64_t cargaCompacta(SessaoCompacta* sessoes, size_t numSessoes, uint64_t operacoes, uint64_t semente) {
+    uint64_t rng = semente | 1;
+    uint64_t aplicadas = 0;
+
+    for (uint64_t i = 0; i < operacoes; i++) {
+        uint64_t r = sortearCompacta(&rng);
+        SessaoCompacta* sessao = &sessoes[(uint32_t)r % numSessoes];
+        switch (OPERACAO_SORTEADA(r)) {
+            case 0:  aplicadas += (uint64_t)jogarCompacta(sessao); break;
+            case 1:  aplicadas += (uint64_t)reservarCompacta(sessao); break;
+            case 2:  aplicadas += (uint64_t)usarReservaCompacta(sessao); break;
+            case 3:  aplicadas += (uint64_t)trocarSimplesCompacta(sessao); break;
+            case 4:  aplicadas += (uint64_t)trocarMultiplaCompacta(sessao); break;
+            default: aplicadas += (uint64_t)trocarBlocoCompacta(sessao, K_SORTEADO(r)); break;
+        }
+    }
+    return aplicadas;
+}
+
+// ============================================================================
+// CONTADORES DE DESEMPENHO
+// ============================================================================
+
+#define CONTADOR_CACHE(cache, resultado) \
+    ((cache) | (PERF_COUNT_HW_CACHE_OP_READ << 8) | ((resultado) << 16))
+
+static const struct {
+    const char* nome;
+    uint32_t tipo;
+    uint64_t config;
+} contadores[] = {
+    { "L1d", PERF_TYPE_HW_CACHE, CONTADOR_CACHE(PERF_COUNT_HW_CACHE_L1D, PERF_COUNT_HW_CACHE_RESULT_MISS) },
+    { "LLC", PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES },
+    { "dTLB", PERF_TYPE_HW_CACHE, CONTADOR_CACHE(PERF_COUNT_HW_CACHE_DTLB, PERF_COUNT_HW_CACHE_RESULT_MISS) },
+};
+
+#define NUM_CONTADORES ((int)(sizeof(contadores) / sizeof(contadores[0])))
+
+/**
+ * Resultado de uma execução da carga
+ */
+typedef struct {
+    double segundos;
+    uint64_t aplicadas;
+    uint64_t falhas[NUM_CONTADORES];    // Leituras dos contadores
+    int disponivel[NUM_CONTADORES];     // 0 se o contador não pôde ser aberto
+} MedicaoCompacta;
+
+/**
+ * Abre um contador do processo atual, desabilitado, só em modo usuário
+ * @return Descritor do contador, ou -1 se indisponível
+ */
+static int abrirContador(uint32_t tipo, uint64_t config) {
+    struct perf_event_attr atributos;
+    memset(&atributos, 0, sizeof(atributos));
+    atributos.size = sizeof(atributos);
+    atributos.type = tipo;
+    atributos.config = config;
+    atributos.disabled = 1;
+    atributos.exclude_kernel = 1;
+    atributos.exclude_hv = 1;
+    return (int)syscall(SYS_perf_event_open, &atributos, 0, -1, -1, 0);
+}
+
+static double agoraSegundos(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+/**
+ * Executa uma das cargas entre a ativação e a leitura dos contadores
+ * @param compacta 1 para o layout compacto, 0 para o do mestre
+ */
+static void medirCarga(int compacta, void* sessoes, size_t numSessoes, uint64_t operacoes, uint64_t semente,
+                       MedicaoCompacta* medicao) {
+    int fds[NUM_CONTADORES];
+    for (int c = 0; c < NUM_CONTADORES; c++) {
+        fds[c] = abrirContador(contadores[c].tipo, contadores[c].config);
+        medicao->disponivel[c] = fds[c] >= 0;
+        medicao->falhas[c] = 0;
+        if (fds[c] >= 0) {
+            ioctl(fds[c], PERF_EVENT_IOC_RESET, 0);
+            ioctl(fds[c], PERF_EVENT_IOC_ENABLE, 0);
+        }
+    }
+
+    double inicio = agoraSegundos();
+    medicao->aplicadas = compacta ? cargaCompacta(sessoes, numSessoes, operacoes, semente)
+                                  : cargaMestre(sessoes, numSessoes, operacoes, semente);
+    medicao->segundos = agoraSegundos() - inicio;
+
+    for (int c = 0; c < NUM_CONTADORES; c++) {
+        if (fds[c] >= 0) {
+            ioctl(fds[c], PERF_EVENT_IOC_DISABLE, 0);
+            if (read(fds[c], &medicao->falhas[c], sizeof(uint64_t)) != sizeof(uint64_t)) {
+                medicao->disponivel[c] = 0;
+            }
+            close(fds[c]);
+        }
+    }
+}
+
+/**
+ * Média de linhas de cache ocupadas por sessão (independe dos contadores)
+ * @param sessoes Início do array de sessões
+ * @param bytesSessao Tamanho de cada sessão
+ * @param numSessoes Número de sessões
+ */
+static double linhasPorSessao(const void* sessoes, size_t bytesSessao, size_t numSessoes) {
+    uintptr_t inicio = (uintptr_t)sessoes;
+    uint64_t linhas = 0;
+    for (size_t i = 0; i < numSessoes; i++) {
+        uintptr_t primeiro = inicio + i * bytesSessao;
+        linhas += (primeiro + bytesSessao - 1) / 64 - primeiro / 64 + 1;
+    }
+    return (double)linhas / (double)numSessoes;
+}
+
+/**
+ * Imprime uma linha da tabela de resultados
+ */
+static void imprimirMedicao(const char* nome, size_t bytesSessao, double linhas, const MedicaoCompacta* medicao,
+                            uint64_t operacoes) {
+    printf("%-10s %6zu %7.2f %10.1f %8.2f", nome, bytesSessao, linhas, (double)operacoes / medicao->segundos / 1e6,
+           medicao->segundos * 1e9 / (double)operacoes);
+    for (int c = 0; c < NUM_CONTADORES; c++) {
+        if (medicao->disponivel[c]) {
+            printf(" %9.3f", (double)medicao->falhas[c] / (double)operacoes);
+        } else {
+            printf(" %9s", "n/d");
+        }
+    }
+    printf("\n");
+}
+
+// ============================================================================
+// PROGRAMA PRINCIPAL
+// ============================================================================
+
+int main(int argc, char* argv[]) {
+    size_t numSessoes = argc > 1 ? strtoull(argv[1], NULL, 10) : (1u << 20);
+    uint64_t operacoes = argc > 2 ? strtoull(argv[2], NULL, 10) : 20000000;
+    uint64_t semente = argc > 3 ? strtoull(argv[3], NULL, 10) : 1;
+    if (argc > 4 || numSessoes == 0 || numSessoes > UINT32_MAX || operacoes == 0) {
+        fprintf(stderr, "Uso: %s [SESSOES] [OPERACOES] [SEMENTE]\n", argv[0]);
+        return 1;
+    }
+
+    // As operações de troca não devem imprimir nada
+    modoSilencioso = 1;
+
+    SessaoMestre* mestre = malloc(sizeof(SessaoMestre) * numSessoes);
+    SessaoCompacta* compactas = aligned_alloc(64, sizeof(SessaoCompacta) * numSessoes);
+    if (mestre == NULL || compactas == NULL) {
+        fprintf(stderr, "Erro: memoria insuficiente.\n");
+        return 1;
+    }
+    for (size_t i = 0; i < numSessoes; i++) {
+        uint64_t sementeSessao = (semente + i) * 0x9E3779B97F4A7C15ULL;
+        iniciarSessaoMestre(&mestre[i], sementeSessao, (uint32_t)(i * 1000));
+        iniciarSessaoCompacta(&compactas[i], sementeSessao, (uint32_t)(i * 1000));
+    }
+
+    MedicaoCompacta medicaoMestre, medicaoCompacta;
+    medirCarga(0, mestre, numSessoes, operacoes, semente, &medicaoMestre);
+    medirCarga(1, compactas, numSessoes, operacoes, semente, &medicaoCompacta);
+
+    // Os dois layouts devem terminar com o mesmo estado em todas as sessões
+    size_t divergentes = 0;
+    for (size_t i = 0; i < numSessoes; i++) {
+        FilaPecas fila;
+        PilhaReserva pilha;
+        expandirSessao(&compactas[i], &fila, &pilha);
+        divergentes += checksumEstado(&fila, &pilha) != checksumEstado(&mestre[i].fila, &mestre[i].pilha) ||
+                       compactas[i].proximoId != mestre[i].proximoId;
+    }
+
+    printf("=== SESSAO COMPACTA ===\n");
+    printf("Sessoes: %zu  Operacoes: %llu (%llu aplicadas)  Semente: %llu\n", numSessoes,
+           (unsigned long long)operacoes, (unsigned long long)medicaoMestre.aplicadas,
+           (unsigned long long)semente);
+    printf("Memoria das sessoes: mestre %.1f MiB, compacta %.1f MiB\n\n",
+           (double)(sizeof(SessaoMestre) * numSessoes) / (1024.0 * 1024.0),
+           (double)(sizeof(SessaoCompacta) * numSessoes) / (1024.0 * 1024.0));
+    printf("%-10s %6s %7s %10s %8s", "layout", "bytes", "linhas", "M ops/s", "ns/op");
+    for (int c = 0; c < NUM_CONTADORES; c++) {
+        printf(" %9s", contadores[c].nome);
+    }
+    printf("   (falhas por operacao)\n");
+    imprimirMedicao("mestre", sizeof(SessaoMestre), linhasPorSessao(mestre, sizeof(SessaoMestre), numSessoes),
+                    &medicaoMestre, operacoes);
+    imprimirMedicao("compacta", sizeof(SessaoCompacta), linhasPorSessao(compactas, sizeof(SessaoCompacta), numSessoes),
+                    &medicaoCompacta, operacoes);
+    if (!medicaoMestre.disponivel[0]) {
+        printf("\nContadores indisponiveis (perf_event_open negado); veja /proc/sys/kernel/perf_event_paranoid.\n");
+    }
+    printf("\nSessoes com estado divergente: %zu\n", divergentes);
+
+    free(mestre);
+    free(compactas);
+    return divergentes != 0 || medicaoMestre.aplicadas != medicaoCompacta.aplicadas ? 2 : 0;
+}
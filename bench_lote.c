@@ -0,0 +1,214 @@
+/*
+ * TETRIS STACK - BENCHMARK DAS OPERAÇÕES EM LOTE
+ *
+ * Compara, para rodadas sincronizadas (todas as sessões recebem a mesma
+ * operação na mesma rodada):
+ * - laço escalar chamando as funções do mestre.c sessão por sessão
+ * - kernel de 64 bits do lote.h
+ * - kernel AVX2 do lote.h (quando compilado com suporte)
+ * e confere que os três terminam com os mesmos tipos de peça em todas as sessões.
+ *
+ * Uso: bench_lote [SESSOES] [RODADAS]
+ * Compilação: gcc -O2 -march=native bench_lote.c -o bench_lote
+ */
+
+#define MESTRE_SEM_MAIN
+#include "mestre.c"
+
+#include <stdint.h>
+
+#include "lote.h"
+
+// ============================================================================
+// DEFINIÇÕES E ESTRUTURAS
+// ============================================================================
+
+static const char* nomesOperacoesLote[LOTE_NUM_OPERACOES] = {
+    "jogar", "reservar", "usar_reserva", "troca_simples", "troca_multipla"
+};
+
+static const char nomesCodigos[5] = {'?', 'I', 'O', 'T', 'L'};
+
+/**
+ * Sessão no formato do mestre.c
+ */
+typedef struct {
+    FilaPecas fila;
+    PilhaReserva pilha;
+} SessaoMestre;
+
+// ============================================================================
+// FUNÇÕES AUXILIARES
+// ============================================================================
+
+/**
+ * Compacta uma sessão do mestre.c no formato do lote
+ * @param sessao Sessão no formato do mestre.c
+ * @return Sessão compactada (64 bits)
+ */
+static uint64_t compactarSessao(const SessaoMestre* sessao) {
+    uint64_t compactada = 0;
+    int indice = sessao->fila.frente;
+    for (int i = 0; i < sessao->fila.tamanho; i++) {
+        compactada |= (uint64_t)codigoLote(sessao->fila.pecas[indice].nome) << (8 * i);
+        indice = (indice + 1) % CAPACIDADE_FILA;
+    }
+    for (int j = 0; j <= sessao->pilha.topo; j++) {
+        compactada |= (uint64_t)codigoLote(sessao->pilha.pecas[sessao->pilha.topo - j].nome) << (8 * (5 + j));
+    }
+    return compactada;
+}
+
+/**
+ * Aplica uma operação a uma sessão usando as funções do mestre.c
+ * @param sessao Sessão no formato do mestre.c
+ * @param op Operação a aplicar
+ * @param nova Código da peça que entra na fila
+ * @return 1 se a operação foi aplicada, 0 caso contrário
+ */
+static int aplicarMestre(SessaoMestre* sessao, OperacaoLote op, uint8_t nova) {
+    Peca peca;
+    Peca novaPeca = { nomesCodigos[nova], 0 };
+
+    switch (op) {
+        case LOTE_JOGAR:
+            return dequeueFila(&sessao->fila, &peca) && enqueueFila(&sessao->fila, novaPeca);
+        case LOTE_RESERVAR:
+            if (pilhaCheia(&sessao->pilha) || !dequeueFila(&sessao->fila, &peca)) {
+                return 0;
+            }
+            pushPilha(&sessao->pilha, peca);
+            return enqueueFila(&sessao->fila, novaPeca);
+        case LOTE_USAR_RESERVA:
+            return popPilha(&sessao->pilha, &peca);
+        case LOTE_TROCA_SIMPLES:
+            return trocarSimples(&sessao->fila, &sessao->pilha);
+        case LOTE_TROCA_MULTIPLA:
+            return trocarMultipla(&sessao->fila, &sessao->pilha);
+        default:
+            return 0;
+    }
+}
+
+static double agoraSegundos(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// ============================================================================
+// PROGRAMA PRINCIPAL
+// ============================================================================
+
+int main(int argc, char* argv[]) {
+    size_t numSessoes = argc > 1 ? strtoul(argv[1], NULL, 10) : 1 << 16;
+    int rodadas = argc > 2 ? atoi(argv[2]) : 500;
+    if (numSessoes == 0 || rodadas <= 0) {
+        fprintf(stderr, "Uso: %s [SESSOES] [RODADAS]\n", argv[0]);
+        return 1;
+    }
+
+    modoSilencioso = 1;
+    srand(12345);
+
+    // Sequência de operações das rodadas e peças novas de cada rodada.
+    // Reservar e usar aparecem mais para a pilha variar de tamanho.
+    OperacaoLote* operacoes = malloc(sizeof(OperacaoLote) * (size_t)rodadas);
+    uint8_t* novas = malloc(numSessoes * (size_t)rodadas);
+    for (int r = 0; r < rodadas; r++) {
+        static const OperacaoLote sorteio[8] = {
+            LOTE_JOGAR, LOTE_RESERVAR, LOTE_RESERVAR, LOTE_USAR_RESERVA,
+            LOTE_USAR_RESERVA, LOTE_TROCA_SIMPLES, LOTE_TROCA_MULTIPLA, LOTE_TROCA_MULTIPLA
+        };
+        operacoes[r] = sorteio[rand() % 8];
+    }
+    for (size_t i = 0; i < numSessoes * (size_t)rodadas; i++) {
+        novas[i] = (uint8_t)(1 + rand() % 4);
+    }
+
+    // Estado inicial: fila cheia e pilha com 0 a 3 peças, igual nas três versões
+    SessaoMestre* mestre = malloc(sizeof(SessaoMestre) * numSessoes);
+    uint64_t* lote64 = malloc(sizeof(uint64_t) * numSessoes);
+    uint64_t* loteSimd = malloc(sizeof(uint64_t) * numSessoes);
+    uint8_t* resultados = malloc(numSessoes);
+    for (size_t i = 0; i < numSessoes; i++) {
+        inicializarFila(&mestre[i].fila);
+        inicializarPilha(&mestre[i].pilha);
+        for (int p = rand() % 4; p > 0; p--) {
+            pushPilha(&mestre[i].pilha, gerarPeca());
+        }
+        lote64[i] = loteSimd[i] = compactarSessao(&mestre[i]);
+    }
+
+    uint64_t aplicadas[3] = {0, 0, 0};
+    double tempos[3];
+
+    double inicio = agoraSegundos();
+    for (int r = 0; r < rodadas; r++) {
+        const uint8_t* novasRodada = novas + (size_t)r * numSessoes;
+        for (size_t i = 0; i < numSessoes; i++) {
+            aplicadas[0] += (uint64_t)aplicarMestre(&mestre[i], operacoes[r], novasRodada[i]);
+        }
+    }
+    tempos[0] = agoraSegundos() - inicio;
+
+    inicio = agoraSegundos();
+    for (int r = 0; r < rodadas; r++) {
+        aplicadas[1] += aplicarLoteEscalar(lote64, novas + (size_t)r * numSessoes, resultados,
+                                           numSessoes, operacoes[r]);
+    }
+    tempos[1] = agoraSegundos() - inicio;
+
+    inicio = agoraSegundos();
+    for (int r = 0; r < rodadas; r++) {
+        aplicadas[2] += aplicarLote(loteSimd, novas + (size_t)r * numSessoes, resultados,
+                                    numSessoes, operacoes[r]);
+    }
+    tempos[2] = agoraSegundos() - inicio;
+
+    // Conferência: mesmas peças em todas as sessões
+    size_t divergentes = 0;
+    for (size_t i = 0; i < numSessoes; i++) {
+        uint64_t referencia = compactarSessao(&mestre[i]);
+        if (referencia != lote64[i] || referencia != loteSimd[i]) {
+            divergentes++;
+        }
+    }
+
+    int contagemOps[LOTE_NUM_OPERACOES] = {0};
+    for (int r = 0; r < rodadas; r++) {
+        contagemOps[operacoes[r]]++;
+    }
+
+    printf("=== BENCHMARK DE OPERACOES EM LOTE ===\n");
+    printf("Sessoes: %zu  Rodadas: %d (", numSessoes, rodadas);
+    for (int op = 0; op < LOTE_NUM_OPERACOES; op++) {
+        printf("%s%s=%d", op > 0 ? " " : "", nomesOperacoesLote[op], contagemOps[op]);
+    }
+    printf(")\n\n");
+
+    const char* nomes[3] = {
+        "mestre.c (escalar)",
+        "lote 64 bits",
+#if defined(__AVX2__)
+        "lote AVX2"
+#else
+        "lote (sem AVX2)"
+#endif
+    };
+    double total = (double)numSessoes * rodadas;
+    for (int k = 0; k < 3; k++) {
+        printf("%-20s %8.3f ns/op  %8.2f Mops/s  aplicadas: %llu  (%.2fx)\n", nomes[k],
+               tempos[k] * 1e9 / total, total / tempos[k] / 1e6,
+               (unsigned long long)aplicadas[k], tempos[0] / tempos[k]);
+    }
+    printf("\nSessoes divergentes: %zu\n", divergentes);
+
+    free(operacoes);
+    free(novas);
+    free(mestre);
+    free(lote64);
+    free(loteSimd);
+    free(resultados);
+    return divergentes == 0 && aplicadas[0] == aplicadas[1] && aplicadas[1] == aplicadas[2] ? 0 : 1;
+}
@@ -0,0 +1,309 @@
+/*
+ * TETRIS STACK - BENCHMARK DO ALOCADOR DE SESSÕES
+ *
+ * Simula a rotatividade de um servidor que hospeda muitas sessões: cada
+ * thread mantém um conjunto de sessões vivas e, a cada ciclo, encerra uma
+ * sessão sorteada e cria outra no lugar (desconexão + conexão). Compara
+ * malloc/free com o alocador de alocador_sessoes.h.
+ *
+ * Uso: bench_sessoes [THREADS] [SESSOES_VIVAS] [CICLOS] [--hugepages]
+ * Compilação: gcc -O2 bench_sessoes.c -o bench_sessoes -lpthread
+ */
+
+#define MESTRE_SEM_MAIN
+#include "mestre.c"
+
+#include <pthread.h>
+#include <stdint.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+
+#include "alocador_sessoes.h"
+
+// ============================================================================
+// DEFINIÇÕES E ESTRUTURAS
+// ============================================================================
+
+/**
+ * Sessão hospedada: o estado de jogo de um jogador
+ */
+typedef struct {
+    FilaPecas fila;
+    PilhaReserva pilha;
+} Sessao;
+
+/**
+ * Parâmetros e resultado de cada thread do benchmark
+ */
+typedef struct {
+    ArenaSessoes* arena;    // NULL para usar malloc/free
+    size_t sessoesVivas;    // Sessões mantidas pela thread
+    size_t ciclos;          // Ciclos de desconexão + conexão
+    uint64_t semente;       // Semente do sorteio de sessões
+    uint64_t verificacao;   // Soma dos ids, para o compilador não descartar o trabalho
+    int falhou;             // 1 se alguma alocação falhou
+} TrabalhoSessoes;
+
+/**
+ * Resultado de uma rodada, medida em um processo filho
+ */
+typedef struct {
+    double segundos;        // Tempo das threads (negativo se alguma alocação falhou)
+    uint64_t verificacao;   // Soma de verificação das threads
+    long picoKiB;           // Pico de memória residente do filho
+    size_t slotsRecortados; // Slots da arena usados (0 para malloc)
+    size_t tamanhoSlot;     // Tamanho de cada slot da arena
+    int hugepages;          // 1 se a arena usou hugepages explícitas
+} ResultadoRodada;
+
+// ============================================================================
+// FUNÇÕES AUXILIARES
+// ============================================================================
+
+/**
+ * Gerador xorshift64 para sortear a sessão a encerrar
+ */
+static inline uint64_t sortear(uint64_t* estado) {
+    uint64_t x = *estado;
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    return *estado = x;
+}
+
+/**
+ * Inicializa uma sessão recém-alocada com a fila cheia
+ * (peças fixas via enqueueFila, sem passar pelo sorteio do mestre)
+ * @param sessao Sessão a inicializar
+ * @param id Id da primeira peça
+ */
+static void iniciarSessao(Sessao* sessao, int id) {
+    static const char tipos[4] = {'I', 'O', 'T', 'L'};
+    sessao->fila.frente = 0;
+    sessao->fila.tras = 0;
+    sessao->fila.tamanho = 0;
+    inicializarPilha(&sessao->pilha);
+    for (int i = 0; i < CAPACIDADE_FILA; i++) {
+        Peca peca = { tipos[(id + i) & 3], id + i };
+        enqueueFila(&sessao->fila, peca);
+    }
+}
+
+static inline Sessao* criarSessao(ArenaSessoes* arena) {
+    return arena != NULL ? alocarSessao(arena) : malloc(sizeof(Sessao));
+}
+
+static inline void encerrarSessao(ArenaSessoes* arena, Sessao* sessao) {
+    if (arena != NULL) {
+        liberarSessao(arena, sessao);
+    } else {
+        free(sessao);
+    }
+}
+
+/**
+ * Laço de cada thread: cria o conjunto inicial e depois gira as sessões
+ * @param argumento Ponteiro para TrabalhoSessoes
+ * @return NULL
+ */
+static void* threadSessoes(void* argumento) {
+    TrabalhoSessoes* trabalho = argumento;
+    Sessao** vivas = malloc(sizeof(Sessao*) * trabalho->sessoesVivas);
+    uint64_t estado = trabalho->semente | 1;
+    uint64_t verificacao = 0;
+    int proximo = 0;
+
+    for (size_t i = 0; i < trabalho->sessoesVivas; i++) {
+        vivas[i] = criarSessao(trabalho->arena);
+        if (vivas[i] == NULL) {
+            trabalho->falhou = 1;
+            trabalho->sessoesVivas = i;
+            break;
+        }
+        iniciarSessao(vivas[i], proximo);
+        proximo += CAPACIDADE_FILA;
+    }
+
+    for (size_t c = 0; c < trabalho->ciclos && !trabalho->falhou; c++) {
+        size_t indice = (size_t)(sortear(&estado) % trabalho->sessoesVivas);
+        verificacao += (uint64_t)vivas[indice]->fila.pecas[vivas[indice]->fila.frente].id;
+        encerrarSessao(trabalho->arena, vivas[indice]);
+
+        vivas[indice] = criarSessao(trabalho->arena);
+        if (vivas[indice] == NULL) {
+            trabalho->falhou = 1;
+            break;
+        }
+        iniciarSessao(vivas[indice], proximo);
+        proximo += CAPACIDADE_FILA;
+    }
+
+    for (size_t i = 0; i < trabalho->sessoesVivas; i++) {
+        if (vivas[i] != NULL) {
+            encerrarSessao(trabalho->arena, vivas[i]);
+        }
+    }
+    if (trabalho->arena != NULL) {
+        devolverCacheSessoes();
+    }
+    free(vivas);
+    trabalho->verificacao = verificacao;
+    return NULL;
+}
+
+static double agoraSegundos(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/**
+ * Executa uma rodada do benchmark com o alocador indicado
+ * @param arena Arena a usar (NULL para malloc/free)
+ * @param numThreads Número de threads
+ * @param sessoesVivas Sessões vivas por thread
+ * @param ciclos Ciclos por thread
+ * @param verificacao Retorna a soma de verificação das threads
+ * @return Tempo decorrido em segundos (negativo se alguma alocação falhou)
+ */
+static double executarRodada(ArenaSessoes* arena, int numThreads, size_t sessoesVivas, size_t ciclos,
+                             uint64_t* verificacao) {
+    pthread_t* threads = malloc(sizeof(pthread_t) * (size_t)numThreads);
+    TrabalhoSessoes* trabalhos = calloc((size_t)numThreads, sizeof(TrabalhoSessoes));
+    int falhou = 0;
+
+    double inicio = agoraSegundos();
+    for (int t = 0; t < numThreads; t++) {
+        trabalhos[t].arena = arena;
+        trabalhos[t].sessoesVivas = sessoesVivas;
+        trabalhos[t].ciclos = ciclos;
+        trabalhos[t].semente = 0x9E3779B97F4A7C15ULL * (uint64_t)(t + 1);
+        pthread_create(&threads[t], NULL, threadSessoes, &trabalhos[t]);
+    }
+    *verificacao = 0;
+    for (int t = 0; t < numThreads; t++) {
+        pthread_join(threads[t], NULL);
+        *verificacao += trabalhos[t].verificacao;
+        falhou |= trabalhos[t].falhou;
+    }
+    double segundos = agoraSegundos() - inicio;
+
+    free(threads);
+    free(trabalhos);
+    return falhou ? -1.0 : segundos;
+}
+
+/**
+ * Mede uma rodada em um processo filho, para que o pico de memória
+ * residente de cada alocador seja medido isoladamente
+ * @param usarArena 1 para o alocador de sessões, 0 para malloc/free
+ * @param usarHugepages 1 para tentar hugepages na arena
+ * @param numThreads Número de threads
+ * @param sessoesVivas Sessões vivas por thread
+ * @param ciclos Ciclos por thread
+ * @param resultado Resultado da rodada
+ * @return 1 se bem-sucedido, 0 caso contrário
+ */
+static int medirRodada(int usarArena, int usarHugepages, int numThreads, size_t sessoesVivas,
+                       size_t ciclos, ResultadoRodada* resultado) {
+    int canal[2];
+    if (pipe(canal) != 0) {
+        return 0;
+    }
+
+    pid_t filho = fork();
+    if (filho < 0) {
+        close(canal[0]);
+        close(canal[1]);
+        return 0;
+    }
+
+    if (filho == 0) {
+        ResultadoRodada medido;
+        memset(&medido, 0, sizeof(medido));
+        close(canal[0]);
+
+        if (usarArena) {
+            // Cada thread pode segurar até dois pentes além das sessões vivas
+            ArenaSessoes arena;
+            size_t maxSessoes = (size_t)numThreads * (sessoesVivas + 2 * SESSOES_POR_PENTE);
+            if (!criarArenaSessoes(&arena, sizeof(Sessao), maxSessoes, usarHugepages)) {
+                _exit(1);
+            }
+            medido.segundos = executarRodada(&arena, numThreads, sessoesVivas, ciclos, &medido.verificacao);
+            medido.slotsRecortados = arena.slotsRecortados;
+            medido.tamanhoSlot = arena.tamanhoSlot;
+            medido.hugepages = arena.hugepages;
+            destruirArenaSessoes(&arena);
+        } else {
+            medido.segundos = executarRodada(NULL, numThreads, sessoesVivas, ciclos, &medido.verificacao);
+        }
+
+        _exit(write(canal[1], &medido, sizeof(medido)) == (ssize_t)sizeof(medido) ? 0 : 1);
+    }
+
+    close(canal[1]);
+    ssize_t lidos = read(canal[0], resultado, sizeof(*resultado));
+    close(canal[0]);
+
+    int status;
+    struct rusage uso;
+    if (wait4(filho, &status, 0, &uso) != filho || !WIFEXITED(status) || WEXITSTATUS(status) != 0 ||
+        lidos != (ssize_t)sizeof(*resultado)) {
+        return 0;
+    }
+    resultado->picoKiB = uso.ru_maxrss;
+    return 1;
+}
+
+// ============================================================================
+// PROGRAMA PRINCIPAL
+// ============================================================================
+
+int main(int argc, char* argv[]) {
+    long valores[3] = {4, 100000, 10000000};
+    int numValores = 0;
+    int usarHugepages = 0;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--hugepages") == 0) {
+            usarHugepages = 1;
+        } else if (numValores < 3 && atol(argv[i]) > 0) {
+            valores[numValores++] = atol(argv[i]);
+        } else {
+            fprintf(stderr, "Uso: %s [THREADS] [SESSOES_VIVAS] [CICLOS] [--hugepages]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    int numThreads = (int)valores[0];
+    size_t sessoesVivas = (size_t)valores[1];
+    size_t ciclos = (size_t)valores[2];
+    modoSilencioso = 1;
+
+    printf("=== BENCHMARK DO ALOCADOR DE SESSOES ===\n");
+    printf("Threads: %d  Sessoes vivas por thread: %zu  Ciclos por thread: %zu  Sessao: %zu bytes\n\n",
+           numThreads, sessoesVivas, ciclos, sizeof(Sessao));
+
+    ResultadoRodada comMalloc, comArena;
+    if (!medirRodada(0, 0, numThreads, sessoesVivas, ciclos, &comMalloc) ||
+        !medirRodada(1, usarHugepages, numThreads, sessoesVivas, ciclos, &comArena)) {
+        fprintf(stderr, "Erro: nao foi possivel executar o benchmark.\n");
+        return 1;
+    }
+    if (comMalloc.segundos < 0 || comArena.segundos < 0) {
+        fprintf(stderr, "Erro: alocacao falhou durante o benchmark.\n");
+        return 1;
+    }
+
+    double total = (double)numThreads * (double)ciclos;
+    printf("%-16s %8.2f ns/ciclo  %8.2f Mciclos/s  pico RSS: %ld KiB\n", "malloc/free",
+           comMalloc.segundos * 1e9 / total, total / comMalloc.segundos / 1e6, comMalloc.picoKiB);
+    printf("%-16s %8.2f ns/ciclo  %8.2f Mciclos/s  pico RSS: %ld KiB  (%.2fx)\n",
+           comArena.hugepages ? "arena (hugetlb)" : "arena",
+           comArena.segundos * 1e9 / total, total / comArena.segundos / 1e6, comArena.picoKiB,
+           comMalloc.segundos / comArena.segundos);
+    printf("\nSlots recortados: %zu (%zu bytes cada)\n", comArena.slotsRecortados, comArena.tamanhoSlot);
+
+    return comMalloc.verificacao == comArena.verificacao ? 0 : 1;
+}
@@ -0,0 +1,394 @@
+/*
+ * TETRIS STACK - CARGA DE PONTA A PONTA
+ *
+ * Mede os executáveis reais (novato, aventureiro, mestre) como o usuário os
+ * usa: gera um roteiro grande de opções do menu (cada linha com a quebra de
+ * linha que o laço "Pressione Enter" consome), envia o roteiro pela entrada
+ * padrão de cada programa e descarta a saída em /dev/null ou em um pipe.
+ *
+ * Para cada programa informa operações por segundo, chamadas de sistema de
+ * leitura e escrita por operação (/proc/PID/io, lido com o processo ainda
+ * não coletado via waitid com WNOWAIT), bytes escritos, trocas de contexto,
+ * tempos de usuário e sistema e pico de memória residente (getrusage do
+ * filho). O roteiro depende só da semente e do número de operações, e cada
+ * medida é a mediana das repetições, para comparar compilações diferentes.
+ *
+ * Uso: carga [--ops N] [--semente S] [--repeticoes R] [--saida nulo|pipe]
+ *            [EXECUTAVEL...]
+ *      (padrão: ./novato ./aventureiro ./mestre; o nível de cada executável
+ *      é deduzido do nome, e nomes desconhecidos usam o menu do mestre)
+ * Compilação: gcc -O2 carga.c -o carga
+ */
+
+#define _GNU_SOURCE // pipe2
+
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/resource.h>
+#include <sys/time.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+// ============================================================================
+// DEFINIÇÕES E ESTRUTURAS
+// ============================================================================
+
+#define MAX_EXECUTAVEIS     16
+#define MAX_REPETICOES      64
+
+/**
+ * Roteiro de entrada de um executável
+ */
+typedef struct {
+    char* texto;
+    size_t tamanho;
+    uint64_t operacoes;     // Opções do menu no roteiro (sem contar o 0 final)
+} Roteiro;
+
+/**
+ * Medidas de uma execução
+ */
+typedef struct {
+    double segundos;
+    double usuario;             // Tempo de CPU em modo usuário (s)
+    double sistema;             // Tempo de CPU em modo núcleo (s)
+    uint64_t leituras;          // syscr de /proc/PID/io
+    uint64_t escritas;          // syscw de /proc/PID/io
+    uint64_t bytesEscritos;     // wchar de /proc/PID/io
+    uint64_t trocasVoluntarias;
+    uint64_t trocasInvoluntarias;
+    long picoRssKiB;
+    int temIo;                  // 0 se /proc/PID/io não pôde ser lido
+    int codigoSaida;
+} Medida;
+
+// ============================================================================
+// ROTEIROS
+// ============================================================================
+
+static uint64_t proximoAleatorio(uint64_t* estado) {
+    uint64_t z = (*estado += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+/**
+ * Deduz o nível do executável pelo nome (1 novato, 2 aventureiro, 3 mestre)
+ */
+static int nivelDoExecutavel(const char* caminho) {
+    const char* nome = strrchr(caminho, '/');
+    nome = nome != NULL ? nome + 1 : caminho;
+    if (strstr(nome, "novato") != NULL) {
+        return 1;
+    }
+    if (strstr(nome, "aventureiro") != NULL) {
+        return 2;
+    }
+    return 3;
+}
+
+/**
+ * Gera o roteiro de um nível: opções válidas sorteadas, uma por linha,
+ * terminando com 0 (sair). A opção 7 do mestre é seguida do k da troca.
+ * Proporções no mestre: jogar 40%, reservar 15%, usar 15%, troca simples 10%,
+ * troca múltipla 5%, troca de k 10%, exibir 5%.
+ * @param nivel Nível do executável
+ * @param operacoes Número de opções
+ * @param semente Semente do sorteio
+ * @param roteiro Recebe o roteiro
+ * @return 1 se bem-sucedido, 0 sem memória
+ */
+static int gerarRoteiro(int nivel, uint64_t operacoes, uint64_t semente, Roteiro* roteiro) {
+    size_t capacidade = (size_t)operacoes * 4 + 4;
+    char* texto = malloc(capacidade);
+    if (texto == NULL) {
+        return 0;
+    }
+    uint64_t estado = semente ^ ((uint64_t)nivel << 56);
+    size_t n = 0;
+
+    for (uint64_t i = 0; i < operacoes; i++) {
+        unsigned sorteio = (unsigned)(proximoAleatorio(&estado) % 100);
+        int opcao;
+        if (nivel == 1) {
+            opcao = sorteio < 50 ? 1 : 2;
+        } else if (nivel == 2) {
+            opcao = sorteio < 50 ? 1 : sorteio < 75 ? 2 : 3;
+        } else {
+            opcao = sorteio < 40 ? 1 : sorteio < 55 ? 2 : sorteio < 70 ? 3 : sorteio < 80 ? 4 :
+                    sorteio < 85 ? 5 : sorteio < 95 ? 7 : 6;
+        }
+        texto[n++] = (char)('0' + opcao);
+        texto[n++] = '\n';
+        if (opcao == 7) {
+            texto[n++] = (char)('1' + proximoAleatorio(&estado) % 3);
+            texto[n++] = '\n';
+        }
+    }
+    texto[n++] = '0';
+    texto[n++] = '\n';
+
+    roteiro->texto = texto;
+    roteiro->tamanho = n;
+    roteiro->operacoes = operacoes;
+    return 1;
+}
+
+// ============================================================================
+// EXECUÇÃO
+// ============================================================================
+
+static double agoraSegundos(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+/**
+ * Lê os contadores de chamadas de sistema de /proc/PID/io
+ * @return 1 se bem-sucedido, 0 caso contrário
+ */
+static int lerIoProcesso(pid_t pid, Medida* medida) {
+    char caminho[64];
+    snprintf(caminho, sizeof(caminho), "/proc/%d/io", (int)pid);
+    FILE* arquivo = fopen(caminho, "r");
+    if (arquivo == NULL) {
+        return 0;
+    }
+    char chave[32];
+    unsigned long long valor;
+    int lidos = 0;
+    while (fscanf(arquivo, "%31[^:]: %llu\n", chave, &valor) == 2) {
+        if (strcmp(chave, "syscr") == 0) {
+            medida->leituras = valor;
+            lidos++;
+        } else if (strcmp(chave, "syscw") == 0) {
+            medida->escritas = valor;
+            lidos++;
+        } else if (strcmp(chave, "wchar") == 0) {
+            medida->bytesEscritos = valor;
+            lidos++;
+        }
+    }
+    fclose(arquivo);
+    return lidos == 3;
+}
+
+/**
+ * Executa um programa com o roteiro na entrada padrão e mede a execução
+ * @param caminho Executável
+ * @param roteiro Roteiro a enviar
+ * @param saidaPipe 1 para ler a saída por um pipe, 0 para /dev/null
+ * @param medida Recebe as medidas
+ * @return 1 se o programa executou, 0 em erro
+ */
+static int executarRoteiro(const char* caminho, const Roteiro* roteiro, int saidaPipe, Medida* medida) {
+    int entrada[2], saida[2] = { -1, -1 };
+    if (pipe2(entrada, O_CLOEXEC) != 0 || (saidaPipe && pipe2(saida, O_CLOEXEC) != 0)) {
+        return 0;
+    }
+
+    double inicio = agoraSegundos();
+    pid_t pid = fork();
+    if (pid < 0) {
+        return 0;
+    }
+    if (pid == 0) {
+        int nulo = saidaPipe ? saida[1] : open("/dev/null", O_WRONLY);
+        if (nulo < 0 || dup2(entrada[0], STDIN_FILENO) < 0 || dup2(nulo, STDOUT_FILENO) < 0) {
+            _exit(127);
+        }
+        execl(caminho, caminho, (char*)NULL);
+        _exit(127);
+    }
+    close(entrada[0]);
+    if (saidaPipe) {
+        close(saida[1]);
+    }
+
+    // Envia o roteiro e, com pipe, drena a saída ao mesmo tempo
+    fcntl(entrada[1], F_SETFL, O_NONBLOCK);
+    size_t enviado = 0;
+    int abertos = 1 + saidaPipe;
+    char descarte[1 << 16];
+    while (abertos > 0) {
+        struct pollfd fds[2];
+        int nfds = 0, indiceEntrada = -1, indiceSaida = -1;
+        if (entrada[1] >= 0) {
+            fds[nfds] = (struct pollfd){ entrada[1], POLLOUT, 0 };
+            indiceEntrada = nfds++;
+        }
+        if (saidaPipe && saida[0] >= 0) {
+            fds[nfds] = (struct pollfd){ saida[0], POLLIN, 0 };
+            indiceSaida = nfds++;
+        }
+        if (poll(fds, (nfds_t)nfds, -1) < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            break;
+        }
+        if (indiceEntrada >= 0 && fds[indiceEntrada].revents != 0) {
+            ssize_t n = write(entrada[1], roteiro->texto + enviado, roteiro->tamanho - enviado);
+            if (n > 0) {
+                enviado += (size_t)n;
+            }
+            if (enviado == roteiro->tamanho || (n < 0 && errno != EAGAIN)) {
+                close(entrada[1]);
+                entrada[1] = -1;
+                abertos--;
+            }
+        }
+        if (indiceSaida >= 0 && fds[indiceSaida].revents != 0) {
+            if (read(saida[0], descarte, sizeof(descarte)) <= 0) {
+                close(saida[0]);
+                saida[0] = -1;
+                abertos--;
+            }
+        }
+    }
+
+    // Espera o término sem coletar o processo, para ainda ler /proc/PID/io
+    siginfo_t info;
+    memset(&info, 0, sizeof(info));
+    while (waitid(P_PID, (id_t)pid, &info, WEXITED | WNOWAIT) != 0 && errno == EINTR) {
+    }
+    medida->segundos = agoraSegundos() - inicio;
+    medida->temIo = lerIoProcesso(pid, medida);
+
+    int status;
+    struct rusage uso;
+    while (wait4(pid, &status, 0, &uso) < 0 && errno == EINTR) {
+    }
+    medida->usuario = (double)uso.ru_utime.tv_sec + (double)uso.ru_utime.tv_usec * 1e-6;
+    medida->sistema = (double)uso.ru_stime.tv_sec + (double)uso.ru_stime.tv_usec * 1e-6;
+    medida->trocasVoluntarias = (uint64_t)uso.ru_nvcsw;
+    medida->trocasInvoluntarias = (uint64_t)uso.ru_nivcsw;
+    medida->picoRssKiB = uso.ru_maxrss;
+    medida->codigoSaida = WIFEXITED(status) ? WEXITSTATUS(status) : 128 + WTERMSIG(status);
+    return medida->codigoSaida != 127;
+}
+
+// ============================================================================
+// RELATÓRIO
+// ============================================================================
+
+static int compararMedidaPorTempo(const void* a, const void* b) {
+    double x = ((const Medida*)a)->segundos, y = ((const Medida*)b)->segundos;
+    return (x > y) - (x < y);
+}
+
+/**
+ * Mede um executável: gera o roteiro do seu nível, executa as repetições e
+ * imprime a linha da mediana (por tempo)
+ * @return 1 se todas as execuções terminaram com código 0
+ */
+static int medirExecutavel(const char* caminho, uint64_t operacoes, uint64_t semente,
+                           int repeticoes, int saidaPipe) {
+    Roteiro roteiro;
+    if (!gerarRoteiro(nivelDoExecutavel(caminho), operacoes, semente, &roteiro)) {
+        fprintf(stderr, "Erro: memoria insuficiente para o roteiro.\n");
+        return 0;
+    }
+
+    Medida medidas[MAX_REPETICOES];
+    for (int r = 0; r < repeticoes; r++) {
+        if (!executarRoteiro(caminho, &roteiro, saidaPipe, &medidas[r])) {
+            fprintf(stderr, "Erro: nao foi possivel executar '%s'.\n", caminho);
+            free(roteiro.texto);
+            return 0;
+        }
+        if (medidas[r].codigoSaida != 0) {
+            fprintf(stderr, "Aviso: '%s' terminou com codigo %d.\n", caminho, medidas[r].codigoSaida);
+        }
+    }
+    qsort(medidas, (size_t)repeticoes, sizeof(Medida), compararMedidaPorTempo);
+    const Medida* m = &medidas[repeticoes / 2];
+    double ops = (double)roteiro.operacoes;
+
+    printf("%-24s %12.0f", caminho, ops / m->segundos);
+    if (m->temIo) {
+        printf(" %8.3f %8.3f %10.1f", (double)m->leituras / ops, (double)m->escritas / ops,
+               (double)m->bytesEscritos / ops);
+    } else {
+        printf(" %8s %8s %10s", "-", "-", "-");
+    }
+    printf(" %8.3f %8.3f %8.3f %10ld\n", (double)(m->trocasVoluntarias + m->trocasInvoluntarias) / ops,
+           m->usuario, m->sistema, m->picoRssKiB);
+
+    free(roteiro.texto);
+    return m->codigoSaida == 0;
+}
+
+// ============================================================================
+// PROGRAMA PRINCIPAL
+// ============================================================================
+
+int main(int argc, char* argv[]) {
+    const char* executaveis[MAX_EXECUTAVEIS];
+    int numExecutaveis = 0;
+    uint64_t operacoes = 200000;
+    uint64_t semente = 1;
+    int repeticoes = 5;
+    int saidaPipe = 0;
+
+    for (int i = 1; i < argc; i++) {
+        if (i + 1 < argc && strcmp(argv[i], "--ops") == 0) {
+            operacoes = strtoull(argv[++i], NULL, 10);
+        } else if (i + 1 < argc && strcmp(argv[i], "--semente") == 0) {
+            semente = strtoull(argv[++i], NULL, 10);
+        } else if (i + 1 < argc && strcmp(argv[i], "--repeticoes") == 0) {
+            repeticoes = atoi(argv[++i]);
+        } else if (i + 1 < argc && strcmp(argv[i], "--saida") == 0) {
+            i++;
+            if (strcmp(argv[i], "pipe") == 0) {
+                saidaPipe = 1;
+            } else if (strcmp(argv[i], "nulo") == 0) {
+                saidaPipe = 0;
+            } else {
+                numExecutaveis = -1;
+                break;
+            }
+        } else if (argv[i][0] != '-' && numExecutaveis < MAX_EXECUTAVEIS) {
+            executaveis[numExecutaveis++] = argv[i];
+        } else {
+            numExecutaveis = -1;
+            break;
+        }
+    }
+    if (numExecutaveis < 0 || operacoes == 0 || repeticoes < 1 || repeticoes > MAX_REPETICOES) {
+        fprintf(stderr, "Uso: %s [--ops N] [--semente S] [--repeticoes R (1 a %d)] [--saida nulo|pipe]\n"
+                        "          [EXECUTAVEL...]\n", argv[0], MAX_REPETICOES);
+        return 1;
+    }
+    if (numExecutaveis == 0) {
+        executaveis[numExecutaveis++] = "./novato";
+        executaveis[numExecutaveis++] = "./aventureiro";
+        executaveis[numExecutaveis++] = "./mestre";
+    }
+
+    // Sem SIGPIPE se um programa terminar antes de ler todo o roteiro
+    signal(SIGPIPE, SIG_IGN);
+
+    printf("=== CARGA DE PONTA A PONTA ===\n");
+    printf("Operacoes: %llu  Semente: %llu  Repeticoes: %d (mediana)  Saida: %s\n\n",
+           (unsigned long long)operacoes, (unsigned long long)semente, repeticoes,
+           saidaPipe ? "pipe" : "/dev/null");
+    printf("%-24s %12s %8s %8s %10s %8s %8s %8s %10s\n", "executavel", "ops/s", "leit/op",
+           "escr/op", "bytes/op", "ctx/op", "usr(s)", "sys(s)", "pico(KiB)");
+
+    int todosOk = 1;
+    for (int e = 0; e < numExecutaveis; e++) {
+        todosOk &= medirExecutavel(executaveis[e], operacoes, semente, repeticoes, saidaPipe);
+    }
+    return todosOk ? 0 : 2;
+}
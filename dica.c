@@ -0,0 +1,217 @@
+/*
+ * TETRIS STACK - ANALISADOR DE JOGADAS
+ *
+ * Mostra o valor esperado de cada ação para uma fila, uma reserva e uma
+ * demanda (regras de partida.h, busca em dica.h), ou mede o tempo de
+ * resposta em posições sorteadas.
+ *
+ * Uso: dica FILA RESERVA DEMANDA [opções]
+ *        FILA     tipos da frente para o final (ex.: IOTLI)
+ *        RESERVA  tipos do topo para a base (ex.: TL), ou - se vazia
+ *        DEMANDA  tipo pedido no turno (ex.: O)
+ *      dica --bench N [opções]
+ * Opções: --acoes N (ações restantes no turno), --vidas N, --orcamento MS,
+ *         --profundidade N, --distribuicao pI,pO,pT,pL
+ * Compilação: gcc -O2 dica.c -o dica
+ */
+
+#define MESTRE_SEM_MAIN
+#include "mestre.c"
+
+#include <stdint.h>
+
+#include "partida.h"
+#include "dica.h"
+
+static const char* nomesAcoes[NUM_ACOES] = {
+    "jogar", "reservar", "usar_reserva", "troca_simples", "troca_multipla"
+};
+
+/**
+ * Converte uma sequência de tipos em códigos
+ * @param texto Tipos ('I', 'O', 'T', 'L')
+ * @param codigos Recebe os códigos
+ * @param maximo Número máximo de peças
+ * @return Número de peças, ou -1 se o texto é inválido
+ */
+static int lerTipos(const char* texto, uint8_t* codigos, int maximo) {
+    int n = 0;
+    if (strcmp(texto, "-") == 0) {
+        return 0;
+    }
+    for (; texto[n] != '\0'; n++) {
+        if (n == maximo || strchr("IOTL", texto[n]) == NULL) {
+            return -1;
+        }
+        codigos[n] = codigoDica(texto[n]);
+    }
+    return n;
+}
+
+static int compararDouble(const void* a, const void* b) {
+    double x = *(const double*)a, y = *(const double*)b;
+    return (x > y) - (x < y);
+}
+
+/**
+ * Mede consultas em posições sorteadas, com a tabela reaproveitada entre
+ * elas (como em uma sequência de dicas durante uma partida)
+ */
+static int executarBench(ContextoDica* contexto, int consultas, double orcamentoMs, int profundidadeMax, int vidas) {
+    double* tempos = malloc(sizeof(double) * (size_t)consultas);
+    uint64_t rng = 0x2545F4914F6CDD1DULL;
+    long somaProfundidade = 0;
+    int profundidadeMinima = PROFUNDIDADE_MAX_DICA;
+    uint64_t nos = 0;
+
+    for (int c = 0; c < consultas; c++) {
+        EstadoDica estado;
+        rng = misturar64(rng);
+        for (int i = 0; i < CAPACIDADE_FILA; i++) {
+            estado.fila[i] = (uint8_t)((rng >> (2 * i)) & 3);
+        }
+        estado.tamanhoPilha = (int8_t)((rng >> 20) % (CAPACIDADE_PILHA + 1));
+        for (int i = 0; i < CAPACIDADE_PILHA; i++) {
+            estado.pilha[i] = (uint8_t)((rng >> (24 + 2 * i)) & 3);
+        }
+        estado.demanda = (uint8_t)((rng >> 40) & 3);
+        estado.acoesRestantes = PARTIDA_ACOES_POR_TURNO;
+        estado.vidas = (uint8_t)vidas;
+
+        ResultadoDica resultado;
+        consultarDica(contexto, &estado, orcamentoMs, profundidadeMax, &resultado);
+        tempos[c] = resultado.milissegundos;
+        somaProfundidade += resultado.profundidade;
+        if (resultado.profundidade < profundidadeMinima) {
+            profundidadeMinima = resultado.profundidade;
+        }
+        nos += resultado.nos;
+    }
+
+    qsort(tempos, (size_t)consultas, sizeof(double), compararDouble);
+    printf("=== BENCHMARK DA DICA ===\n");
+    printf("Consultas: %d  Orcamento: %.2f ms  Profundidade maxima: %d\n", consultas, orcamentoMs,
+           profundidadeMax > 0 ? profundidadeMax : PROFUNDIDADE_MAX_DICA);
+    printf("Tempo: mediana %.3f ms  p99 %.3f ms  max %.3f ms\n", tempos[consultas / 2],
+           tempos[(int)(consultas * 0.99)], tempos[consultas - 1]);
+    printf("Profundidade alcancada: media %.1f  minima %d\n",
+           (double)somaProfundidade / consultas, profundidadeMinima);
+    printf("Nos por consulta: %.0f\n", (double)nos / consultas);
+    free(tempos);
+    return 0;
+}
+
+// ============================================================================
+// PROGRAMA PRINCIPAL
+// ============================================================================
+
+int main(int argc, char* argv[]) {
+    const char* posicionais[3];
+    int numPosicionais = 0;
+    int acoes = PARTIDA_ACOES_POR_TURNO;
+    int vidas = PARTIDA_VIDAS;
+    int profundidadeMax = 0;
+    int consultasBench = 0;
+    double orcamentoMs = 5.0;
+    double probabilidades[4] = {0.25, 0.25, 0.25, 0.25};
+    int usarDistribuicao = 0;
+
+    for (int i = 1; i < argc; i++) {
+        if (i + 1 < argc && strcmp(argv[i], "--acoes") == 0) {
+            acoes = atoi(argv[++i]);
+        } else if (i + 1 < argc && strcmp(argv[i], "--vidas") == 0) {
+            vidas = atoi(argv[++i]);
+        } else if (i + 1 < argc && strcmp(argv[i], "--orcamento") == 0) {
+            orcamentoMs = atof(argv[++i]);
+        } else if (i + 1 < argc && strcmp(argv[i], "--profundidade") == 0) {
+            profundidadeMax = atoi(argv[++i]);
+        } else if (i + 1 < argc && strcmp(argv[i], "--bench") == 0) {
+            consultasBench = atoi(argv[++i]);
+        } else if (i + 1 < argc && strcmp(argv[i], "--distribuicao") == 0) {
+            double soma = 0;
+            if (sscanf(argv[++i], "%lf,%lf,%lf,%lf", &probabilidades[0], &probabilidades[1],
+                       &probabilidades[2], &probabilidades[3]) != 4) {
+                fprintf(stderr, "Erro: distribuicao deve ter 4 valores (I,O,T,L).\n");
+                return 1;
+            }
+            for (int t = 0; t < 4; t++) {
+                soma += probabilidades[t];
+            }
+            for (int t = 0; t < 4; t++) {
+                probabilidades[t] /= soma;
+            }
+            usarDistribuicao = 1;
+        } else if (argv[i][0] != '-' || strcmp(argv[i], "-") == 0) {
+            if (numPosicionais == 3) {
+                numPosicionais = -1;
+                break;
+            }
+            posicionais[numPosicionais++] = argv[i];
+        } else {
+            numPosicionais = -1;
+            break;
+        }
+    }
+
+    if ((consultasBench <= 0 && numPosicionais != 3) || numPosicionais < 0 ||
+        acoes < 1 || acoes > PARTIDA_ACOES_POR_TURNO || vidas < 1 || vidas > 63 || orcamentoMs <= 0) {
+        fprintf(stderr, "Uso: %s FILA RESERVA DEMANDA [--acoes N] [--vidas N] [--orcamento MS]\n"
+                        "          [--profundidade N] [--distribuicao pI,pO,pT,pL]\n"
+                        "       %s --bench N [--orcamento MS] [--profundidade N]\n", argv[0], argv[0]);
+        return 1;
+    }
+
+    ContextoDica contexto;
+    if (!criarContextoDica(&contexto)) {
+        fprintf(stderr, "Erro: memoria insuficiente para a tabela de transposicao.\n");
+        return 1;
+    }
+    if (usarDistribuicao) {
+        definirDistribuicaoDica(&contexto, probabilidades);
+    }
+
+    if (consultasBench > 0) {
+        int codigo = executarBench(&contexto, consultasBench, orcamentoMs, profundidadeMax, vidas);
+        destruirContextoDica(&contexto);
+        return codigo;
+    }
+
+    // Estado informado: fila completa, reserva do topo para a base
+    EstadoDica estado;
+    uint8_t reserva[CAPACIDADE_PILHA];
+    uint8_t demanda;
+    int tamanhoFila = lerTipos(posicionais[0], estado.fila, CAPACIDADE_FILA);
+    int tamanhoPilha = lerTipos(posicionais[1], reserva, CAPACIDADE_PILHA);
+    if (tamanhoFila != CAPACIDADE_FILA || tamanhoPilha < 0 || lerTipos(posicionais[2], &demanda, 1) != 1) {
+        fprintf(stderr, "Erro: a fila deve ter %d pecas, a reserva ate %d e a demanda 1 (tipos I, O, T, L).\n",
+                CAPACIDADE_FILA, CAPACIDADE_PILHA);
+        destruirContextoDica(&contexto);
+        return 1;
+    }
+    estado.tamanhoPilha = (int8_t)tamanhoPilha;
+    for (int i = 0; i < tamanhoPilha; i++) {
+        estado.pilha[i] = reserva[tamanhoPilha - 1 - i];
+    }
+    estado.demanda = demanda;
+    estado.acoesRestantes = (uint8_t)acoes;
+    estado.vidas = (uint8_t)vidas;
+
+    ResultadoDica resultado;
+    consultarDica(&contexto, &estado, orcamentoMs, profundidadeMax, &resultado);
+
+    printf("Fila: %s  Reserva (topo -> base): %s  Demanda: %s  Acoes: %d  Vidas: %d\n\n",
+           posicionais[0], posicionais[1], posicionais[2], acoes, vidas);
+    for (int acao = 0; acao < NUM_ACOES; acao++) {
+        if (resultado.validas[acao]) {
+            printf("  %-16s %8.4f%s\n", nomesAcoes[acao], resultado.valores[acao],
+                   acao == (int)resultado.melhor ? "  <- melhor" : "");
+        } else {
+            printf("  %-16s %8s\n", nomesAcoes[acao], "-");
+        }
+    }
+    printf("\nProfundidade: %d acoes  Nos: %llu  Tempo: %.3f ms\n", resultado.profundidade,
+           (unsigned long long)resultado.nos, resultado.milissegundos);
+
+    destruirContextoDica(&contexto);
+    return 0;
+}
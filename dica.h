@@ -0,0 +1,434 @@
+/*
+ * TETRIS STACK - DICA DE JOGADA (EXPECTIMAX)
+ *
+ * Calcula o valor esperado de cada ação do turno nas regras de partida.h,
+ * considerando que a peça gerada por enqueueAutomatico (após jogar ou
+ * reservar) e a demanda do próximo turno são sorteadas com uma distribuição
+ * conhecida (uniforme por padrão, como rand() % 4 no mestre.c).
+ *
+ * - nós de decisão: melhor ação válida (máximo)
+ * - nós de acaso: média ponderada sobre os 4 tipos de peça / de demanda
+ * - valor = pontos esperados dentro do horizonte + VALOR_VIDA_DICA por vida
+ *   restante nas folhas
+ *
+ * O estado é compactado em 64 bits (2 bits por peça) e os valores das
+ * subárvores ficam em uma tabela de transposição de tamanho fixo. Antes de
+ * consultar a tabela, peças longe demais para serem colocadas dentro da
+ * profundidade restante são zeradas e, com a distribuição uniforme (tipos
+ * intercambiáveis), os tipos são renomeados para uma forma canônica; assim
+ * muito mais estados compartilham a mesma entrada. A busca usa
+ * aprofundamento iterativo: cada profundidade completa substitui a anterior,
+ * até esgotar o orçamento de tempo da consulta.
+ *
+ * Deve ser incluído depois de partida.h.
+ */
+
+#ifndef DICA_H
+#define DICA_H
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define VALOR_VIDA_DICA        1.0      // Valor de uma vida restante nas folhas
+#define PROFUNDIDADE_MAX_DICA  32       // Limite do aprofundamento iterativo (em ações)
+#define BITS_TABELA_DICA       18       // Tabela de transposição com 2^18 entradas
+#define NOS_POR_CONSULTA_RELOGIO 4096   // Frequência da verificação do orçamento
+
+_Static_assert(2 * (CAPACIDADE_FILA + CAPACIDADE_PILHA) + 26 <= 63,
+               "o estado compactado da dica precisa caber em 64 bits");
+
+/**
+ * Estado visto pela busca: só os tipos das peças importam
+ */
+typedef struct {
+    uint8_t fila[CAPACIDADE_FILA];      // Códigos 0..3, da frente para o final
+    uint8_t pilha[CAPACIDADE_PILHA];    // Códigos 0..3, da base para o topo
+    int8_t tamanhoPilha;
+    uint8_t demanda;                    // Código do tipo pedido no turno
+    uint8_t acoesRestantes;             // Ações que ainda cabem no turno
+    uint8_t vidas;
+} EstadoDica;
+
+/**
+ * Entrada da tabela de transposição
+ */
+typedef struct {
+    uint64_t chave;     // Estado + profundidade (0 = entrada vazia)
+    double valor;
+} EntradaDica;
+
+/**
+ * Contexto de busca (tabela, distribuição das peças e controle de tempo)
+ */
+typedef struct {
+    EntradaDica* tabela;
+    double probabilidades[4];           // Distribuição dos tipos gerados e pedidos
+    int simetrico;                      // 1 se a distribuição é uniforme
+    uint64_t nos;                       // Nós visitados na consulta
+    struct timespec limite;             // Instante em que a consulta deve parar
+    int esgotado;                       // 1 se o orçamento acabou no meio de uma profundidade
+} ContextoDica;
+
+/**
+ * Resultado de uma consulta
+ */
+typedef struct {
+    double valores[NUM_ACOES];          // Valor esperado de cada ação
+    int validas[NUM_ACOES];             // 1 se a ação é válida no estado
+    AcaoPartida melhor;
+    int profundidade;                   // Última profundidade completa (em ações)
+    uint64_t nos;
+    double milissegundos;
+} ResultadoDica;
+
+// ============================================================================
+// CONTEXTO E ESTADO
+// ============================================================================
+
+/**
+ * Cria o contexto da busca com distribuição uniforme
+ * @param contexto Contexto a inicializar
+ * @return 1 se bem-sucedido, 0 se faltou memória
+ */
+static inline int criarContextoDica(ContextoDica* contexto) {
+    contexto->tabela = malloc(sizeof(EntradaDica) << BITS_TABELA_DICA);
+    if (contexto->tabela == NULL) {
+        return 0;
+    }
+    // Zera já (e não com calloc) para que a primeira consulta não pague as faltas de página
+    memset(contexto->tabela, 0, sizeof(EntradaDica) << BITS_TABELA_DICA);
+    for (int t = 0; t < 4; t++) {
+        contexto->probabilidades[t] = 0.25;
+    }
+    contexto->simetrico = 1;
+    contexto->nos = 0;
+    contexto->esgotado = 0;
+    return 1;
+}
+
+/**
+ * Troca a distribuição dos tipos sorteados (invalida os valores memorizados)
+ * @param contexto Contexto da busca
+ * @param probabilidades Probabilidade de cada tipo ('I', 'O', 'T', 'L'), somando 1
+ */
+static inline void definirDistribuicaoDica(ContextoDica* contexto, const double probabilidades[4]) {
+    memcpy(contexto->probabilidades, probabilidades, sizeof(contexto->probabilidades));
+    contexto->simetrico = probabilidades[0] == probabilidades[1] && probabilidades[1] == probabilidades[2] &&
+                          probabilidades[2] == probabilidades[3];
+    memset(contexto->tabela, 0, sizeof(EntradaDica) << BITS_TABELA_DICA);
+}
+
+static inline void destruirContextoDica(ContextoDica* contexto) {
+    free(contexto->tabela);
+    contexto->tabela = NULL;
+}
+
+/**
+ * Código 0..3 de um tipo de peça ('I', 'O', 'T', 'L')
+ */
+static inline uint8_t codigoDica(char nome) {
+    for (int t = 0; t < 4; t++) {
+        if (tiposPartida[t] == nome) {
+            return (uint8_t)t;
+        }
+    }
+    return 0;
+}
+
+/**
+ * Extrai o estado da busca de uma partida
+ * @param partida Partida em andamento
+ * @param demanda Tipo pedido no turno
+ * @param acoesRestantes Ações que ainda cabem no turno
+ * @param estado Estado compacto
+ */
+static inline void estadoDaPartida(const Partida* partida, char demanda, int acoesRestantes, EstadoDica* estado) {
+    for (int i = 0; i < CAPACIDADE_FILA; i++) {
+        estado->fila[i] = codigoDica(tipoNaFila(partida, i));
+    }
+    estado->tamanhoPilha = (int8_t)(partida->pilha.topo + 1);
+    for (int i = 0; i < estado->tamanhoPilha; i++) {
+        estado->pilha[i] = codigoDica(partida->pilha.pecas[i].nome);
+    }
+    estado->demanda = codigoDica(demanda);
+    estado->acoesRestantes = (uint8_t)acoesRestantes;
+    estado->vidas = (uint8_t)partida->vidas;
+}
+
+/**
+ * Reduz o estado ao que ainda pode influenciar o valor com a profundidade
+ * restante, para que mais estados compartilhem a mesma chave:
+ * - uma peça na posição i da fila (ou i a partir do topo da pilha) precisa
+ *   de pelo menos i + 1 ações para ser colocada; com profundidade <= i ela é
+ *   irrelevante e vira 0 (as transições nunca a trazem para perto mais
+ *   rápido do que a profundidade diminui)
+ * - com a distribuição uniforme, as peças relevantes são renomeadas na
+ *   ordem em que aparecem (demanda, fila, pilha)
+ * @param estado Estado a reduzir (alterado)
+ * @param profundidade Profundidade restante
+ * @param canonizar 1 para renomear os tipos
+ */
+static inline void reduzirEstadoDica(EstadoDica* estado, int profundidade, int canonizar) {
+    int8_t nomes[4] = {-1, -1, -1, -1};
+    int8_t proximo = 0;
+    int basePilha = estado->tamanhoPilha - profundidade;  // Abaixo disso, irrelevante
+
+    #define RENOMEAR(codigo) \
+        do { \
+            if (canonizar) { \
+                if (nomes[codigo] < 0) { \
+                    nomes[codigo] = proximo++; \
+                } \
+                (codigo) = (uint8_t)nomes[codigo]; \
+            } \
+        } while (0)
+
+    RENOMEAR(estado->demanda);
+    for (int i = 0; i < CAPACIDADE_FILA; i++) {
+        if (i < profundidade) {
+            RENOMEAR(estado->fila[i]);
+        } else {
+            estado->fila[i] = 0;
+        }
+    }
+    for (int i = estado->tamanhoPilha - 1; i >= 0; i--) {
+        if (i >= basePilha) {
+            RENOMEAR(estado->pilha[i]);
+        } else {
+            estado->pilha[i] = 0;
+        }
+    }
+
+    #undef RENOMEAR
+}
+
+/**
+ * Compacta o estado e a profundidade restante em uma chave de 64 bits
+ */
+static inline uint64_t chaveDica(const EstadoDica* estado, int profundidade) {
+    uint64_t chave = 0;
+    for (int i = 0; i < CAPACIDADE_FILA; i++) {
+        chave = (chave << 2) | estado->fila[i];
+    }
+    for (int i = 0; i < CAPACIDADE_PILHA; i++) {
+        chave = (chave << 2) | (i < estado->tamanhoPilha ? estado->pilha[i] : 0);
+    }
+    chave = (chave << 4) | (uint64_t)estado->tamanhoPilha;
+    chave = (chave << 2) | estado->demanda;
+    chave = (chave << 2) | estado->acoesRestantes;
+    chave = (chave << 6) | estado->vidas;
+    chave = (chave << 6) | (uint64_t)profundidade;
+    return chave | 1ULL << 63;  // Nunca zero (zero marca entrada vazia)
+}
+
+// ============================================================================
+// BUSCA
+// ============================================================================
+
+static double valorDecisaoDica(ContextoDica* contexto, const EstadoDica* estado, int profundidade);
+
+/**
+ * Verifica o orçamento de tempo a cada NOS_POR_CONSULTA_RELOGIO nós
+ */
+static inline int orcamentoEsgotadoDica(ContextoDica* contexto) {
+    if (contexto->esgotado) {
+        return 1;
+    }
+    if (++contexto->nos % NOS_POR_CONSULTA_RELOGIO == 0) {
+        struct timespec agora;
+        clock_gettime(CLOCK_MONOTONIC, &agora);
+        if (agora.tv_sec > contexto->limite.tv_sec ||
+            (agora.tv_sec == contexto->limite.tv_sec && agora.tv_nsec >= contexto->limite.tv_nsec)) {
+            contexto->esgotado = 1;
+        }
+    }
+    return contexto->esgotado;
+}
+
+/**
+ * Início de um novo turno: média sobre a demanda sorteada
+ */
+static double valorNovoTurnoDica(ContextoDica* contexto, const EstadoDica* estado, int profundidade) {
+    EstadoDica proximo = *estado;
+    double valor = 0;
+    proximo.acoesRestantes = PARTIDA_ACOES_POR_TURNO;
+    for (int t = 0; t < 4; t++) {
+        proximo.demanda = (uint8_t)t;
+        valor += contexto->probabilidades[t] * valorDecisaoDica(contexto, &proximo, profundidade);
+    }
+    return valor;
+}
+
+/**
+ * Remove a frente da fila e sorteia a peça que entra no final
+ * (enqueueAutomatico); continua no mesmo turno ou em um novo
+ */
+static double valorPecaGeradaDica(ContextoDica* contexto, const EstadoDica* estado, int profundidade, int novoTurno) {
+    EstadoDica proximo = *estado;
+    double valor = 0;
+    memmove(proximo.fila, proximo.fila + 1, CAPACIDADE_FILA - 1);
+    for (int t = 0; t < 4; t++) {
+        proximo.fila[CAPACIDADE_FILA - 1] = (uint8_t)t;
+        valor += contexto->probabilidades[t] *
+                 (novoTurno ? valorNovoTurnoDica(contexto, &proximo, profundidade)
+                            : valorDecisaoDica(contexto, &proximo, profundidade));
+    }
+    return valor;
+}
+
+/**
+ * Valor esperado de aplicar uma ação
+ * @return Valor, ou -1 se a ação não é válida no estado
+ */
+static double valorAcaoDica(ContextoDica* contexto, const EstadoDica* estado, AcaoPartida acao, int profundidade) {
+    EstadoDica proximo = *estado;
+    int coloca = acao == ACAO_JOGAR || acao == ACAO_USAR_RESERVA;
+    if (!coloca && estado->acoesRestantes <= 1) {
+        return -1; // A última ação do turno precisa colocar uma peça
+    }
+    proximo.acoesRestantes--;
+
+    switch (acao) {
+        case ACAO_JOGAR: {
+            double ganho = estado->fila[0] == estado->demanda;
+            proximo.vidas -= !ganho;
+            return ganho + valorPecaGeradaDica(contexto, &proximo, profundidade - 1, 1);
+        }
+        case ACAO_RESERVAR:
+            if (estado->tamanhoPilha == CAPACIDADE_PILHA) {
+                return -1;
+            }
+            proximo.pilha[proximo.tamanhoPilha++] = estado->fila[0];
+            return valorPecaGeradaDica(contexto, &proximo, profundidade - 1, 0);
+
+        case ACAO_USAR_RESERVA: {
+            if (estado->tamanhoPilha == 0) {
+                return -1;
+            }
+            double ganho = estado->pilha[--proximo.tamanhoPilha] == estado->demanda;
+            proximo.vidas -= !ganho;
+            return ganho + valorNovoTurnoDica(contexto, &proximo, profundidade - 1);
+        }
+        case ACAO_TROCA_SIMPLES:
+            if (estado->tamanhoPilha == 0) {
+                return -1;
+            }
+            proximo.fila[0] = estado->pilha[estado->tamanhoPilha - 1];
+            proximo.pilha[estado->tamanhoPilha - 1] = estado->fila[0];
+            return valorDecisaoDica(contexto, &proximo, profundidade - 1);
+
+        case ACAO_TROCA_MULTIPLA:
+            if (estado->tamanhoPilha != CAPACIDADE_PILHA) {
+                return -1;
+            }
+            // Mesma permutação de trocarMultipla: fila[i] <-> pilha[topo - i]
+            for (int i = 0; i < CAPACIDADE_PILHA; i++) {
+                proximo.fila[i] = estado->pilha[CAPACIDADE_PILHA - 1 - i];
+                proximo.pilha[CAPACIDADE_PILHA - 1 - i] = estado->fila[i];
+            }
+            return valorDecisaoDica(contexto, &proximo, profundidade - 1);
+
+        default:
+            return -1;
+    }
+}
+
+/**
+ * Nó de decisão: melhor ação válida, com memorização por estado
+ */
+static double valorDecisaoDica(ContextoDica* contexto, const EstadoDica* estado, int profundidade) {
+    if (profundidade <= 0 || estado->vidas == 0) {
+        return VALOR_VIDA_DICA * estado->vidas;
+    }
+    if (orcamentoEsgotadoDica(contexto)) {
+        return 0; // Resultado descartado pelo aprofundamento iterativo
+    }
+
+    // Vidas acima da profundidade só somam um valor fixo nas folhas
+    int limiteVidas = profundidade + 1;
+    double excedente = 0;
+    EstadoDica normalizado = *estado;
+    if (estado->vidas > limiteVidas) {
+        excedente = VALOR_VIDA_DICA * (estado->vidas - limiteVidas);
+        normalizado.vidas = (uint8_t)limiteVidas;
+    }
+
+    reduzirEstadoDica(&normalizado, profundidade, contexto->simetrico);
+    uint64_t chave = chaveDica(&normalizado, profundidade);
+    EntradaDica* entrada = &contexto->tabela[(chave * 0x9E3779B97F4A7C15ULL) >> (64 - BITS_TABELA_DICA)];
+    if (entrada->chave == chave) {
+        return entrada->valor + excedente;
+    }
+
+    double melhor = -1;
+    for (int acao = 0; acao < NUM_ACOES; acao++) {
+        double valor = valorAcaoDica(contexto, &normalizado, (AcaoPartida)acao, profundidade);
+        if (valor > melhor) {
+            melhor = valor;
+        }
+    }
+    if (melhor < 0) {
+        // Nenhuma ação válida (não ocorre com a fila cheia): joga a frente
+        melhor = valorAcaoDica(contexto, &normalizado, ACAO_JOGAR, profundidade);
+    }
+
+    if (!contexto->esgotado) {
+        entrada->chave = chave;
+        entrada->valor = melhor;
+    }
+    return melhor + excedente;
+}
+
+/**
+ * Avalia todas as ações do estado com aprofundamento iterativo
+ * @param contexto Contexto de busca (a tabela é reaproveitada entre consultas)
+ * @param estado Estado atual
+ * @param orcamentoMs Tempo máximo da consulta em milissegundos
+ * @param profundidadeMax Profundidade máxima (em ações); 0 para PROFUNDIDADE_MAX_DICA
+ * @param resultado Valores de cada ação, melhor ação e profundidade alcançada
+ */
+static inline void consultarDica(ContextoDica* contexto, const EstadoDica* estado, double orcamentoMs,
+                                 int profundidadeMax, ResultadoDica* resultado) {
+    struct timespec inicio;
+    clock_gettime(CLOCK_MONOTONIC, &inicio);
+    long long limiteNs = (long long)inicio.tv_nsec + (long long)(orcamentoMs * 1e6);
+    contexto->limite.tv_sec = inicio.tv_sec + (time_t)(limiteNs / 1000000000LL);
+    contexto->limite.tv_nsec = (long)(limiteNs % 1000000000LL);
+    contexto->esgotado = 0;
+    contexto->nos = 0;
+
+    if (profundidadeMax <= 0 || profundidadeMax > PROFUNDIDADE_MAX_DICA) {
+        profundidadeMax = PROFUNDIDADE_MAX_DICA;
+    }
+
+    memset(resultado, 0, sizeof(*resultado));
+    resultado->melhor = ACAO_JOGAR;
+    for (int profundidade = 1; profundidade <= profundidadeMax; profundidade++) {
+        double valores[NUM_ACOES];
+        for (int acao = 0; acao < NUM_ACOES; acao++) {
+            valores[acao] = valorAcaoDica(contexto, estado, (AcaoPartida)acao, profundidade);
+        }
+        if (contexto->esgotado) {
+            break; // Profundidade incompleta: fica a anterior
+        }
+
+        resultado->profundidade = profundidade;
+        resultado->melhor = ACAO_JOGAR;
+        for (int acao = 0; acao < NUM_ACOES; acao++) {
+            resultado->valores[acao] = valores[acao];
+            resultado->validas[acao] = valores[acao] >= 0;
+            if (valores[acao] > valores[resultado->melhor]) {
+                resultado->melhor = (AcaoPartida)acao;
+            }
+        }
+    }
+
+    struct timespec fim;
+    clock_gettime(CLOCK_MONOTONIC, &fim);
+    resultado->nos = contexto->nos;
+    resultado->milissegundos = (fim.tv_sec - inicio.tv_sec) * 1e3 + (fim.tv_nsec - inicio.tv_nsec) / 1e6;
+}
+
+#endif // DICA_H
@@ -0,0 +1,329 @@
+/*
+ * TETRIS STACK - DUELOS EM LOCKSTEP
+ *
+ * Joga partidas multijogador (regras em multijogador.h) entre robôs, sem
+ * interface, e mede quantas partidas por segundo o núcleo lockstep simula.
+ * Em seguida repete as partidas com uma réplica que recebe os mesmos lotes
+ * de entradas e compara o hash de cada tick, como um servidor compararia os
+ * hashes informados pelos clientes.
+ *
+ * Com --dessincronizar T, a réplica é corrompida no tick T de cada partida
+ * (uma linha de lixo a mais para o jogador 0), para conferir que a
+ * divergência é detectada no próprio tick. O código de saída é 2 se alguma
+ * conferência falhar (divergência sem corrupção, ou corrupção não detectada
+ * no tick T).
+ *
+ * Por fim confere a simetria das regras: com o mesmo robô determinístico em
+ * todos os assentos, todos os jogadores devem ter o mesmo estado a cada tick,
+ * seja qual for o assento.
+ *
+ * Uso: duelo [PARTIDAS] [JOGADORES] [SEMENTE] [--dessincronizar T]
+ * Compilação: gcc -O2 duelo.c -o duelo
+ */
+
+#define MESTRE_SEM_MAIN
+#include "mestre.c"
+
+#include <stdint.h>
+
+#include "partida.h"
+#include "multijogador.h"
+
+// ============================================================================
+// ROBÔS
+// ============================================================================
+
+static inline uint64_t sortearDuelo(uint64_t* estado) {
+    uint64_t x = *estado;
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    return *estado = x;
+}
+
+/**
+ * Joga a frente ou usa o topo da reserva, o que servir; se nenhum servir,
+ * guarda a frente na reserva enquanto houver espaço e ações no turno
+ */
+static AcaoPartida roboGuloso(const Partida* partida, char demanda, int acoesRestantes, uint64_t* rng) {
+    (void)rng;
+    if (tipoNaFila(partida, 0) == demanda) {
+        return ACAO_JOGAR;
+    }
+    if (tipoNaPilha(partida, 0) == demanda) {
+        return ACAO_USAR_RESERVA;
+    }
+    if (acoesRestantes > 1 && !pilhaCheia((PilhaReserva*)&partida->pilha)) {
+        return ACAO_RESERVAR;
+    }
+    return ACAO_JOGAR;
+}
+
+/**
+ * Ação sorteada (inclui ações inválidas, que apenas gastam o tick)
+ */
+static AcaoPartida roboAleatorio(const Partida* partida, char demanda, int acoesRestantes, uint64_t* rng) {
+    (void)partida; (void)demanda; (void)acoesRestantes;
+    return (AcaoPartida)(sortearDuelo(rng) % NUM_ACOES);
+}
+
+/**
+ * Sempre joga a frente da fila
+ */
+static AcaoPartida roboSempreJogar(const Partida* partida, char demanda, int acoesRestantes, uint64_t* rng) {
+    (void)partida; (void)demanda; (void)acoesRestantes; (void)rng;
+    return ACAO_JOGAR;
+}
+
+static const struct {
+    const char* nome;
+    PoliticaPartida decidir;
+} robos[] = {
+    { "guloso", roboGuloso },
+    { "aleatorio", roboAleatorio },
+    { "sempre_jogar", roboSempreJogar },
+};
+
+#define NUM_ROBOS ((int)(sizeof(robos) / sizeof(robos[0])))
+
+// ============================================================================
+// PARTIDAS
+// ============================================================================
+
+/**
+ * Resultado de um duelo
+ */
+typedef struct {
+    uint64_t hashFinal;
+    uint32_t ticks;
+    int vencedor;               // Assento do vencedor (-1 se nenhum)
+    int64_t tickDivergente;     // Primeiro tick com hash diferente na réplica (-1 se nenhum)
+} ResultadoDuelo;
+
+/**
+ * Robô do assento j na partida m (os robôs giram entre os assentos)
+ */
+static int roboDoAssento(uint64_t m, int j) {
+    return (int)((m + (uint64_t)j) % NUM_ROBOS);
+}
+
+/**
+ * Joga uma partida até o fim. Cada tick reúne as entradas de todos os
+ * robôs em um lote e o aplica à partida (e à réplica, se houver).
+ * @param semente Semente da partida
+ * @param m Índice da partida (define os assentos dos robôs)
+ * @param numJogadores Jogadores na partida
+ * @param comReplica 1 para conferir os hashes com uma réplica
+ * @param tickCorrompido Tick em que a réplica é corrompida (-1 para nunca)
+ * @param resultado Recebe o resultado
+ */
+static void jogarDuelo(uint64_t semente, uint64_t m, int numJogadores, int comReplica,
+                       int64_t tickCorrompido, ResultadoDuelo* resultado) {
+    PartidaMulti multi, replica;
+    uint64_t rngs[MULTI_MAX_JOGADORES];
+    LoteTick lote;
+
+    iniciarPartidaMulti(&multi, numJogadores, semente);
+    if (comReplica) {
+        iniciarPartidaMulti(&replica, numJogadores, semente);
+    }
+    for (int j = 0; j < numJogadores; j++) {
+        rngs[j] = misturar64(semente ^ ((uint64_t)j << 48)) | 1;
+    }
+    resultado->tickDivergente = -1;
+
+    while (!partidaMultiTerminou(&multi)) {
+        lote.tick = multi.tick;
+        for (int j = 0; j < numJogadores; j++) {
+            const JogadorMulti* jogador = &multi.jogadores[j];
+            lote.acoes[j] = MULTI_ESPERAR;
+            if (jogador->ativo) {
+                lote.acoes[j] = (uint8_t)robos[roboDoAssento(m, j)].decidir(
+                    &jogador->partida, demandaJogadorMulti(&multi, j),
+                    PARTIDA_ACOES_POR_TURNO - jogador->acoesNoTurno, &rngs[j]);
+            }
+        }
+
+        uint64_t hash = avancarTickMulti(&multi, &lote);
+        if (comReplica) {
+            if ((int64_t)lote.tick == tickCorrompido) {
+                replica.jogadores[0].lixoPendente++;
+            }
+            if (avancarTickMulti(&replica, &lote) != hash && resultado->tickDivergente < 0) {
+                resultado->tickDivergente = lote.tick;
+            }
+        }
+    }
+
+    resultado->hashFinal = multi.hash;
+    resultado->ticks = multi.tick;
+    resultado->vencedor = vencedorPartidaMulti(&multi);
+}
+
+/**
+ * Joga uma partida com o mesmo robô (determinístico) em todos os assentos e
+ * confere, a cada tick, que vidas, pontos, sequência e lixo são iguais para
+ * todos os jogadores
+ * @param semente Semente da partida
+ * @param numJogadores Jogadores na partida
+ * @param robo Índice do robô em robos
+ * @return Primeiro tick assimétrico, ou -1 se a partida foi simétrica
+ */
+static int64_t conferirSimetriaDuelo(uint64_t semente, int numJogadores, int robo) {
+    PartidaMulti multi;
+    LoteTick lote;
+    uint64_t rng = 1;
+
+    iniciarPartidaMulti(&multi, numJogadores, semente);
+    while (!partidaMultiTerminou(&multi)) {
+        lote.tick = multi.tick;
+        for (int j = 0; j < numJogadores; j++) {
+            const JogadorMulti* jogador = &multi.jogadores[j];
+            lote.acoes[j] = MULTI_ESPERAR;
+            if (jogador->ativo) {
+                lote.acoes[j] = (uint8_t)robos[robo].decidir(
+                    &jogador->partida, demandaJogadorMulti(&multi, j),
+                    PARTIDA_ACOES_POR_TURNO - jogador->acoesNoTurno, &rng);
+            }
+        }
+        avancarTickMulti(&multi, &lote);
+
+        const JogadorMulti* primeiro = &multi.jogadores[0];
+        for (int j = 1; j < numJogadores; j++) {
+            const JogadorMulti* jogador = &multi.jogadores[j];
+            if (jogador->partida.vidas != primeiro->partida.vidas ||
+                jogador->partida.pontos != primeiro->partida.pontos ||
+                jogador->sequencia != primeiro->sequencia || jogador->ativo != primeiro->ativo ||
+                jogador->lixoPendente != primeiro->lixoPendente ||
+                jogador->lixoEnviado != primeiro->lixoEnviado) {
+                return lote.tick;
+            }
+        }
+    }
+    return -1;
+}
+
+static double agoraSegundos(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+// ============================================================================
+// PROGRAMA PRINCIPAL
+// ============================================================================
+
+int main(int argc, char* argv[]) {
+    const char* posicionais[3];
+    int numPosicionais = 0;
+    int64_t tickCorrompido = -1;
+
+    for (int i = 1; i < argc; i++) {
+        if (i + 1 < argc && strcmp(argv[i], "--dessincronizar") == 0) {
+            tickCorrompido = strtoll(argv[++i], NULL, 10);
+        } else if (argv[i][0] != '-' && numPosicionais < 3) {
+            posicionais[numPosicionais++] = argv[i];
+        } else {
+            numPosicionais = -1;
+            break;
+        }
+    }
+    uint64_t partidas = numPosicionais >= 1 ? strtoull(posicionais[0], NULL, 10) : 20000;
+    int numJogadores = numPosicionais >= 2 ? atoi(posicionais[1]) : 2;
+    uint64_t sementeInicial = numPosicionais >= 3 ? strtoull(posicionais[2], NULL, 10) : 1;
+    if (numPosicionais < 0 || partidas == 0 || numJogadores < 2 || numJogadores > MULTI_MAX_JOGADORES) {
+        fprintf(stderr, "Uso: %s [PARTIDAS] [JOGADORES (2 a %d)] [SEMENTE] [--dessincronizar T]\n",
+                argv[0], MULTI_MAX_JOGADORES);
+        return 1;
+    }
+
+    // As operações de troca não devem imprimir nada
+    modoSilencioso = 1;
+
+    ResultadoDuelo* resultados = malloc(sizeof(ResultadoDuelo) * (size_t)partidas);
+    if (resultados == NULL) {
+        fprintf(stderr, "Erro: memoria insuficiente.\n");
+        return 1;
+    }
+
+    // Vazão: só o núcleo lockstep e os robôs
+    uint64_t vitorias[NUM_ROBOS] = {0};
+    uint64_t participacoes[NUM_ROBOS] = {0};
+    uint64_t ticksTotais = 0, empates = 0;
+    double inicio = agoraSegundos();
+    for (uint64_t m = 0; m < partidas; m++) {
+        jogarDuelo(misturar64(sementeInicial + m), m, numJogadores, 0, -1, &resultados[m]);
+    }
+    double segundos = agoraSegundos() - inicio;
+    for (uint64_t m = 0; m < partidas; m++) {
+        ticksTotais += resultados[m].ticks;
+        for (int j = 0; j < numJogadores; j++) {
+            participacoes[roboDoAssento(m, j)]++;
+        }
+        if (resultados[m].vencedor >= 0) {
+            vitorias[roboDoAssento(m, resultados[m].vencedor)]++;
+        } else {
+            empates++;
+        }
+    }
+
+    printf("=== DUELOS EM LOCKSTEP ===\n");
+    printf("Partidas: %llu  Jogadores: %d  Semente: %llu\n", (unsigned long long)partidas, numJogadores,
+           (unsigned long long)sementeInicial);
+    printf("Vazao: %.0f partidas/s  %.2f M ticks/s  (%.1f ticks por partida)\n",
+           (double)partidas / segundos, (double)ticksTotais / segundos / 1e6, (double)ticksTotais / (double)partidas);
+    for (int r = 0; r < NUM_ROBOS; r++) {
+        if (participacoes[r] > 0) {
+            printf("  %-14s vitorias: %5.1f%% de %llu participacoes\n", robos[r].nome,
+                   100.0 * (double)vitorias[r] / (double)participacoes[r], (unsigned long long)participacoes[r]);
+        }
+    }
+    printf("  Empates (todos eliminados no mesmo tick): %llu\n", (unsigned long long)empates);
+
+    // Conferência: réplica com os mesmos lotes, hash comparado a cada tick
+    uint64_t divergentes = 0, diferentesDaPrimeira = 0, detectadasNoTick = 0;
+    inicio = agoraSegundos();
+    for (uint64_t m = 0; m < partidas; m++) {
+        ResultadoDuelo conferencia;
+        jogarDuelo(misturar64(sementeInicial + m), m, numJogadores, 1, tickCorrompido, &conferencia);
+        diferentesDaPrimeira += conferencia.hashFinal != resultados[m].hashFinal;
+        if (conferencia.tickDivergente >= 0) {
+            divergentes++;
+            detectadasNoTick += conferencia.tickDivergente == tickCorrompido;
+        }
+    }
+    segundos = agoraSegundos() - inicio;
+
+    printf("Conferencia com replica: %.0f partidas/s\n", (double)partidas / segundos);
+    printf("  Partidas repetidas com hash final diferente: %llu\n", (unsigned long long)diferentesDaPrimeira);
+    if (tickCorrompido < 0) {
+        printf("  Dessincronizacoes: %llu\n", (unsigned long long)divergentes);
+    } else {
+        printf("  Dessincronizacoes: %llu (detectadas no tick %lld: %llu)\n", (unsigned long long)divergentes,
+               (long long)tickCorrompido, (unsigned long long)detectadasNoTick);
+    }
+
+    // Simetria: robôs idênticos (guloso e sempre_jogar) em todos os assentos
+    uint64_t assimetricas = 0, conferidas = 0;
+    for (uint64_t m = 0; m < partidas; m++) {
+        for (int r = 0; r < NUM_ROBOS; r++) {
+            if (robos[r].decidir == roboAleatorio) {
+                continue;   // Sorteia por assento: não é idêntico entre jogadores
+            }
+            int64_t tick = conferirSimetriaDuelo(misturar64(sementeInicial + m), numJogadores, r);
+            if (tick >= 0 && assimetricas++ == 0) {
+                printf("  Primeira assimetria: partida %llu, robo %s, tick %lld\n", (unsigned long long)m,
+                       robos[r].nome, (long long)tick);
+            }
+            conferidas++;
+        }
+    }
+    printf("Simetria com robos identicos: %llu de %llu partidas assimetricas\n", (unsigned long long)assimetricas,
+           (unsigned long long)conferidas);
+
+    free(resultados);
+    // Sem corrupção, qualquer divergência é falha; com --dessincronizar, o
+    // esperado é que todas as partidas acusem a divergência no próprio tick
+    int replicaCorreta = tickCorrompido < 0 ? divergentes == 0 : detectadasNoTick == partidas;
+    return replicaCorreta && diferentesDaPrimeira == 0 && assimetricas == 0 ? 0 : 2;
+}
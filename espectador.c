@@ -0,0 +1,156 @@
+/*
+ * TETRIS STACK - ESPECTADOR
+ *
+ * Acompanha uma sessão do mestre iniciada com --espectador NOME, lendo o
+ * estado publicado em memória compartilhada (ver espectador.h) e exibindo a
+ * mesma visão de exibirEstadoCompleto, mais a última operação e os contadores.
+ * A tela só é redesenhada quando há uma nova publicação.
+ *
+ * Uso: espectador NOME [--uma-vez] [INTERVALO_MS]
+ * Compilação: gcc -O2 espectador.c -o espectador
+ */
+
+#define MESTRE_SEM_MAIN
+#include "mestre.c"
+
+#include <errno.h>
+#include <signal.h>
+
+// ============================================================================
+// EXIBIÇÃO
+// ============================================================================
+
+/**
+ * Exibe o nome de um código lido do segmento, ou "?" e o valor numérico se
+ * ele estiver fora da tabela (escritor corrompido ou de outra versão)
+ * @param nomes Tabela de nomes
+ * @param total Número de entradas da tabela
+ * @param codigo Código lido do segmento
+ */
+static void exibirNomeCodigo(const char* const* nomes, unsigned total, unsigned codigo) {
+    if (codigo < total) {
+        printf("%s", nomes[codigo]);
+    } else {
+        printf("?%u", codigo);
+    }
+}
+
+/**
+ * Reconstrói a fila e a pilha a partir do instantâneo e exibe o estado
+ * com as funções do mestre.c
+ * @param estado Instantâneo lido do segmento
+ */
+static void exibirInstantaneo(const EstadoEspectador* estado) {
+    FilaPecas fila;
+    PilhaReserva pilha;
+
+    fila.frente = 0;
+    fila.tras = 0;
+    fila.tamanho = 0;
+    for (uint32_t i = 0; i < estado->tamanhoFila && i < ESPECTADOR_MAX_PECAS; i++) {
+        Peca peca = { estado->fila[i].nome, estado->fila[i].id };
+        enqueueFila(&fila, peca);
+    }
+    inicializarPilha(&pilha);
+    for (uint32_t i = 0; i < estado->tamanhoPilha && i < ESPECTADOR_MAX_PECAS; i++) {
+        Peca peca = { estado->pilha[i].nome, estado->pilha[i].id };
+        pushPilha(&pilha, peca);
+    }
+
+    exibirEstadoCompleto(&fila, &pilha);
+
+    printf("Ultima operacao: ");
+    if (estado->operacoes == 0) {
+        printf("nenhuma");
+    } else {
+        exibirNomeCodigo(nomesEventos, EVT_NUM_TIPOS, estado->ultimoTipo);
+        printf(" (");
+        exibirNomeCodigo(nomesResultados, EVT_NUM_RESULTADOS, estado->ultimoResultado);
+        printf(")");
+        if (estado->ultimoTipo == EVT_TROCA_MULTIPLA) {
+            if (estado->ultimoResultado == EVT_OK) {
+                printf(" %d pecas", estado->ultimoIdA);
+            }
+        } else if (estado->ultimoNomeA != 0) {
+            printf(" [%c %d]", estado->ultimoNomeA, estado->ultimoIdA);
+            if (estado->ultimoNomeB != 0) {
+                printf(" <-> [%c %d]", estado->ultimoNomeB, estado->ultimoIdB);
+            }
+        }
+    }
+    printf("\nOperacoes: %llu  Falhas: %llu  Pecas geradas: %llu\n",
+           (unsigned long long)estado->operacoes, (unsigned long long)estado->falhas,
+           (unsigned long long)estado->pecasGeradas);
+}
+
+// ============================================================================
+// PROGRAMA PRINCIPAL
+// ============================================================================
+
+int main(int argc, char* argv[]) {
+    const char* nome = NULL;
+    int umaVez = 0;
+    long intervaloMs = 50;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--uma-vez") == 0) {
+            umaVez = 1;
+        } else if (nome == NULL) {
+            nome = argv[i];
+        } else if (atol(argv[i]) > 0) {
+            intervaloMs = atol(argv[i]);
+        } else {
+            nome = NULL;
+            break;
+        }
+    }
+    if (nome == NULL) {
+        fprintf(stderr, "Uso: %s NOME [--uma-vez] [INTERVALO_MS]\n", argv[0]);
+        return 1;
+    }
+
+    const SegmentoEspectador* segmento = abrirLeitorEspectador(nome);
+    if (segmento == NULL) {
+        fprintf(stderr, "Erro: nenhuma sessao publicada como '%s'.\n", nome);
+        return 1;
+    }
+    if (segmento->capacidadeFila != CAPACIDADE_FILA || segmento->capacidadePilha != CAPACIDADE_PILHA) {
+        fprintf(stderr, "Erro: a sessao usa fila de %u e pilha de %u; compile o espectador com "
+                        "-DCAPACIDADE_FILA=%u -DCAPACIDADE_PILHA=%u.\n",
+                segmento->capacidadeFila, segmento->capacidadePilha,
+                segmento->capacidadeFila, segmento->capacidadePilha);
+        fecharLeitorEspectador(segmento);
+        return 1;
+    }
+
+    EstadoEspectador estado;
+    uint32_t ultimaLida = 1; // Ímpar: nunca coincide com uma publicação
+    struct timespec pausa = { intervaloMs / 1000, (intervaloMs % 1000) * 1000000L };
+
+    for (;;) {
+        uint32_t publicacao = lerEstadoEspectador(segmento, &estado);
+
+        if (publicacao != ultimaLida) {
+            ultimaLida = publicacao;
+            if (!umaVez) {
+                printf("\x1b[H\x1b[2J"); // Volta ao início e limpa a tela
+            }
+            printf("=== ESPECTADOR: %s (pid %d) ===\n", nome, segmento->pid);
+            exibirInstantaneo(&estado);
+            fflush(stdout);
+        }
+
+        if (umaVez) {
+            break;
+        }
+        // Sessão encerrada normalmente, ou processo que publicava morreu
+        if (!estado.ativa || (kill(segmento->pid, 0) != 0 && errno == ESRCH)) {
+            printf("\nSessao encerrada.\n");
+            break;
+        }
+        nanosleep(&pausa, NULL);
+    }
+
+    fecharLeitorEspectador(segmento);
+    return 0;
+}
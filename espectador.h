@@ -0,0 +1,314 @@
+/*
+ * TETRIS STACK - TRANSMISSÃO PARA ESPECTADORES
+ *
+ * Publica o estado de uma sessão (fila, reserva, última operação e
+ * contadores) em um segmento de memória compartilhada POSIX, protegido por
+ * um seqlock. O jogo (único escritor) nunca espera por leitores; qualquer
+ * número de leitores locais obtém cópias consistentes lendo a memória
+ * diretamente, sem chamadas de sistema:
+ *
+ *   escritor: sequencia++ (ímpar) -> escreve o estado -> sequencia++ (par)
+ *   leitor:   lê sequencia (par) -> copia o estado -> relê sequencia;
+ *             se mudou, a cópia pode estar misturada e é refeita
+ *
+ * O segmento é criado com shm_open (aparece em /dev/shm) e removido quando
+ * a sessão termina, também por SIGINT/SIGTERM; leitores que já o mapearam
+ * veem o campo "ativa" zerado. Um nome já em uso por outra sessão é recusado;
+ * o de uma sessão que morreu sem removê-lo (SIGKILL) é recuperado.
+ *
+ * Compilação: sem dependências além da libc (glibc >= 2.34; em versões
+ * anteriores, acrescentar -lrt).
+ */
+
+#ifndef ESPECTADOR_H
+#define ESPECTADOR_H
+
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// ============================================================================
+// LAYOUT DO SEGMENTO
+// ============================================================================
+
+#define ESPECTADOR_MAGICO     "TSPE"
+#define ESPECTADOR_VERSAO     1
+#define ESPECTADOR_MAX_PECAS  16        // Limite de peças por estrutura no segmento
+
+/**
+ * Peça no segmento compartilhado
+ */
+typedef struct {
+    int32_t id;
+    char nome;
+} PecaEspectador;
+
+/**
+ * Instantâneo publicado a cada operação
+ */
+typedef struct {
+    uint32_t tamanhoFila;
+    uint32_t tamanhoPilha;
+    PecaEspectador fila[ESPECTADOR_MAX_PECAS];   // Da frente para o final
+    PecaEspectador pilha[ESPECTADOR_MAX_PECAS];  // Da base para o topo
+    uint8_t ultimoTipo;         // TipoEvento da última operação (EVT_INICIO se nenhuma)
+    uint8_t ultimoResultado;    // ResultadoEvento da última operação
+    char ultimoNomeA;
+    char ultimoNomeB;
+    int32_t ultimoIdA;
+    int32_t ultimoIdB;
+    uint64_t operacoes;         // Operações realizadas
+    uint64_t falhas;            // Operações que falharam
+    uint64_t pecasGeradas;      // Peças geradas desde o início
+    uint32_t ativa;             // 1 enquanto a sessão está em andamento
+} EstadoEspectador;
+
+/**
+ * Segmento completo: cabeçalho, contador do seqlock e estado
+ */
+typedef struct {
+    char magico[4];
+    uint32_t versao;
+    uint32_t capacidadeFila;
+    uint32_t capacidadePilha;
+    int32_t pid;                                        // Processo que publica
+    uint32_t sequencia __attribute__((aligned(64)));    // Ímpar durante a escrita
+    EstadoEspectador estado __attribute__((aligned(64)));
+} SegmentoEspectador;
+
+// ============================================================================
+// PUBLICADOR (ESCRITOR ÚNICO)
+// ============================================================================
+
+static SegmentoEspectador* segmentoEspectador = NULL;
+static char nomeSegmentoEspectador[256];
+
+/**
+ * Normaliza o nome do segmento (shm_open exige uma barra inicial)
+ */
+static inline void nomeEspectador(const char* nome, char* destino, size_t tamanho) {
+    snprintf(destino, tamanho, "%s%s", nome[0] == '/' ? "" : "/", nome);
+}
+
+/**
+ * Remove o nome do segmento publicado, se houver. Pode ser chamada de um
+ * tratador de sinal (só faz shm_unlink, que na glibc é um unlink).
+ */
+static inline void removerNomeEspectador(void) {
+    if (segmentoEspectador != NULL) {
+        shm_unlink(nomeSegmentoEspectador);
+    }
+}
+
+/**
+ * Remove o segmento antes de encerrar por sinal (Ctrl+C, kill)
+ * @param sinal Sinal recebido
+ */
+static inline void tratarSinalEspectador(int sinal) {
+    removerNomeEspectador();
+    signal(sinal, SIG_DFL);
+    raise(sinal);
+}
+
+static inline void fecharPublicadorEspectador(void);
+
+/**
+ * Verifica se um segmento existente foi deixado por uma sessão que morreu sem
+ * removê-lo (SIGKILL, queda): o mágico está gravado e o pid não existe mais
+ * @param nome Nome normalizado do segmento
+ * @return 1 se o segmento está abandonado, 0 se pode estar em uso
+ */
+static inline int segmentoEspectadorAbandonado(const char* nome) {
+    int fd = shm_open(nome, O_RDONLY, 0);
+    if (fd < 0) {
+        return 0;
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0 || (size_t)info.st_size < sizeof(SegmentoEspectador)) {
+        close(fd);
+        return 0;
+    }
+    const SegmentoEspectador* antigo = mmap(NULL, sizeof(SegmentoEspectador), PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (antigo == MAP_FAILED) {
+        return 0;
+    }
+    // Sem o mágico, o segmento pode estar sendo preenchido agora
+    int abandonado = memcmp(antigo->magico, ESPECTADOR_MAGICO, 4) == 0 &&
+                     antigo->pid > 0 && kill((pid_t)antigo->pid, 0) != 0 && errno == ESRCH;
+    munmap((void*)antigo, sizeof(SegmentoEspectador));
+    return abandonado;
+}
+
+/**
+ * Cria o segmento e passa a publicar o estado
+ * @param nome Nome do segmento (ex.: "tetris" vira /dev/shm/tetris)
+ * @param capacidadeFila Capacidade da fila da sessão
+ * @param capacidadePilha Capacidade da pilha da sessão
+ * @return 1 se bem-sucedido, 0 caso contrário (errno EEXIST se o nome já
+ *         está em uso por outra sessão, EBUSY se já há um segmento publicado)
+ */
+static inline int abrirPublicadorEspectador(const char* nome, int capacidadeFila, int capacidadePilha) {
+    if (segmentoEspectador != NULL) {
+        errno = EBUSY;
+        return 0;
+    }
+    if (capacidadeFila > ESPECTADOR_MAX_PECAS || capacidadePilha > ESPECTADOR_MAX_PECAS) {
+        errno = EINVAL;
+        return 0;
+    }
+
+    nomeEspectador(nome, nomeSegmentoEspectador, sizeof(nomeSegmentoEspectador));
+    // O_EXCL: nunca reaproveita (e zera) o segmento de outra sessão viva
+    int fd = shm_open(nomeSegmentoEspectador, O_RDWR | O_CREAT | O_EXCL, 0644);
+    if (fd < 0 && errno == EEXIST) {
+        if (!segmentoEspectadorAbandonado(nomeSegmentoEspectador)) {
+            errno = EEXIST;
+            return 0;
+        }
+        // Recupera o nome de uma sessão morta; uma única nova tentativa
+        shm_unlink(nomeSegmentoEspectador);
+        fd = shm_open(nomeSegmentoEspectador, O_RDWR | O_CREAT | O_EXCL, 0644);
+    }
+    if (fd < 0) {
+        return 0;
+    }
+    if (ftruncate(fd, sizeof(SegmentoEspectador)) != 0) {
+        close(fd);
+        shm_unlink(nomeSegmentoEspectador);
+        return 0;
+    }
+    void* mapa = mmap(NULL, sizeof(SegmentoEspectador), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (mapa == MAP_FAILED) {
+        shm_unlink(nomeSegmentoEspectador);
+        return 0;
+    }
+
+    segmentoEspectador = mapa;
+    segmentoEspectador->versao = ESPECTADOR_VERSAO;
+    segmentoEspectador->capacidadeFila = (uint32_t)capacidadeFila;
+    segmentoEspectador->capacidadePilha = (uint32_t)capacidadePilha;
+    segmentoEspectador->pid = (int32_t)getpid();
+    segmentoEspectador->sequencia = 0;
+    // O mágico vai por último: leitores só aceitam o segmento já preenchido
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    memcpy(segmentoEspectador->magico, ESPECTADOR_MAGICO, 4);
+
+    signal(SIGINT, tratarSinalEspectador);
+    signal(SIGTERM, tratarSinalEspectador);
+    // Também remove o segmento se main sair antes do fim da sessão
+    atexit(fecharPublicadorEspectador);
+    return 1;
+}
+
+/**
+ * Abre uma publicação: a partir daqui os leitores descartam o que lerem
+ * @return Estado a preencher (NULL se não há publicador)
+ */
+static inline EstadoEspectador* iniciarPublicacaoEspectador(void) {
+    if (segmentoEspectador == NULL) {
+        return NULL;
+    }
+    uint32_t sequencia = segmentoEspectador->sequencia;
+    __atomic_store_n(&segmentoEspectador->sequencia, sequencia + 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    return &segmentoEspectador->estado;
+}
+
+/**
+ * Fecha a publicação aberta por iniciarPublicacaoEspectador
+ */
+static inline void concluirPublicacaoEspectador(void) {
+    uint32_t sequencia = segmentoEspectador->sequencia;
+    __atomic_store_n(&segmentoEspectador->sequencia, sequencia + 1, __ATOMIC_RELEASE);
+}
+
+/**
+ * Marca a sessão como encerrada e remove o segmento
+ */
+static inline void fecharPublicadorEspectador(void) {
+    if (segmentoEspectador == NULL) {
+        return;
+    }
+    EstadoEspectador* estado = iniciarPublicacaoEspectador();
+    estado->ativa = 0;
+    concluirPublicacaoEspectador();
+
+    munmap(segmentoEspectador, sizeof(SegmentoEspectador));
+    shm_unlink(nomeSegmentoEspectador);
+    segmentoEspectador = NULL;
+}
+
+// ============================================================================
+// LEITOR
+// ============================================================================
+
+/**
+ * Mapeia (somente leitura) o segmento de uma sessão
+ * @param nome Nome do segmento
+ * @return Segmento mapeado, ou NULL se não existe ou é inválido
+ */
+static inline const SegmentoEspectador* abrirLeitorEspectador(const char* nome) {
+    char nomeCompleto[256];
+    nomeEspectador(nome, nomeCompleto, sizeof(nomeCompleto));
+
+    int fd = shm_open(nomeCompleto, O_RDONLY, 0);
+    if (fd < 0) {
+        return NULL;
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0 || (size_t)info.st_size < sizeof(SegmentoEspectador)) {
+        close(fd);
+        return NULL;
+    }
+    void* mapa = mmap(NULL, sizeof(SegmentoEspectador), PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (mapa == MAP_FAILED) {
+        return NULL;
+    }
+
+    const SegmentoEspectador* segmento = mapa;
+    if (memcmp(segmento->magico, ESPECTADOR_MAGICO, 4) != 0 || segmento->versao != ESPECTADOR_VERSAO) {
+        munmap(mapa, sizeof(SegmentoEspectador));
+        return NULL;
+    }
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    return segmento;
+}
+
+/**
+ * Copia um instantâneo consistente do estado, sem chamadas de sistema
+ * @param segmento Segmento mapeado
+ * @param copia Recebe o estado
+ * @return Número da publicação copiada (par); igual ao anterior se nada mudou
+ */
+static inline uint32_t lerEstadoEspectador(const SegmentoEspectador* segmento, EstadoEspectador* copia) {
+    for (;;) {
+        uint32_t antes = __atomic_load_n(&segmento->sequencia, __ATOMIC_ACQUIRE);
+        if (antes & 1) {
+            continue;   // Escrita em andamento
+        }
+        memcpy(copia, (const void*)&segmento->estado, sizeof(*copia));
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        if (__atomic_load_n(&segmento->sequencia, __ATOMIC_RELAXED) == antes) {
+            return antes;
+        }
+    }
+}
+
+/**
+ * Desfaz o mapeamento do leitor
+ */
+static inline void fecharLeitorEspectador(const SegmentoEspectador* segmento) {
+    munmap((void*)segmento, sizeof(SegmentoEspectador));
+}
+
+#endif // ESPECTADOR_H
@@ -0,0 +1,340 @@
+/*
+ * TETRIS STACK - ESTATÍSTICAS DE OPERAÇÕES
+ *
+ * Contadores por thread e histogramas de latência (em ciclos, baldes
+ * logarítmicos de base 2) para cada operação do simulador, além de contadores
+ * de falha (pilha cheia, pilha vazia, tamanhos errados na troca múltipla...).
+ * A latência vai do início da operação até a fila e a pilha estarem alteradas,
+ * antes de qualquer mensagem: a escrita no terminal não entra na amostra.
+ *
+ * Tudo é desativado por padrão: sem -DTETRIS_ESTATISTICAS as macros EST_*
+ * expandem para nada e nenhum código de medição entra no binário.
+ *
+ * Com a instrumentação ativa:
+ * - SIGUSR1 despeja as estatísticas a qualquer momento
+ * - ao sair do programa elas são despejadas automaticamente
+ * - TETRIS_ESTATISTICAS_FORMATO=json|texto escolhe o formato (padrão: texto)
+ * - TETRIS_ESTATISTICAS_SAIDA=arquivo escolhe o destino (padrão: stderr)
+ */
+
+#ifndef ESTATISTICAS_H
+#define ESTATISTICAS_H
+
+// ============================================================================
+// OPERAÇÕES E FALHAS MEDIDAS
+// ============================================================================
+
+typedef enum {
+    EST_JOGAR,
+    EST_RESERVAR,
+    EST_USAR_RESERVA,
+    EST_TROCA_SIMPLES,
+    EST_TROCA_MULTIPLA,
+    EST_NUM_OPERACOES
+} OperacaoEstatistica;
+
+typedef enum {
+    EST_FALHA_FILA_VAZIA,
+    EST_FALHA_PILHA_CHEIA,
+    EST_FALHA_PILHA_VAZIA,
+    EST_FALHA_TROCA_MULTIPLA_FILA,   // Fila com tamanho errado para troca múltipla
+    EST_FALHA_TROCA_MULTIPLA_PILHA,  // Pilha com tamanho errado para troca múltipla
+    EST_NUM_FALHAS
+} FalhaEstatistica;
+
+#ifdef TETRIS_ESTATISTICAS
+
+#include <fcntl.h>
+#include <signal.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+// Baldes do histograma: o balde b conta latências em [2^(b-1), 2^b)
+#define EST_NUM_BALDES 65
+
+/**
+ * Bloco de estatísticas de uma thread. Só a thread dona escreve nele;
+ * o despejo apenas lê, portanto não há travas no caminho quente.
+ */
+typedef struct BlocoEstatisticas {
+    uint64_t contagem[EST_NUM_OPERACOES];
+    uint64_t ciclosTotais[EST_NUM_OPERACOES];
+    uint64_t histograma[EST_NUM_OPERACOES][EST_NUM_BALDES];
+    uint64_t falhas[EST_NUM_FALHAS];
+    struct BlocoEstatisticas* proximo;
+} BlocoEstatisticas;
+
+static const char* nomesOperacoesEst[EST_NUM_OPERACOES] = {
+    "jogar", "reservar", "usar_reserva", "troca_simples", "troca_multipla"
+};
+
+static const char* nomesFalhasEst[EST_NUM_FALHAS] = {
+    "fila_vazia", "pilha_cheia", "pilha_vazia",
+    "troca_multipla_fila", "troca_multipla_pilha"
+};
+
+// Lista global (somente inserção) com os blocos de todas as threads
+static BlocoEstatisticas* blocosEst = NULL;
+static _Thread_local BlocoEstatisticas* blocoEstLocal = NULL;
+
+// Configuração lida uma única vez em estInstalar()
+static int estFdSaida = STDERR_FILENO;
+static int estFormatoJson = 0;
+
+// Buffer do despejo: o despejo não usa stdio para poder rodar no tratador de sinal
+static char estBuffer[1 << 16];
+static size_t estUsado;
+
+// ============================================================================
+// COLETA
+// ============================================================================
+
+/**
+ * Lê o contador de ciclos do processador (TSC em x86, relógio monotônico
+ * em nanossegundos nas demais arquiteturas)
+ * @return Valor atual do contador
+ */
+static inline uint64_t estCiclos(void) {
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+#endif
+}
+
+/**
+ * Obtém (criando na primeira chamada) o bloco de estatísticas da thread atual
+ * @return Ponteiro para o bloco da thread
+ */
+static BlocoEstatisticas* estBlocoLocal(void) {
+    if (blocoEstLocal == NULL) {
+        BlocoEstatisticas* bloco = calloc(1, sizeof(BlocoEstatisticas));
+        if (bloco == NULL) {
+            abort();
+        }
+
+        // Insere na lista global sem travas
+        bloco->proximo = __atomic_load_n(&blocosEst, __ATOMIC_RELAXED);
+        while (!__atomic_compare_exchange_n(&blocosEst, &bloco->proximo, bloco, 0,
+                                            __ATOMIC_RELEASE, __ATOMIC_RELAXED)) {
+        }
+        blocoEstLocal = bloco;
+    }
+    return blocoEstLocal;
+}
+
+/**
+ * Registra uma operação bem-sucedida e sua latência
+ * @param op Operação realizada
+ * @param ciclos Duração da operação em ciclos
+ */
+static inline void estRegistrar(OperacaoEstatistica op, uint64_t ciclos) {
+    BlocoEstatisticas* bloco = estBlocoLocal();
+    int balde = ciclos == 0 ? 0 : 64 - __builtin_clzll(ciclos);
+
+    bloco->contagem[op]++;
+    bloco->ciclosTotais[op] += ciclos;
+    bloco->histograma[op][balde]++;
+}
+
+/**
+ * Registra uma falha de operação
+ * @param falha Tipo da falha
+ */
+static inline void estRegistrarFalha(FalhaEstatistica falha) {
+    estBlocoLocal()->falhas[falha]++;
+}
+
+// ============================================================================
+// DESPEJO (TEXTO E JSON)
+// ============================================================================
+
+static void estTexto(const char* texto) {
+    size_t n = strlen(texto);
+    if (estUsado + n > sizeof(estBuffer)) {
+        n = sizeof(estBuffer) - estUsado;
+    }
+    memcpy(estBuffer + estUsado, texto, n);
+    estUsado += n;
+}
+
+static void estNumero(uint64_t valor) {
+    char digitos[21];
+    int i = sizeof(digitos) - 1;
+
+    digitos[i] = '\0';
+    do {
+        digitos[--i] = (char)('0' + valor % 10);
+        valor /= 10;
+    } while (valor > 0);
+    estTexto(&digitos[i]);
+}
+
+/**
+ * Despeja as estatísticas agregadas de todas as threads no destino configurado.
+ * Usa apenas write(2), podendo ser chamada de dentro de um tratador de sinal.
+ */
+static void estDespejar(void) {
+    BlocoEstatisticas total;
+    uint64_t numThreads = 0;
+
+    memset(&total, 0, sizeof(total));
+    for (BlocoEstatisticas* b = __atomic_load_n(&blocosEst, __ATOMIC_ACQUIRE);
+         b != NULL; b = b->proximo) {
+        for (int op = 0; op < EST_NUM_OPERACOES; op++) {
+            total.contagem[op] += b->contagem[op];
+            total.ciclosTotais[op] += b->ciclosTotais[op];
+            for (int k = 0; k < EST_NUM_BALDES; k++) {
+                total.histograma[op][k] += b->histograma[op][k];
+            }
+        }
+        for (int f = 0; f < EST_NUM_FALHAS; f++) {
+            total.falhas[f] += b->falhas[f];
+        }
+        numThreads++;
+    }
+
+    estUsado = 0;
+    if (estFormatoJson) {
+        estTexto("{\"threads\":");
+        estNumero(numThreads);
+        estTexto(",\"operacoes\":{");
+        for (int op = 0; op < EST_NUM_OPERACOES; op++) {
+            estTexto(op > 0 ? ",\"" : "\"");
+            estTexto(nomesOperacoesEst[op]);
+            estTexto("\":{\"contagem\":");
+            estNumero(total.contagem[op]);
+            estTexto(",\"ciclos_total\":");
+            estNumero(total.ciclosTotais[op]);
+            estTexto(",\"histograma\":[");
+            int primeiro = 1;
+            for (int k = 0; k < EST_NUM_BALDES; k++) {
+                if (total.histograma[op][k] == 0) {
+                    continue;
+                }
+                estTexto(primeiro ? "{\"min\":" : ",{\"min\":");
+                estNumero(k == 0 ? 0 : 1ull << (k - 1));
+                estTexto(",\"contagem\":");
+                estNumero(total.histograma[op][k]);
+                estTexto("}");
+                primeiro = 0;
+            }
+            estTexto("]}");
+        }
+        estTexto("},\"falhas\":{");
+        for (int f = 0; f < EST_NUM_FALHAS; f++) {
+            estTexto(f > 0 ? ",\"" : "\"");
+            estTexto(nomesFalhasEst[f]);
+            estTexto("\":");
+            estNumero(total.falhas[f]);
+        }
+        estTexto("}}\n");
+    } else {
+        estTexto("\n=== ESTATISTICAS (threads: ");
+        estNumero(numThreads);
+        estTexto(") ===\n");
+        for (int op = 0; op < EST_NUM_OPERACOES; op++) {
+            estTexto(nomesOperacoesEst[op]);
+            estTexto(": ");
+            estNumero(total.contagem[op]);
+            estTexto(" ops, media ");
+            estNumero(total.contagem[op] ? total.ciclosTotais[op] / total.contagem[op] : 0);
+            estTexto(" ciclos\n");
+            for (int k = 0; k < EST_NUM_BALDES; k++) {
+                if (total.histograma[op][k] == 0) {
+                    continue;
+                }
+                estTexto("  >= ");
+                estNumero(k == 0 ? 0 : 1ull << (k - 1));
+                estTexto(" ciclos: ");
+                estNumero(total.histograma[op][k]);
+                estTexto("\n");
+            }
+        }
+        estTexto("falhas:");
+        for (int f = 0; f < EST_NUM_FALHAS; f++) {
+            estTexto(" ");
+            estTexto(nomesFalhasEst[f]);
+            estTexto("=");
+            estNumero(total.falhas[f]);
+        }
+        estTexto("\n");
+    }
+
+    size_t escrito = 0;
+    while (escrito < estUsado) {
+        ssize_t n = write(estFdSaida, estBuffer + escrito, estUsado - escrito);
+        if (n <= 0) {
+            break;
+        }
+        escrito += (size_t)n;
+    }
+}
+
+static void estTratadorSinal(int sinal) {
+    (void)sinal;
+    estDespejar();
+}
+
+/**
+ * Despejo ao sair: bloqueia SIGUSR1 para não disputar o buffer com o tratador
+ */
+static void estDespejarAoSair(void) {
+    sigset_t mascara;
+    sigemptyset(&mascara);
+    sigaddset(&mascara, SIGUSR1);
+    sigprocmask(SIG_BLOCK, &mascara, NULL);
+    estDespejar();
+}
+
+/**
+ * Lê a configuração do ambiente e instala o tratador de SIGUSR1 e o despejo
+ * ao sair. Deve ser chamada uma vez no início do programa.
+ */
+static void estInstalar(void) {
+    const char* formato = getenv("TETRIS_ESTATISTICAS_FORMATO");
+    const char* saida = getenv("TETRIS_ESTATISTICAS_SAIDA");
+
+    estFormatoJson = formato != NULL && strcmp(formato, "json") == 0;
+    if (saida != NULL && saida[0] != '\0') {
+        int fd = open(saida, O_WRONLY | O_CREAT | O_APPEND, 0644);
+        if (fd >= 0) {
+            estFdSaida = fd;
+        }
+    }
+
+    struct sigaction acao;
+    memset(&acao, 0, sizeof(acao));
+    acao.sa_handler = estTratadorSinal;
+    acao.sa_flags = SA_RESTART;
+    sigemptyset(&acao.sa_mask);
+    sigaction(SIGUSR1, &acao, NULL);
+
+    atexit(estDespejarAoSair);
+}
+
+#define EST_INSTALAR()            estInstalar()
+#define EST_MARCAR_INICIO(var)    uint64_t var = estCiclos()
+#define EST_REGISTRAR(op, var)    estRegistrar((op), estCiclos() - (var))
+#define EST_FALHA(falha)          estRegistrarFalha(falha)
+
+#else
+
+// Instrumentação desativada: nenhuma instrução é gerada
+#define EST_INSTALAR()            ((void)0)
+#define EST_MARCAR_INICIO(var)    ((void)0)
+#define EST_REGISTRAR(op, var)    ((void)0)
+#define EST_FALHA(falha)          ((void)0)
+
+#endif // TETRIS_ESTATISTICAS
+
+#endif // ESTATISTICAS_H
@@ -0,0 +1,306 @@
+/*
+ * TETRIS STACK - FLUXO DE EVENTOS
+ *
+ * Emissor de eventos tipados para consumidores automáticos (análises,
+ * verificadores), no lugar de extrair dados das mensagens de texto.
+ * Cada operação e seu resultado viram um evento, gravado em um de dois
+ * formatos, sempre em um buffer grande descarregado com poucas escritas:
+ *
+ * Binário (--eventos-bin):
+ *   Cabeçalho de 16 bytes: "TSEV", versão (u16), tamanho do quadro (u16),
+ *   capacidade da fila (u16), capacidade da pilha (u16), reservado (u32).
+ *   Seguido de quadros de 16 bytes, little-endian:
+ *     u32 sequencia | u8 tipo | u8 resultado | u8 nomeA | u8 nomeB |
+ *     i32 idA | i32 idB
+ *   Peças ausentes têm nome 0 e id -1. Na troca múltipla, idA guarda o número
+ *   de peças trocadas (k). No evento "fim", idA/idB guardam as
+ *   metades baixa/alta do checksum do estado final.
+ *
+ * JSON Lines (--eventos-json): um objeto por linha, por exemplo
+ *   {"seq":7,"evento":"jogar","resultado":"ok","peca":{"nome":"T","id":2}}
+ */
+
+#ifndef EVENTOS_H
+#define EVENTOS_H
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+// ============================================================================
+// DEFINIÇÕES DO FORMATO
+// ============================================================================
+
+#define EVENTOS_MAGICO        "TSEV"
+#define EVENTOS_VERSAO        1
+#define EVENTOS_TAM_CABECALHO 16
+#define EVENTOS_TAM_QUADRO    16
+
+/**
+ * Tipos de evento
+ */
+typedef enum {
+    EVT_INICIO,
+    EVT_PECA_GERADA,
+    EVT_JOGAR,
+    EVT_RESERVAR,
+    EVT_USAR_RESERVA,
+    EVT_TROCA_SIMPLES,
+    EVT_TROCA_MULTIPLA,
+    EVT_FIM,
+    EVT_NUM_TIPOS
+} TipoEvento;
+
+/**
+ * Resultado da operação registrada no evento
+ */
+typedef enum {
+    EVT_OK,
+    EVT_ERRO_FILA_VAZIA,
+    EVT_ERRO_PILHA_CHEIA,
+    EVT_ERRO_PILHA_VAZIA,
+    EVT_ERRO_TAMANHO_FILA,   // Fila com tamanho errado para troca múltipla
+    EVT_ERRO_TAMANHO_PILHA,  // Pilha com tamanho errado para troca múltipla
+    EVT_NUM_RESULTADOS
+} ResultadoEvento;
+
+/**
+ * Evento decodificado (mesmos campos do quadro binário)
+ */
+typedef struct {
+    uint32_t sequencia;
+    uint8_t tipo;
+    uint8_t resultado;
+    char nomeA;
+    char nomeB;
+    int32_t idA;
+    int32_t idB;
+} Evento;
+
+static const char* nomesEventos[EVT_NUM_TIPOS] = {
+    "inicio", "peca_gerada", "jogar", "reservar", "usar_reserva",
+    "troca_simples", "troca_multipla", "fim"
+};
+
+static const char* nomesResultados[EVT_NUM_RESULTADOS] = {
+    "ok", "fila_vazia", "pilha_cheia", "pilha_vazia", "tamanho_fila", "tamanho_pilha"
+};
+
+// ============================================================================
+// EMISSOR
+// ============================================================================
+
+#define EVENTOS_TAM_BUFFER (1 << 20)
+
+typedef enum {
+    EMISSOR_DESATIVADO,
+    EMISSOR_BINARIO,
+    EMISSOR_JSON
+} FormatoEmissor;
+
+/**
+ * Estado do emissor: o buffer só é descarregado quando enche ou ao final
+ */
+typedef struct {
+    FormatoEmissor formato;
+    int fd;
+    uint32_t sequencia;
+    size_t usado;
+    char* buffer;
+} EmissorEventos;
+
+static EmissorEventos emissor = { EMISSOR_DESATIVADO, -1, 0, 0, NULL };
+
+/**
+ * Última operação e totais, mantidos mesmo sem emissor configurado
+ * (publicados para os espectadores, ver espectador.h)
+ */
+typedef struct {
+    Evento ultima;          // Última operação (sequencia = número da operação)
+    uint64_t operacoes;     // Operações registradas
+    uint64_t falhas;        // Operações com resultado diferente de ok
+} ResumoEventos;
+
+// Um por thread: os trabalhadores do torneio.c e ferramentas que reexecutam
+// sessões em paralelo (ex.: verificador.c) leem o evento da própria thread
+static _Thread_local ResumoEventos resumoEventos;
+
+/**
+ * Descarrega o buffer do emissor no arquivo de saída
+ */
+static inline void descarregarEventos(void) {
+    size_t escrito = 0;
+    while (escrito < emissor.usado) {
+        ssize_t n = write(emissor.fd, emissor.buffer + escrito, emissor.usado - escrito);
+        if (n <= 0) {
+            break;
+        }
+        escrito += (size_t)n;
+    }
+    emissor.usado = 0;
+}
+
+static inline void escreverU16(char* destino, uint16_t valor) {
+    destino[0] = (char)(valor & 0xFF);
+    destino[1] = (char)(valor >> 8);
+}
+
+static inline void escreverU32(char* destino, uint32_t valor) {
+    for (int i = 0; i < 4; i++) {
+        destino[i] = (char)((valor >> (8 * i)) & 0xFF);
+    }
+}
+
+static inline uint32_t lerU32(const unsigned char* origem) {
+    return (uint32_t)origem[0] | ((uint32_t)origem[1] << 8) |
+           ((uint32_t)origem[2] << 16) | ((uint32_t)origem[3] << 24);
+}
+
+/**
+ * Registra um evento. Sem emissor configurado, só atualiza o resumo.
+ * @param tipo Tipo do evento
+ * @param resultado Resultado da operação
+ * @param nomeA Tipo da primeira peça envolvida (0 se nenhuma)
+ * @param idA ID da primeira peça envolvida (-1 se nenhuma)
+ * @param nomeB Tipo da segunda peça envolvida (0 se nenhuma)
+ * @param idB ID da segunda peça envolvida (-1 se nenhuma)
+ */
+static inline void emitirEvento(TipoEvento tipo, ResultadoEvento resultado,
+                                char nomeA, int32_t idA, char nomeB, int32_t idB) {
+    if (tipo >= EVT_JOGAR && tipo <= EVT_TROCA_MULTIPLA) {
+        Evento ultima = { (uint32_t)resumoEventos.operacoes, (uint8_t)tipo, (uint8_t)resultado,
+                          nomeA, nomeB, idA, idB };
+        resumoEventos.ultima = ultima;
+        resumoEventos.operacoes++;
+        resumoEventos.falhas += resultado != EVT_OK;
+    }
+
+    if (emissor.formato == EMISSOR_DESATIVADO) {
+        return;
+    }
+
+    // Garante espaço para o maior evento possível
+    if (emissor.usado + 256 > EVENTOS_TAM_BUFFER) {
+        descarregarEventos();
+    }
+
+    char* destino = emissor.buffer + emissor.usado;
+    uint32_t sequencia = emissor.sequencia++;
+
+    if (emissor.formato == EMISSOR_BINARIO) {
+        escreverU32(destino, sequencia);
+        destino[4] = (char)tipo;
+        destino[5] = (char)resultado;
+        destino[6] = nomeA;
+        destino[7] = nomeB;
+        escreverU32(destino + 8, (uint32_t)idA);
+        escreverU32(destino + 12, (uint32_t)idB);
+        emissor.usado += EVENTOS_TAM_QUADRO;
+        return;
+    }
+
+    int n = snprintf(destino, 256, "{\"seq\":%u,\"evento\":\"%s\",\"resultado\":\"%s\"",
+                     sequencia, nomesEventos[tipo], nomesResultados[resultado]);
+    if (tipo == EVT_FIM) {
+        n += snprintf(destino + n, 256 - n, ",\"checksum\":\"%08x%08x\"",
+                      (uint32_t)idB, (uint32_t)idA);
+    } else if (tipo == EVT_INICIO) {
+        n += snprintf(destino + n, 256 - n, ",\"capacidade_fila\":%d,\"capacidade_pilha\":%d",
+                      idA, idB);
+    } else if (tipo == EVT_TROCA_MULTIPLA) {
+        n += snprintf(destino + n, 256 - n, ",\"k\":%d", idA);
+    } else if (tipo == EVT_TROCA_SIMPLES && nomeB != 0) {
+        n += snprintf(destino + n, 256 - n,
+                      ",\"fila\":{\"nome\":\"%c\",\"id\":%d},\"pilha\":{\"nome\":\"%c\",\"id\":%d}",
+                      nomeA, idA, nomeB, idB);
+    } else if (nomeA != 0) {
+        n += snprintf(destino + n, 256 - n, ",\"peca\":{\"nome\":\"%c\",\"id\":%d}", nomeA, idA);
+    }
+    destino[n++] = '}';
+    destino[n++] = '\n';
+    emissor.usado += (size_t)n;
+}
+
+/**
+ * Descarrega os eventos pendentes e fecha o arquivo (chamada ao sair)
+ */
+static inline void finalizarEventos(void) {
+    if (emissor.formato == EMISSOR_DESATIVADO) {
+        return;
+    }
+    descarregarEventos();
+    close(emissor.fd);
+    free(emissor.buffer);
+    emissor.formato = EMISSOR_DESATIVADO;
+}
+
+/**
+ * Abre o arquivo de eventos e grava o cabeçalho e o evento de início
+ * @param caminho Caminho do arquivo de saída
+ * @param formato EMISSOR_BINARIO ou EMISSOR_JSON
+ * @param capacidadeFila Capacidade da fila da sessão
+ * @param capacidadePilha Capacidade da pilha da sessão
+ * @return 1 se bem-sucedido, 0 caso contrário (errno EBUSY se já há um
+ *         emissor aberto: a sessão grava um único fluxo)
+ */
+static inline int iniciarEventos(const char* caminho, FormatoEmissor formato,
+                                 int capacidadeFila, int capacidadePilha) {
+    if (emissor.formato != EMISSOR_DESATIVADO) {
+        errno = EBUSY;
+        return 0;
+    }
+    int fd = open(caminho, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        return 0;
+    }
+
+    emissor.buffer = malloc(EVENTOS_TAM_BUFFER);
+    if (emissor.buffer == NULL) {
+        close(fd);
+        return 0;
+    }
+    emissor.fd = fd;
+    emissor.formato = formato;
+    emissor.sequencia = 0;
+    emissor.usado = 0;
+
+    if (formato == EMISSOR_BINARIO) {
+        char* cabecalho = emissor.buffer;
+        memset(cabecalho, 0, EVENTOS_TAM_CABECALHO);
+        memcpy(cabecalho, EVENTOS_MAGICO, 4);
+        escreverU16(cabecalho + 4, EVENTOS_VERSAO);
+        escreverU16(cabecalho + 6, EVENTOS_TAM_QUADRO);
+        escreverU16(cabecalho + 8, (uint16_t)capacidadeFila);
+        escreverU16(cabecalho + 10, (uint16_t)capacidadePilha);
+        emissor.usado = EVENTOS_TAM_CABECALHO;
+    }
+
+    emitirEvento(EVT_INICIO, EVT_OK, 0, capacidadeFila, 0, capacidadePilha);
+    atexit(finalizarEventos);
+    return 1;
+}
+
+// ============================================================================
+// LEITURA DO FORMATO BINÁRIO
+// ============================================================================
+
+/**
+ * Decodifica um quadro binário de evento
+ * @param quadro Ponteiro para os 16 bytes do quadro
+ * @param evento Ponteiro para armazenar o evento decodificado
+ */
+static inline void decodificarEvento(const unsigned char* quadro, Evento* evento) {
+    evento->sequencia = lerU32(quadro);
+    evento->tipo = quadro[4];
+    evento->resultado = quadro[5];
+    evento->nomeA = (char)quadro[6];
+    evento->nomeB = (char)quadro[7];
+    evento->idA = (int32_t)lerU32(quadro + 8);
+    evento->idB = (int32_t)lerU32(quadro + 12);
+}
+
+#endif // EVENTOS_H
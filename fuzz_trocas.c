@@ -0,0 +1,596 @@
+/*
+ * TETRIS STACK - FUZZING DIFERENCIAL DAS TROCAS
+ *
+ * Roda a mesma sequência de operações na lógica de referência do mestre.c
+ * (FilaPecas/PilhaReserva com trocarSimples, trocarMultipla e trocarBloco)
+ * e nos motores otimizados, comparando o estado após cada passo:
+ *   compacta:  sessao_compacta.h (tipos e ids, incluindo a troca de k peças)
+ *   lote64:    kernel de 64 bits do lote.h (só tipos, sem troca de k peças)
+ *   loteAVX2:  kernel AVX2 do lote.h, 4 sessões por registrador
+ * Os kernels do lote.h só entram com as capacidades padrão (fila de 5,
+ * pilha de 3); após uma troca de k peças eles são ressincronizados a partir
+ * da referência.
+ *
+ * Cada caso é uma sequência de bytes: os 8 primeiros são a semente das
+ * peças e cada byte seguinte é um passo (bits 0..2: operação, 5 a 7 = troca
+ * de k peças; bits 3..7: k, incluindo valores inválidos). O mesmo caso é
+ * aplicado a FUZZ_RAIAS sessões com sementes diferentes, para que o kernel
+ * AVX2 veja sessões em estados distintos no mesmo registrador.
+ *
+ * Modos:
+ *   fuzz_trocas [--casos N] [--passos P] [--semente S]   casos aleatórios
+ *   fuzz_trocas --bench [RODADAS]                        vazão de cada motor
+ *   fuzz_trocas CASO...                                  reproduz casos salvos
+ * Uma divergência imprime os dois estados, salva o caso em
+ * fuzz_trocas-falha.bin e termina com abort().
+ *
+ * Compilação: gcc -O2 -march=native fuzz_trocas.c -o fuzz_trocas
+ * Como alvo do libFuzzer:
+ *   clang -O1 -g -march=native -fsanitize=fuzzer,address -DFUZZ_TROCAS_LIBFUZZER \
+ *         fuzz_trocas.c -o fuzz_trocas_lf
+ */
+
+#define MESTRE_SEM_MAIN
+#include "mestre.c"
+
+#include <stdint.h>
+
+#include "lote.h"
+#include "sessao_compacta.h"
+
+// ============================================================================
+// DEFINIÇÕES E ESTRUTURAS
+// ============================================================================
+
+#define FUZZ_RAIAS          4       // Sessões por caso (um registrador AVX2)
+#define FUZZ_TROCA_BLOCO    LOTE_NUM_OPERACOES
+#define FUZZ_COM_LOTE       (CAPACIDADE_FILA == LOTE_FILA && CAPACIDADE_PILHA == LOTE_PILHA)
+
+static const char* nomesOperacoesFuzz[] = {
+    "jogar", "reservar", "usar_reserva", "troca_simples", "troca_multipla", "troca_bloco"
+};
+
+/**
+ * Sessão de referência: estruturas e funções do mestre.c, com o mesmo
+ * gerador de peças da sessão compacta
+ */
+typedef struct {
+    FilaPecas fila;
+    PilhaReserva pilha;
+    uint64_t rng;
+    uint32_t proximoId;
+} ReferenciaFuzz;
+
+/**
+ * Estado de um caso: cada raia em todos os motores
+ */
+typedef struct {
+    ReferenciaFuzz referencias[FUZZ_RAIAS];
+    SessaoCompacta compactas[FUZZ_RAIAS];
+    uint64_t lote64[FUZZ_RAIAS];
+    uint64_t loteAVX2[FUZZ_RAIAS];
+} CasoFuzz;
+
+// Caso em execução, salvo se houver divergência
+static const uint8_t* casoAtual;
+static size_t tamanhoCasoAtual;
+
+// ============================================================================
+// REFERÊNCIA (MESTRE.C)
+// ============================================================================
+
+/**
+ * Semente de uma raia a partir da semente do caso (splitmix64)
+ */
+static uint64_t misturarSementeFuzz(uint64_t semente, int raia) {
+    uint64_t z = semente + (uint64_t)(raia + 1) * 0x9E3779B97F4A7C15ULL;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+/**
+ * Avança um gerador xorshift64 (o mesmo de enqueueCompacta)
+ */
+static inline uint64_t avancarGeradorFuzz(uint64_t x) {
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    return x;
+}
+
+/**
+ * Gera a próxima peça da sessão de referência (mesma sequência de enqueueCompacta)
+ */
+static Peca gerarPecaReferencia(ReferenciaFuzz* ref) {
+    static const char tipos[4] = {'I', 'O', 'T', 'L'};
+    uint64_t x = avancarGeradorFuzz(ref->rng);
+    ref->rng = x;
+
+    Peca peca = { tipos[x >> 62], (int)ref->proximoId++ };
+    return peca;
+}
+
+/**
+ * Inicializa a referência como iniciarSessaoCompacta
+ */
+static void iniciarReferencia(ReferenciaFuzz* ref, uint64_t semente, uint32_t primeiroId) {
+    ref->rng = semente != 0 ? semente : 0x9E3779B97F4A7C15ULL;
+    ref->proximoId = primeiroId;
+    ref->fila.frente = 0;
+    ref->fila.tras = 0;
+    ref->fila.tamanho = 0;
+    ref->fila.sujo = SUJO_TUDO;
+    inicializarPilha(&ref->pilha);
+    for (int i = 0; i < CAPACIDADE_FILA; i++) {
+        enqueueFila(&ref->fila, gerarPecaReferencia(ref));
+    }
+}
+
+/**
+ * Aplica uma operação com as funções do mestre.c (as mesmas chamadas do menu)
+ * @return 1 se aplicada, 0 se a validação falhou
+ */
+static int aplicarReferencia(ReferenciaFuzz* ref, int op, int k) {
+    Peca peca;
+    switch (op) {
+        case LOTE_JOGAR:
+            if (!dequeueFila(&ref->fila, &peca)) {
+                return 0;
+            }
+            enqueueFila(&ref->fila, gerarPecaReferencia(ref));
+            return 1;
+        case LOTE_RESERVAR:
+            if (pilhaCheia(&ref->pilha) || !dequeueFila(&ref->fila, &peca)) {
+                return 0;
+            }
+            pushPilha(&ref->pilha, peca);
+            enqueueFila(&ref->fila, gerarPecaReferencia(ref));
+            return 1;
+        case LOTE_USAR_RESERVA:
+            return popPilha(&ref->pilha, &peca);
+        case LOTE_TROCA_SIMPLES:
+            return trocarSimples(&ref->fila, &ref->pilha);
+        case LOTE_TROCA_MULTIPLA:
+            return trocarMultipla(&ref->fila, &ref->pilha);
+        default:
+            return trocarBloco(&ref->fila, &ref->pilha, k);
+    }
+}
+
+/**
+ * Empacota os tipos da referência no formato do lote.h
+ */
+static uint64_t empacotarLote(const ReferenciaFuzz* ref) {
+    uint64_t compactada = 0;
+    int indice = ref->fila.frente;
+    for (int i = 0; i < ref->fila.tamanho && i < LOTE_FILA; i++) {
+        compactada |= (uint64_t)codigoLote(ref->fila.pecas[indice].nome) << (8 * i);
+        indice = (indice + 1) % CAPACIDADE_FILA;
+    }
+    for (int j = 0; j <= ref->pilha.topo && j < LOTE_PILHA; j++) {
+        compactada |= (uint64_t)codigoLote(ref->pilha.pecas[ref->pilha.topo - j].nome) << (8 * (LOTE_FILA + j));
+    }
+    return compactada;
+}
+
+// ============================================================================
+// COMPARAÇÃO
+// ============================================================================
+
+/**
+ * Compara a referência com a sessão compacta peça a peça (fila da frente
+ * para o final, pilha da base ao topo) e no próximo id
+ * @return 1 se iguais
+ */
+static int referenciaIgualCompacta(const ReferenciaFuzz* ref, const SessaoCompacta* sessao) {
+    if (ref->fila.tamanho != sessao->tamanho || ref->pilha.topo + 1 != sessao->altura ||
+        ref->proximoId != sessao->proximoId) {
+        return 0;
+    }
+    int indiceRef = ref->fila.frente;
+    int indiceCompacta = sessao->frente;
+    for (int i = 0; i < ref->fila.tamanho; i++) {
+        if (ref->fila.pecas[indiceRef].nome != sessao->tipos[indiceCompacta] ||
+            (uint32_t)ref->fila.pecas[indiceRef].id != sessao->ids[indiceCompacta]) {
+            return 0;
+        }
+        indiceRef = (indiceRef + 1) % CAPACIDADE_FILA;
+        indiceCompacta = (indiceCompacta + 1) % CAPACIDADE_FILA;
+    }
+    for (int i = 0; i <= ref->pilha.topo; i++) {
+        if (ref->pilha.pecas[i].nome != sessao->tipos[SESSAO_PILHA(i)] ||
+            (uint32_t)ref->pilha.pecas[i].id != sessao->ids[SESSAO_PILHA(i)]) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+/**
+ * Salva o caso atual, descreve a divergência e aborta
+ */
+static void relatarDivergencia(const char* motor, size_t passo, int raia, int op, int k,
+                               int okRef, int okMotor, CasoFuzz* caso) {
+    FILE* arquivo = fopen("fuzz_trocas-falha.bin", "wb");
+    if (arquivo != NULL) {
+        fwrite(casoAtual, 1, tamanhoCasoAtual, arquivo);
+        fclose(arquivo);
+    }
+
+    fprintf(stderr, "\nDIVERGENCIA (%s) no passo %zu, raia %d: %s", motor, passo, raia, nomesOperacoesFuzz[op]);
+    if (op == FUZZ_TROCA_BLOCO) {
+        fprintf(stderr, " k=%d", k);
+    }
+    fprintf(stderr, " (referencia %s, %s %s)\n", okRef ? "aplicou" : "recusou", motor,
+            okMotor ? "aplicou" : "recusou");
+
+    // Estados após o passo, no formato do mestre.c
+    FilaPecas fila;
+    PilhaReserva pilha;
+    modoSilencioso = 0;
+    printf("Referencia:");
+    exibirEstadoCompleto(&caso->referencias[raia].fila, &caso->referencias[raia].pilha);
+    expandirSessao(&caso->compactas[raia], &fila, &pilha);
+    printf("Compacta (proximo id %u):", caso->compactas[raia].proximoId);
+    exibirEstadoCompleto(&fila, &pilha);
+    if (strncmp(motor, "lote", 4) == 0) {
+        printf("lote64 0x%016llx  loteAVX2 0x%016llx  referencia empacotada 0x%016llx\n",
+               (unsigned long long)caso->lote64[raia], (unsigned long long)caso->loteAVX2[raia],
+               (unsigned long long)empacotarLote(&caso->referencias[raia]));
+    }
+    fprintf(stderr, "Caso salvo em fuzz_trocas-falha.bin (%zu bytes)\n", tamanhoCasoAtual);
+    fflush(stdout);
+    abort();
+}
+
+// ============================================================================
+// EXECUÇÃO DE UM CASO
+// ============================================================================
+
+/**
+ * Executa um caso em todos os motores, comparando após cada passo;
+ * aborta na primeira divergência
+ * @param dados Bytes do caso (semente + passos)
+ * @param tamanho Número de bytes
+ */
+static void executarCaso(const uint8_t* dados, size_t tamanho) {
+    CasoFuzz caso;
+    uint64_t semente = 0;
+
+    modoSilencioso = 1;
+    casoAtual = dados;
+    tamanhoCasoAtual = tamanho;
+    for (size_t i = 0; i < 8 && i < tamanho; i++) {
+        semente |= (uint64_t)dados[i] << (8 * i);
+    }
+
+    for (int r = 0; r < FUZZ_RAIAS; r++) {
+        uint64_t sementeRaia = misturarSementeFuzz(semente, r);
+        iniciarReferencia(&caso.referencias[r], sementeRaia, (uint32_t)r << 24);
+        iniciarSessaoCompacta(&caso.compactas[r], sementeRaia, (uint32_t)r << 24);
+        caso.lote64[r] = caso.loteAVX2[r] = empacotarLote(&caso.referencias[r]);
+    }
+
+    for (size_t passo = 8; passo < tamanho; passo++) {
+        int op = dados[passo] & 7;
+        int k = (dados[passo] >> 3) % (CAPACIDADE_PILHA + 2);  // 0 e CAPACIDADE_PILHA + 1 são inválidos
+        if (op > FUZZ_TROCA_BLOCO) {
+            op = FUZZ_TROCA_BLOCO;
+        }
+
+        int okRef[FUZZ_RAIAS];
+        uint8_t novas[FUZZ_RAIAS];
+        for (int r = 0; r < FUZZ_RAIAS; r++) {
+            ReferenciaFuzz* ref = &caso.referencias[r];
+            okRef[r] = aplicarReferencia(ref, op, k);
+            novas[r] = codigoLote(ref->fila.pecas[(ref->fila.tras + CAPACIDADE_FILA - 1) % CAPACIDADE_FILA].nome);
+
+            int okCompacta;
+            switch (op) {
+                case LOTE_JOGAR:          okCompacta = jogarCompacta(&caso.compactas[r]); break;
+                case LOTE_RESERVAR:       okCompacta = reservarCompacta(&caso.compactas[r]); break;
+                case LOTE_USAR_RESERVA:   okCompacta = usarReservaCompacta(&caso.compactas[r]); break;
+                case LOTE_TROCA_SIMPLES:  okCompacta = trocarSimplesCompacta(&caso.compactas[r]); break;
+                case LOTE_TROCA_MULTIPLA: okCompacta = trocarMultiplaCompacta(&caso.compactas[r]); break;
+                default:                  okCompacta = trocarBlocoCompacta(&caso.compactas[r], k); break;
+            }
+            if (okCompacta != okRef[r] || !referenciaIgualCompacta(ref, &caso.compactas[r])) {
+                relatarDivergencia("compacta", passo - 8, r, op, k, okRef[r], okCompacta, &caso);
+            }
+        }
+
+        if (!FUZZ_COM_LOTE) {
+            continue;
+        }
+        if (op == FUZZ_TROCA_BLOCO) {
+            // Sem equivalente no lote.h: ressincroniza a partir da referência
+            for (int r = 0; r < FUZZ_RAIAS; r++) {
+                caso.lote64[r] = caso.loteAVX2[r] = empacotarLote(&caso.referencias[r]);
+            }
+            continue;
+        }
+
+        uint8_t okAVX2[FUZZ_RAIAS];
+#if defined(__AVX2__)
+        aplicarLoteAVX2(caso.loteAVX2, novas, okAVX2, FUZZ_RAIAS, (OperacaoLote)op);
+#else
+        aplicarLoteEscalar(caso.loteAVX2, novas, okAVX2, FUZZ_RAIAS, (OperacaoLote)op);
+#endif
+        for (int r = 0; r < FUZZ_RAIAS; r++) {
+            int ok64;
+            uint64_t esperado = empacotarLote(&caso.referencias[r]);
+            caso.lote64[r] = aplicarLote64(caso.lote64[r], (OperacaoLote)op, novas[r], &ok64);
+            if (ok64 != okRef[r] || caso.lote64[r] != esperado) {
+                relatarDivergencia("lote64", passo - 8, r, op, k, okRef[r], ok64, &caso);
+            }
+            if (okAVX2[r] != okRef[r] || caso.loteAVX2[r] != esperado) {
+                relatarDivergencia("loteAVX2", passo - 8, r, op, k, okRef[r], okAVX2[r], &caso);
+            }
+        }
+    }
+}
+
+#ifndef FUZZ_TROCAS_LIBFUZZER
+// ============================================================================
+// VAZÃO
+// ============================================================================
+
+#define BENCH_SESSOES   1024
+
+typedef enum {
+    MOTOR_MESTRE,
+    MOTOR_COMPACTA,
+    MOTOR_LOTE64,
+    MOTOR_LOTE_AVX2,
+    NUM_MOTORES
+} MotorFuzz;
+
+static const char* nomesMotores[NUM_MOTORES] = { "mestre", "compacta", "lote64", "loteAVX2" };
+
+static double agoraSegundos(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+/**
+ * Aplica as rodadas (uma operação por rodada, em todas as sessões) com um
+ * motor. Os motores do lote sorteiam a peça nova antes e só avançam o
+ * gerador das sessões em que a operação foi aplicada, para terminarem com
+ * os mesmos tipos que os demais.
+ * @param motor Motor a medir
+ * @param ops Operação de cada rodada (0 a LOTE_NUM_OPERACOES - 1)
+ * @param rodadas Número de rodadas
+ * @param final Recebe os tipos finais de cada sessão no formato do lote.h
+ * @return Segundos gastos nas rodadas
+ */
+static double medirMotor(MotorFuzz motor, const uint8_t* ops, size_t rodadas, uint64_t* final) {
+    static ReferenciaFuzz referencias[BENCH_SESSOES];
+    static SessaoCompacta compactas[BENCH_SESSOES];
+    static uint64_t lote[BENCH_SESSOES];
+    static uint64_t geradores[BENCH_SESSOES], tentativas[BENCH_SESSOES];
+    static uint8_t novas[BENCH_SESSOES], aplicadas[BENCH_SESSOES];
+
+    for (int i = 0; i < BENCH_SESSOES; i++) {
+        iniciarReferencia(&referencias[i], misturarSementeFuzz(1, i), 0);
+        iniciarSessaoCompacta(&compactas[i], misturarSementeFuzz(1, i), 0);
+        lote[i] = empacotarLote(&referencias[i]);
+        geradores[i] = referencias[i].rng;
+    }
+
+    double inicio = agoraSegundos();
+    for (size_t rodada = 0; rodada < rodadas; rodada++) {
+        int op = ops[rodada];
+        switch (motor) {
+            case MOTOR_MESTRE:
+                for (int i = 0; i < BENCH_SESSOES; i++) {
+                    aplicarReferencia(&referencias[i], op, 0);
+                }
+                break;
+            case MOTOR_COMPACTA:
+                for (int i = 0; i < BENCH_SESSOES; i++) {
+                    SessaoCompacta* sessao = &compactas[i];
+                    switch (op) {
+                        case LOTE_JOGAR:         jogarCompacta(sessao); break;
+                        case LOTE_RESERVAR:      reservarCompacta(sessao); break;
+                        case LOTE_USAR_RESERVA:  usarReservaCompacta(sessao); break;
+                        case LOTE_TROCA_SIMPLES: trocarSimplesCompacta(sessao); break;
+                        default:                 trocarMultiplaCompacta(sessao); break;
+                    }
+                }
+                break;
+            default:
+                for (int i = 0; i < BENCH_SESSOES; i++) {
+                    tentativas[i] = avancarGeradorFuzz(geradores[i]);
+                    novas[i] = (uint8_t)(1 + (tentativas[i] >> 62));
+                }
+#if defined(__AVX2__)
+                if (motor == MOTOR_LOTE_AVX2) {
+                    aplicarLoteAVX2(lote, novas, aplicadas, BENCH_SESSOES, (OperacaoLote)op);
+                } else
+#endif
+                {
+                    aplicarLoteEscalar(lote, novas, aplicadas, BENCH_SESSOES, (OperacaoLote)op);
+                }
+                if (op == LOTE_JOGAR || op == LOTE_RESERVAR) {
+                    for (int i = 0; i < BENCH_SESSOES; i++) {
+                        geradores[i] = aplicadas[i] ? tentativas[i] : geradores[i];
+                    }
+                }
+                break;
+        }
+    }
+    double segundos = agoraSegundos() - inicio;
+
+    for (int i = 0; i < BENCH_SESSOES; i++) {
+        if (motor == MOTOR_MESTRE) {
+            final[i] = empacotarLote(&referencias[i]);
+        } else if (motor == MOTOR_COMPACTA) {
+            ReferenciaFuzz expandida;
+            expandirSessao(&compactas[i], &expandida.fila, &expandida.pilha);
+            final[i] = empacotarLote(&expandida);
+        } else {
+            final[i] = lote[i];
+        }
+    }
+    return segundos;
+}
+
+/**
+ * Compara a vazão dos motores nas mesmas rodadas e confere que todos
+ * terminam com os mesmos tipos em todas as sessões
+ * @return 0 se os motores concordam, 2 caso contrário
+ */
+static int executarBench(size_t rodadas) {
+    if (!FUZZ_COM_LOTE) {
+        fprintf(stderr, "Erro: o modo --bench exige as capacidades padrao (%d e %d).\n", LOTE_FILA, LOTE_PILHA);
+        return 1;
+    }
+
+    uint8_t* ops = malloc(rodadas);
+    uint64_t* finais = malloc(sizeof(uint64_t) * BENCH_SESSOES * NUM_MOTORES);
+    if (ops == NULL || finais == NULL) {
+        fprintf(stderr, "Erro: memoria insuficiente.\n");
+        return 1;
+    }
+    uint64_t rng = 0x2545F4914F6CDD1DULL;
+    for (size_t i = 0; i < rodadas; i++) {
+        rng = avancarGeradorFuzz(rng);
+        ops[i] = (uint8_t)((rng >> 32) % LOTE_NUM_OPERACOES);
+    }
+
+    modoSilencioso = 1;
+    printf("=== VAZAO DOS MOTORES DE TROCA ===\n");
+    printf("Sessoes: %d  Rodadas: %zu\n\n", BENCH_SESSOES, rodadas);
+    printf("%-10s %12s %10s\n", "motor", "M ops/s", "x mestre");
+
+    double segundosMestre = 0;
+    int divergentes = 0;
+    for (int m = 0; m < NUM_MOTORES; m++) {
+#if !defined(__AVX2__)
+        if (m == MOTOR_LOTE_AVX2) {
+            printf("%-10s %12s\n", nomesMotores[m], "sem AVX2");
+            continue;
+        }
+#endif
+        uint64_t* final = finais + (size_t)m * BENCH_SESSOES;
+        double segundos = medirMotor((MotorFuzz)m, ops, rodadas, final);
+        if (m == MOTOR_MESTRE) {
+            segundosMestre = segundos;
+        } else if (memcmp(final, finais, sizeof(uint64_t) * BENCH_SESSOES) != 0) {
+            divergentes++;
+            printf("  %s terminou com tipos diferentes do mestre!\n", nomesMotores[m]);
+        }
+        printf("%-10s %12.1f %9.2fx\n", nomesMotores[m],
+               (double)rodadas * BENCH_SESSOES / segundos / 1e6, segundosMestre / segundos);
+    }
+
+    free(ops);
+    free(finais);
+    return divergentes != 0 ? 2 : 0;
+}
+
+#endif // FUZZ_TROCAS_LIBFUZZER
+
+// ============================================================================
+// PONTOS DE ENTRADA
+// ============================================================================
+
+#ifdef FUZZ_TROCAS_LIBFUZZER
+
+int LLVMFuzzerTestOneInput(const uint8_t* dados, size_t tamanho);
+
+int LLVMFuzzerTestOneInput(const uint8_t* dados, size_t tamanho) {
+    executarCaso(dados, tamanho);
+    return 0;
+}
+
+#else
+
+/**
+ * Lê um caso salvo e o executa
+ * @return 1 se o arquivo foi lido
+ */
+static int reproduzirCaso(const char* caminho) {
+    FILE* arquivo = fopen(caminho, "rb");
+    if (arquivo == NULL) {
+        return 0;
+    }
+    uint8_t dados[1 << 16];
+    size_t tamanho = fread(dados, 1, sizeof(dados), arquivo);
+    fclose(arquivo);
+    executarCaso(dados, tamanho);
+    return 1;
+}
+
+int main(int argc, char* argv[]) {
+    uint64_t casos = 200000, semente = 1;
+    size_t passos = 64;
+
+    if (argc >= 2 && strcmp(argv[1], "--bench") == 0) {
+        return executarBench(argc >= 3 ? strtoull(argv[2], NULL, 10) : 20000);
+    }
+    if (argc >= 2 && argv[1][0] != '-') {
+        for (int i = 1; i < argc; i++) {
+            if (!reproduzirCaso(argv[i])) {
+                fprintf(stderr, "Erro: nao foi possivel ler o caso '%s'.\n", argv[i]);
+                return 1;
+            }
+            printf("%s: sem divergencias\n", argv[i]);
+        }
+        return 0;
+    }
+    for (int i = 1; i < argc; i++) {
+        if (i + 1 < argc && strcmp(argv[i], "--casos") == 0) {
+            casos = strtoull(argv[++i], NULL, 10);
+        } else if (i + 1 < argc && strcmp(argv[i], "--passos") == 0) {
+            passos = strtoull(argv[++i], NULL, 10);
+        } else if (i + 1 < argc && strcmp(argv[i], "--semente") == 0) {
+            semente = strtoull(argv[++i], NULL, 10);
+        } else {
+            fprintf(stderr, "Uso: %s [--casos N] [--passos P] [--semente S] | --bench [RODADAS] | CASO...\n",
+                    argv[0]);
+            return 1;
+        }
+    }
+    if (passos > (1 << 16) - 8) {
+        passos = (1 << 16) - 8;
+    }
+
+    // Casos aleatórios: semente de 8 bytes seguida de um byte por passo
+    uint8_t* dados = malloc(8 + passos);
+    if (dados == NULL) {
+        fprintf(stderr, "Erro: memoria insuficiente.\n");
+        return 1;
+    }
+    uint64_t rng = semente != 0 ? semente : 1;
+    double inicio = agoraSegundos();
+    for (uint64_t c = 0; c < casos; c++) {
+        for (size_t i = 0; i < 8 + passos; i += 8) {
+            rng = avancarGeradorFuzz(rng);
+            for (size_t b = 0; b < 8 && i + b < 8 + passos; b++) {
+                dados[i + b] = (uint8_t)(rng >> (8 * b));
+            }
+        }
+        executarCaso(dados, 8 + passos);
+    }
+    double segundos = agoraSegundos() - inicio;
+
+    printf("=== FUZZING DIFERENCIAL DAS TROCAS ===\n");
+    printf("Casos: %llu  Passos por caso: %zu  Raias: %d  Lote: %s\n", (unsigned long long)casos, passos,
+           FUZZ_RAIAS, !FUZZ_COM_LOTE ? "desativado (capacidades)" :
+#if defined(__AVX2__)
+           "64 bits e AVX2"
+#else
+           "64 bits"
+#endif
+           );
+    printf("Passos verificados: %.0f (%.2f M passos/s)  Divergencias: 0\n",
+           (double)casos * (double)passos * FUZZ_RAIAS, (double)casos * (double)passos * FUZZ_RAIAS / segundos / 1e6);
+
+    free(dados);
+    return 0;
+}
+
+#endif // FUZZ_TROCAS_LIBFUZZER
@@ -0,0 +1,196 @@
+/*
+ * TETRIS STACK - GERADOR DE ARQUIVOS DE SEQUÊNCIA
+ *
+ * Gera um arquivo de sequência de peças (formato em sequencia.h) a partir de
+ * uma semente, em paralelo. A sequência é dividida em blocos de tamanho fixo,
+ * cada um com seu próprio gerador derivado de (semente, índice do bloco);
+ * assim o resultado é o mesmo para qualquer número de threads.
+ *
+ * Cada número de 64 bits sorteado fornece 32 peças de 2 bits, gravadas
+ * diretamente no arquivo mapeado em memória.
+ *
+ * Uso: gerador_sequencia ARQ NUM_PECAS SEMENTE [THREADS]
+ * Compilação: gcc -O2 gerador_sequencia.c -o gerador_sequencia -lpthread
+ */
+
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "sequencia.h"
+
+// ============================================================================
+// DEFINIÇÕES E ESTRUTURAS
+// ============================================================================
+
+#define PECAS_POR_BLOCO  (1u << 22)              // 4M peças = 1 MiB por bloco
+#define BYTES_POR_BLOCO  (PECAS_POR_BLOCO / 4)
+
+/**
+ * Trabalho compartilhado entre as threads geradoras
+ */
+typedef struct {
+    unsigned char* dados;       // Área de peças do arquivo mapeado
+    uint64_t numPecas;          // Total de peças
+    uint64_t numBlocos;         // Total de blocos
+    uint64_t semente;           // Semente da sequência
+    uint64_t proximoBloco;      // Próximo bloco a gerar (atômico)
+} TrabalhoGeracao;
+
+// ============================================================================
+// GERADOR PSEUDOALEATÓRIO
+// ============================================================================
+
+/**
+ * SplitMix64: usado para derivar o estado de cada bloco
+ * @param estado Estado do gerador (atualizado)
+ * @return Próximo valor de 64 bits
+ */
+static uint64_t splitmix64(uint64_t* estado) {
+    uint64_t z = (*estado += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+static inline uint64_t rotl(uint64_t x, int k) {
+    return (x << k) | (x >> (64 - k));
+}
+
+/**
+ * xoshiro256**: gerador rápido usado para as peças de cada bloco
+ * @param s Estado do gerador (4 palavras, atualizado)
+ * @return Próximo valor de 64 bits
+ */
+static inline uint64_t xoshiro256(uint64_t s[4]) {
+    uint64_t resultado = rotl(s[1] * 5, 7) * 9;
+    uint64_t t = s[1] << 17;
+    s[2] ^= s[0];
+    s[3] ^= s[1];
+    s[1] ^= s[2];
+    s[0] ^= s[3];
+    s[2] ^= t;
+    s[3] = rotl(s[3], 45);
+    return resultado;
+}
+
+// ============================================================================
+// GERAÇÃO EM PARALELO
+// ============================================================================
+
+/**
+ * Gera um bloco da sequência
+ * @param trabalho Trabalho compartilhado
+ * @param bloco Índice do bloco
+ */
+static void gerarBloco(TrabalhoGeracao* trabalho, uint64_t bloco) {
+    uint64_t estadoSemente = trabalho->semente ^ (bloco * 0xD1B54A32D192ED03ULL);
+    uint64_t s[4];
+    for (int i = 0; i < 4; i++) {
+        s[i] = splitmix64(&estadoSemente);
+    }
+
+    uint64_t inicio = bloco * PECAS_POR_BLOCO;
+    uint64_t pecas = trabalho->numPecas - inicio < PECAS_POR_BLOCO ?
+                     trabalho->numPecas - inicio : PECAS_POR_BLOCO;
+    uint64_t bytes = (pecas + 3) / 4;
+    unsigned char* destino = trabalho->dados + inicio / 4;
+
+    // 8 bytes (32 peças) por número sorteado
+    uint64_t i = 0;
+    for (; i + 8 <= bytes; i += 8) {
+        uint64_t valor = xoshiro256(s);
+        memcpy(destino + i, &valor, 8);
+    }
+    if (i < bytes) {
+        uint64_t valor = xoshiro256(s);
+        memcpy(destino + i, &valor, (size_t)(bytes - i));
+    }
+
+    // Zera os bits após a última peça para manter o arquivo determinístico
+    if (pecas % 4 != 0) {
+        destino[bytes - 1] &= (unsigned char)((1u << ((pecas % 4) * 2)) - 1);
+    }
+}
+
+/**
+ * Laço de cada thread: pega blocos até acabarem
+ * @param argumento Ponteiro para o trabalho compartilhado
+ * @return NULL
+ */
+static void* threadGeradora(void* argumento) {
+    TrabalhoGeracao* trabalho = argumento;
+    for (;;) {
+        uint64_t bloco = __atomic_fetch_add(&trabalho->proximoBloco, 1, __ATOMIC_RELAXED);
+        if (bloco >= trabalho->numBlocos) {
+            break;
+        }
+        gerarBloco(trabalho, bloco);
+    }
+    return NULL;
+}
+
+// ============================================================================
+// PROGRAMA PRINCIPAL
+// ============================================================================
+
+int main(int argc, char* argv[]) {
+    if (argc < 4 || argc > 5) {
+        fprintf(stderr, "Uso: %s ARQ NUM_PECAS SEMENTE [THREADS]\n", argv[0]);
+        return 1;
+    }
+
+    uint64_t numPecas = strtoull(argv[2], NULL, 10);
+    uint64_t semente = strtoull(argv[3], NULL, 10);
+    long numThreads = argc == 5 ? strtol(argv[4], NULL, 10) : sysconf(_SC_NPROCESSORS_ONLN);
+    if (numPecas == 0 || numThreads < 1) {
+        fprintf(stderr, "Erro: numero de pecas e de threads devem ser positivos.\n");
+        return 1;
+    }
+
+    // Cria o arquivo já com o tamanho final e o mapeia para escrita direta
+    uint64_t tamanho = tamanhoArquivoSequencia(numPecas);
+    int fd = open(argv[1], O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0 || ftruncate(fd, (off_t)tamanho) != 0) {
+        fprintf(stderr, "Erro: nao foi possivel criar '%s'.\n", argv[1]);
+        return 1;
+    }
+    unsigned char* mapa = mmap(NULL, (size_t)tamanho, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (mapa == MAP_FAILED) {
+        fprintf(stderr, "Erro: nao foi possivel mapear '%s'.\n", argv[1]);
+        return 1;
+    }
+    escreverCabecalhoSequencia(mapa, numPecas);
+
+    TrabalhoGeracao trabalho;
+    trabalho.dados = mapa + SEQUENCIA_TAM_CABECALHO;
+    trabalho.numPecas = numPecas;
+    trabalho.numBlocos = (numPecas + PECAS_POR_BLOCO - 1) / PECAS_POR_BLOCO;
+    trabalho.semente = semente;
+    trabalho.proximoBloco = 0;
+
+    struct timespec inicio, fim;
+    clock_gettime(CLOCK_MONOTONIC, &inicio);
+
+    pthread_t* threads = malloc(sizeof(pthread_t) * (size_t)numThreads);
+    for (long t = 0; t < numThreads; t++) {
+        pthread_create(&threads[t], NULL, threadGeradora, &trabalho);
+    }
+    for (long t = 0; t < numThreads; t++) {
+        pthread_join(threads[t], NULL);
+    }
+    free(threads);
+
+    msync(mapa, (size_t)tamanho, MS_SYNC);
+    munmap(mapa, (size_t)tamanho);
+
+    clock_gettime(CLOCK_MONOTONIC, &fim);
+    double segundos = (fim.tv_sec - inicio.tv_sec) + (fim.tv_nsec - inicio.tv_nsec) / 1e9;
+    printf("Sequencia gerada: %llu pecas em '%s' (%.1f MiB, %.3f s, %ld threads)\n",
+           (unsigned long long)numPecas, argv[1], tamanho / 1048576.0, segundos, numThreads);
+    return 0;
+}
@@ -0,0 +1,256 @@
+/*
+ * TETRIS STACK - OPERAÇÕES EM LOTE SOBRE MUITAS SESSÕES
+ *
+ * Kernels que aplicam a mesma operação (jogar, reservar, usar reserva,
+ * troca simples, troca múltipla) a muitas sessões de uma vez, com as regras
+ * do mestre.c para as capacidades padrão (fila de 5, pilha de 3).
+ *
+ * Cada sessão é guardada compactada em 64 bits, um byte por tipo de peça
+ * (1 = I, 2 = O, 3 = T, 4 = L, 0 = posição vazia):
+ *   bytes 0..4: fila, da frente para o final
+ *   bytes 5..7: pilha, do topo para a base
+ * Com a pilha alinhada pelo topo, todas as operações viram deslocamentos e
+ * permutações de bytes em posições fixas: com AVX2, um único shuffle trata
+ * 4 sessões, e as sessões cujas pré-condições falham são preservadas com
+ * máscaras (blend). Sem AVX2, usa a mesma lógica em registradores de 64 bits.
+ *
+ * Somente os tipos das peças são guardados; os ids não fazem parte do lote.
+ */
+
+#ifndef LOTE_H
+#define LOTE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+// ============================================================================
+// LAYOUT COMPACTADO
+// ============================================================================
+
+#define LOTE_FILA        5
+#define LOTE_PILHA       3
+
+#define LOTE_MASCARA_FILA    0x000000FFFFFFFFFFULL   // Bytes 0..4
+#define LOTE_MASCARA_FRENTE  0x00000000000000FFULL   // Byte 0 (frente da fila)
+#define LOTE_MASCARA_FINAL   0x000000FF00000000ULL   // Byte 4 (final da fila)
+#define LOTE_MASCARA_TOPO    0x0000FF0000000000ULL   // Byte 5 (topo da pilha)
+#define LOTE_MASCARA_BASE    0xFF00000000000000ULL   // Byte 7 (base da pilha cheia)
+
+/**
+ * Operações disponíveis no lote
+ */
+typedef enum {
+    LOTE_JOGAR,
+    LOTE_RESERVAR,
+    LOTE_USAR_RESERVA,
+    LOTE_TROCA_SIMPLES,
+    LOTE_TROCA_MULTIPLA,
+    LOTE_NUM_OPERACOES
+} OperacaoLote;
+
+/**
+ * Converte o tipo de uma peça ('I', 'O', 'T', 'L') no código do lote
+ * @param nome Tipo da peça
+ * @return Código 1..4 (0 para tipo desconhecido)
+ */
+static inline uint8_t codigoLote(char nome) {
+    switch (nome) {
+        case 'I': return 1;
+        case 'O': return 2;
+        case 'T': return 3;
+        case 'L': return 4;
+        default: return 0;
+    }
+}
+
+// ============================================================================
+// KERNEL ESCALAR (64 BITS)
+// ============================================================================
+
+/**
+ * Aplica uma operação a uma sessão compactada
+ * @param sessao Sessão compactada
+ * @param op Operação a aplicar
+ * @param nova Código da peça que entra no final da fila (jogar/reservar)
+ * @param ok Retorna 1 se a operação foi aplicada, 0 se a pré-condição falhou
+ * @return Sessão após a operação (inalterada em caso de falha)
+ */
+static inline uint64_t aplicarLote64(uint64_t sessao, OperacaoLote op, uint8_t nova, int* ok) {
+    uint64_t fila = sessao & LOTE_MASCARA_FILA;
+    uint64_t pilha = sessao >> 40;
+    uint64_t avancada = (fila >> 8) | ((uint64_t)nova << 32);  // Fila após um dequeue + enqueue
+
+    switch (op) {
+        case LOTE_JOGAR:
+            *ok = (sessao & LOTE_MASCARA_FRENTE) != 0;
+            return *ok ? (sessao & ~LOTE_MASCARA_FILA) | avancada : sessao;
+
+        case LOTE_RESERVAR:
+            *ok = (sessao & LOTE_MASCARA_FRENTE) != 0 && (sessao & LOTE_MASCARA_BASE) == 0;
+            return *ok ? avancada | ((((pilha << 8) | (fila & 0xFF)) & 0xFFFFFF) << 40) : sessao;
+
+        case LOTE_USAR_RESERVA:
+            *ok = (sessao & LOTE_MASCARA_TOPO) != 0;
+            return *ok ? fila | ((pilha >> 8) << 40) : sessao;
+
+        case LOTE_TROCA_SIMPLES:
+            *ok = (sessao & LOTE_MASCARA_FRENTE) != 0 && (sessao & LOTE_MASCARA_TOPO) != 0;
+            return *ok ? (sessao & 0xFFFF00FFFFFFFF00ULL) | ((sessao >> 40) & 0xFF) |
+                         ((sessao & 0xFF) << 40) : sessao;
+
+        case LOTE_TROCA_MULTIPLA:
+            // Frente da fila (bytes 0..2) <-> pilha do topo à base (bytes 5..7)
+            *ok = (sessao & LOTE_MASCARA_FINAL) != 0 && (sessao & LOTE_MASCARA_BASE) != 0;
+            return *ok ? (sessao & 0x000000FFFF000000ULL) | ((sessao & 0xFFFFFF) << 40) |
+                         (sessao >> 40) : sessao;
+
+        default:
+            *ok = 0;
+            return sessao;
+    }
+}
+
+/**
+ * Aplica uma operação a todas as sessões, uma por vez (64 bits)
+ * @param sessoes Sessões compactadas (atualizadas)
+ * @param novas Código da próxima peça de cada sessão (usado por jogar/reservar)
+ * @param resultados Se não for NULL, recebe 1/0 por sessão (aplicada/falhou)
+ * @param n Número de sessões
+ * @param op Operação a aplicar
+ * @return Número de sessões em que a operação foi aplicada
+ */
+static inline size_t aplicarLoteEscalar(uint64_t* sessoes, const uint8_t* novas, uint8_t* resultados,
+                                        size_t n, OperacaoLote op) {
+    size_t aplicadas = 0;
+    for (size_t i = 0; i < n; i++) {
+        int ok;
+        sessoes[i] = aplicarLote64(sessoes[i], op, novas[i], &ok);
+        if (resultados != NULL) {
+            resultados[i] = (uint8_t)ok;
+        }
+        aplicadas += (size_t)ok;
+    }
+    return aplicadas;
+}
+
+// ============================================================================
+// KERNEL AVX2 (4 SESSÕES POR REGISTRADOR)
+// ============================================================================
+
+#if defined(__AVX2__)
+
+/**
+ * Máscara de permutação repetida nas quatro sessões do registrador;
+ * -1 zera o byte de destino
+ */
+#define LOTE_SHUFFLE(b0, b1, b2, b3, b4, b5, b6, b7) \
+    _mm256_setr_epi8(b0, b1, b2, b3, b4, b5, b6, b7, \
+                     (b0) < 0 ? -1 : (b0) + 8, (b1) < 0 ? -1 : (b1) + 8, \
+                     (b2) < 0 ? -1 : (b2) + 8, (b3) < 0 ? -1 : (b3) + 8, \
+                     (b4) < 0 ? -1 : (b4) + 8, (b5) < 0 ? -1 : (b5) + 8, \
+                     (b6) < 0 ? -1 : (b6) + 8, (b7) < 0 ? -1 : (b7) + 8, \
+                     b0, b1, b2, b3, b4, b5, b6, b7, \
+                     (b0) < 0 ? -1 : (b0) + 8, (b1) < 0 ? -1 : (b1) + 8, \
+                     (b2) < 0 ? -1 : (b2) + 8, (b3) < 0 ? -1 : (b3) + 8, \
+                     (b4) < 0 ? -1 : (b4) + 8, (b5) < 0 ? -1 : (b5) + 8, \
+                     (b6) < 0 ? -1 : (b6) + 8, (b7) < 0 ? -1 : (b7) + 8)
+
+/**
+ * Máscara por sessão: todos os bits ligados onde o byte indicado é diferente de zero
+ */
+static inline __m256i loteByteOcupado(__m256i v, uint64_t mascaraByte) {
+    __m256i zero = _mm256_setzero_si256();
+    __m256i vazio = _mm256_cmpeq_epi64(_mm256_and_si256(v, _mm256_set1_epi64x((long long)mascaraByte)), zero);
+    return _mm256_xor_si256(vazio, _mm256_set1_epi64x(-1));
+}
+
+/**
+ * Aplica uma operação a todas as sessões com AVX2 (4 sessões por iteração)
+ * Mesma interface de aplicarLoteEscalar.
+ */
+static inline size_t aplicarLoteAVX2(uint64_t* sessoes, const uint8_t* novas, uint8_t* resultados,
+                                     size_t n, OperacaoLote op) {
+    __m256i permutacao, condicao;
+    size_t aplicadas = 0;
+    size_t i = 0;
+
+    // Permutação fixa de cada operação (índices de origem por byte de destino)
+    switch (op) {
+        case LOTE_JOGAR:          permutacao = LOTE_SHUFFLE(1, 2, 3, 4, -1, 5, 6, 7); break;
+        case LOTE_RESERVAR:       permutacao = LOTE_SHUFFLE(1, 2, 3, 4, -1, 0, 5, 6); break;
+        case LOTE_USAR_RESERVA:   permutacao = LOTE_SHUFFLE(0, 1, 2, 3, 4, 6, 7, -1); break;
+        case LOTE_TROCA_SIMPLES:  permutacao = LOTE_SHUFFLE(5, 1, 2, 3, 4, 0, 6, 7); break;
+        case LOTE_TROCA_MULTIPLA: permutacao = LOTE_SHUFFLE(5, 6, 7, 3, 4, 0, 1, 2); break;
+        default: return 0;
+    }
+
+    for (; i + 4 <= n; i += 4) {
+        __m256i v = _mm256_loadu_si256((const __m256i*)(sessoes + i));
+
+        switch (op) {
+            case LOTE_JOGAR:
+                condicao = loteByteOcupado(v, LOTE_MASCARA_FRENTE);
+                break;
+            case LOTE_RESERVAR:
+                condicao = _mm256_andnot_si256(loteByteOcupado(v, LOTE_MASCARA_BASE),
+                                               loteByteOcupado(v, LOTE_MASCARA_FRENTE));
+                break;
+            case LOTE_USAR_RESERVA:
+                condicao = loteByteOcupado(v, LOTE_MASCARA_TOPO);
+                break;
+            case LOTE_TROCA_SIMPLES:
+                condicao = _mm256_and_si256(loteByteOcupado(v, LOTE_MASCARA_FRENTE),
+                                            loteByteOcupado(v, LOTE_MASCARA_TOPO));
+                break;
+            default:
+                condicao = _mm256_and_si256(loteByteOcupado(v, LOTE_MASCARA_FINAL),
+                                            loteByteOcupado(v, LOTE_MASCARA_BASE));
+                break;
+        }
+
+        __m256i novo = _mm256_shuffle_epi8(v, permutacao);
+        if (op == LOTE_JOGAR || op == LOTE_RESERVAR) {
+            // Peça nova no byte 4 de cada sessão
+            uint32_t quatro;
+            __builtin_memcpy(&quatro, novas + i, 4);
+            __m256i pecas = _mm256_cvtepu8_epi64(_mm_cvtsi32_si128((int)quatro));
+            novo = _mm256_or_si256(novo, _mm256_slli_epi64(pecas, 32));
+        }
+
+        // Sessões com pré-condição falha ficam como estavam
+        _mm256_storeu_si256((__m256i*)(sessoes + i), _mm256_blendv_epi8(v, novo, condicao));
+
+        int bits = _mm256_movemask_pd(_mm256_castsi256_pd(condicao));
+        if (resultados != NULL) {
+            for (int k = 0; k < 4; k++) {
+                resultados[i + k] = (uint8_t)((bits >> k) & 1);
+            }
+        }
+        aplicadas += (size_t)__builtin_popcount((unsigned int)bits);
+    }
+
+    // Sessões restantes (n não múltiplo de 4)
+    return aplicadas + aplicarLoteEscalar(sessoes + i, novas + i,
+                                          resultados != NULL ? resultados + i : NULL, n - i, op);
+}
+
+#endif // __AVX2__
+
+/**
+ * Aplica uma operação a todas as sessões com o melhor kernel disponível
+ * Mesma interface de aplicarLoteEscalar.
+ */
+static inline size_t aplicarLote(uint64_t* sessoes, const uint8_t* novas, uint8_t* resultados,
+                                 size_t n, OperacaoLote op) {
+#if defined(__AVX2__)
+    return aplicarLoteAVX2(sessoes, novas, resultados, n, op);
+#else
+    return aplicarLoteEscalar(sessoes, novas, resultados, n, op);
+#endif
+}
+
+#endif // LOTE_H
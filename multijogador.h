@@ -0,0 +1,278 @@
+/*
+ * TETRIS STACK - PARTIDAS MULTIJOGADOR EM LOCKSTEP
+ *
+ * Dois ou mais jogadores disputam com a mesma semente (as mesmas peças e
+ * demandas de partida.h), cada um com sua fila e sua reserva. A simulação
+ * avança em ticks: a cada tick chega um lote com exatamente uma entrada por
+ * jogador (uma ação de partida.h ou MULTI_ESPERAR), todos os tabuleiros
+ * avançam e o estado completo é resumido em um hash de 64 bits. Réplicas que
+ * recebem os mesmos lotes produzem os mesmos hashes; o primeiro tick com
+ * hash diferente é o ponto de dessincronização.
+ *
+ * Regras sobre as de partida.h:
+ * - um turno tem até PARTIDA_ACOES_POR_TURNO ações (uma por tick); a última
+ *   precisa colocar uma peça, senão a frente da fila é jogada
+ * - colocar o tipo pedido (jogando a frente ou usando a reserva) vale um
+ *   ponto e envia uma linha de lixo ao próximo adversário vivo; colocações
+ *   certas seguidas a partir da terceira enviam duas
+ * - todo o lixo gerado em um tick é enviado ao mesmo tempo; o lixo que um
+ *   jogador recebe nesse tick é primeiro anulado, linha a linha, pelo que ele
+ *   próprio gerou no tick; o restante fica pendente e no tick seguinte custa
+ *   uma vida por linha
+ * - colocar outro tipo custa uma vida; sem vidas o jogador é eliminado
+ *
+ * O lixo de um tick só é somado e anulado depois que todos os tabuleiros
+ * avançaram, a partir do que cada um gerou no tick, então o resultado não
+ * depende da ordem (nem dos assentos) em que os jogadores são processados.
+ *
+ * Deve ser incluído depois de mestre.c e partida.h.
+ */
+
+#ifndef MULTIJOGADOR_H
+#define MULTIJOGADOR_H
+
+#include <stdint.h>
+#include <string.h>
+
+#ifndef MULTI_MAX_JOGADORES
+#define MULTI_MAX_JOGADORES     8
+#endif
+
+#define MULTI_ESPERAR           NUM_ACOES   // Entrada sem ação neste tick
+#define MULTI_MAX_TICKS         (PARTIDA_MAX_TURNOS * PARTIDA_ACOES_POR_TURNO)
+
+/**
+ * Entradas de todos os jogadores para um tick
+ */
+typedef struct {
+    uint32_t tick;
+    uint8_t acoes[MULTI_MAX_JOGADORES];     // AcaoPartida ou MULTI_ESPERAR
+} LoteTick;
+
+/**
+ * Jogador de uma partida multijogador
+ */
+typedef struct {
+    Partida partida;        // Fila, reserva, pontos, vidas e posição na sequência
+    int acoesNoTurno;       // Ações já feitas no turno atual
+    int sequencia;          // Colocações certas seguidas
+    int lixoPendente;       // Linhas recebidas, aplicadas no próximo tick
+    int lixoEnviado;        // Total de linhas enviadas
+    int ativo;              // 0 quando eliminado
+} JogadorMulti;
+
+/**
+ * Estado de uma partida multijogador
+ */
+typedef struct {
+    JogadorMulti jogadores[MULTI_MAX_JOGADORES];
+    int numJogadores;
+    int ativos;
+    uint32_t tick;
+    uint64_t hash;          // Hash do estado após o último tick
+} PartidaMulti;
+
+// ============================================================================
+// HASH DO ESTADO
+// ============================================================================
+
+/**
+ * Hash de 64 bits de todo o estado da partida (tick, filas da frente para o
+ * final, pilhas da base ao topo e contadores de cada jogador)
+ * @param multi Partida
+ * @return Hash do estado
+ */
+static inline uint64_t hashPartidaMulti(const PartidaMulti* multi) {
+    uint64_t h = misturar64(multi->tick ^ ((uint64_t)multi->numJogadores << 32));
+
+    for (int j = 0; j < multi->numJogadores; j++) {
+        const JogadorMulti* jogador = &multi->jogadores[j];
+        const Partida* p = &jogador->partida;
+
+        h = misturar64(h ^ (p->pecasGeradas << 8) ^ (uint64_t)(p->pilha.topo + 1));
+        for (int i = 0; i < p->fila.tamanho; i++) {
+            const Peca* peca = &p->fila.pecas[(p->fila.frente + i) % CAPACIDADE_FILA];
+            h = misturar64(h ^ ((uint64_t)(uint32_t)peca->id << 8) ^ (uint8_t)peca->nome);
+        }
+        for (int i = 0; i <= p->pilha.topo; i++) {
+            const Peca* peca = &p->pilha.pecas[i];
+            h = misturar64(h ^ ((uint64_t)(uint32_t)peca->id << 8) ^ (uint8_t)peca->nome);
+        }
+        h = misturar64(h ^ (uint64_t)(uint32_t)p->pontos ^ ((uint64_t)(uint32_t)p->vidas << 32));
+        h = misturar64(h ^ (uint64_t)(uint32_t)p->turno ^ ((uint64_t)(uint32_t)jogador->acoesNoTurno << 32));
+        h = misturar64(h ^ (uint64_t)(uint32_t)jogador->lixoPendente ^
+                       ((uint64_t)(uint32_t)jogador->sequencia << 32) ^ ((uint64_t)jogador->ativo << 63));
+    }
+    return h;
+}
+
+// ============================================================================
+// SIMULAÇÃO
+// ============================================================================
+
+/**
+ * Inicia uma partida: todos os jogadores com a mesma semente
+ * @param multi Partida a inicializar
+ * @param numJogadores Número de jogadores (2 a MULTI_MAX_JOGADORES)
+ * @param semente Semente das peças e demandas
+ */
+static inline void iniciarPartidaMulti(PartidaMulti* multi, int numJogadores, uint64_t semente) {
+    memset(multi, 0, sizeof(*multi));
+    multi->numJogadores = numJogadores;
+    multi->ativos = numJogadores;
+    for (int j = 0; j < numJogadores; j++) {
+        iniciarPartida(&multi->jogadores[j].partida, semente);
+        multi->jogadores[j].ativo = 1;
+    }
+    multi->hash = hashPartidaMulti(multi);
+}
+
+/**
+ * Indica se a partida acabou (no máximo um jogador vivo ou limite de ticks)
+ */
+static inline int partidaMultiTerminou(const PartidaMulti* multi) {
+    return multi->ativos <= 1 || multi->tick >= MULTI_MAX_TICKS;
+}
+
+/**
+ * Demanda atual de um jogador (o tipo pedido no seu turno)
+ */
+static inline char demandaJogadorMulti(const PartidaMulti* multi, int j) {
+    const Partida* p = &multi->jogadores[j].partida;
+    return demandaPartida(p->semente, p->turno);
+}
+
+/**
+ * Próximo adversário vivo depois de j (alvo do lixo de j); -1 se não houver
+ */
+static inline int alvoLixoMulti(const PartidaMulti* multi, int j) {
+    for (int d = 1; d < multi->numJogadores; d++) {
+        int alvo = (j + d) % multi->numJogadores;
+        if (multi->jogadores[alvo].ativo) {
+            return alvo;
+        }
+    }
+    return -1;
+}
+
+/**
+ * Aplica a entrada de um jogador no próprio tabuleiro
+ * @return Linhas de lixo geradas pela entrada
+ */
+static inline int aplicarEntradaMulti(JogadorMulti* jogador, unsigned entrada) {
+    Partida* p = &jogador->partida;
+    if (entrada >= NUM_ACOES) {
+        return 0;   // MULTI_ESPERAR (ou entrada inválida): nada acontece
+    }
+
+    AcaoPartida acao = (AcaoPartida)entrada;
+    if (jogador->acoesNoTurno == PARTIDA_ACOES_POR_TURNO - 1 && !acaoColocaPeca(acao)) {
+        acao = ACAO_JOGAR;  // Última ação do turno precisa colocar uma peça
+    }
+
+    Peca colocada = {0, -1};
+    int aplicou = aplicarAcaoPartida(p, acao, &colocada);
+    jogador->acoesNoTurno++;
+    if (!(aplicou && acaoColocaPeca(acao))) {
+        if (jogador->acoesNoTurno < PARTIDA_ACOES_POR_TURNO) {
+            return 0;
+        }
+        aplicarAcaoPartida(p, ACAO_JOGAR, &colocada);
+    }
+
+    // Turno encerrado: avalia a peça colocada
+    int lixo = 0;
+    if (colocada.nome == demandaPartida(p->semente, p->turno)) {
+        p->pontos++;
+        jogador->sequencia++;
+        lixo = jogador->sequencia >= 3 ? 2 : 1;
+    } else {
+        p->vidas--;
+        jogador->sequencia = 0;
+    }
+    p->turno++;
+    jogador->acoesNoTurno = 0;
+    return lixo;
+}
+
+/**
+ * Avança um tick: aplica o lixo pendente, as entradas do lote em todos os
+ * tabuleiros e então entrega o lixo gerado, já descontado o que cada jogador
+ * gerou no tick
+ * @param multi Partida em andamento
+ * @param lote Entradas de todos os jogadores (lote->tick deve ser multi->tick)
+ * @return Hash do estado após o tick
+ */
+static inline uint64_t avancarTickMulti(PartidaMulti* multi, const LoteTick* lote) {
+    int gerado[MULTI_MAX_JOGADORES];
+    int recebido[MULTI_MAX_JOGADORES] = {0};
+
+    for (int j = 0; j < multi->numJogadores; j++) {
+        JogadorMulti* jogador = &multi->jogadores[j];
+        gerado[j] = 0;
+        if (!jogador->ativo) {
+            continue;
+        }
+
+        // Lixo recebido no tick anterior
+        jogador->partida.vidas -= jogador->lixoPendente;
+        jogador->lixoPendente = 0;
+
+        if (jogador->partida.vidas > 0) {
+            gerado[j] = aplicarEntradaMulti(jogador, lote->acoes[j]);
+        }
+    }
+
+    // Eliminações e entrega do lixo (depois de todos os tabuleiros avançarem)
+    for (int j = 0; j < multi->numJogadores; j++) {
+        JogadorMulti* jogador = &multi->jogadores[j];
+        if (jogador->ativo && jogador->partida.vidas <= 0) {
+            jogador->ativo = 0;
+            multi->ativos--;
+        }
+    }
+    // Soma o que cada um recebe neste tick, só a partir do que foi gerado
+    for (int j = 0; j < multi->numJogadores; j++) {
+        int alvo = gerado[j] > 0 ? alvoLixoMulti(multi, j) : -1;
+        if (alvo >= 0) {
+            recebido[alvo] += gerado[j];
+            multi->jogadores[j].lixoEnviado += gerado[j];
+        }
+    }
+    // O que cada um gerou anula o que recebeu; só o restante fica pendente
+    for (int j = 0; j < multi->numJogadores; j++) {
+        int cancelado = gerado[j] < recebido[j] ? gerado[j] : recebido[j];
+        multi->jogadores[j].lixoPendente += recebido[j] - cancelado;
+    }
+
+    multi->tick++;
+    multi->hash = hashPartidaMulti(multi);
+    return multi->hash;
+}
+
+/**
+ * Vencedor: o último vivo ou, no limite de ticks, o de mais pontos entre os
+ * vivos (empate: mais vidas, depois o menor índice)
+ * @return Índice do vencedor, ou -1 se todos foram eliminados
+ */
+static inline int vencedorPartidaMulti(const PartidaMulti* multi) {
+    int vencedor = -1;
+    if (multi->ativos == 0) {
+        return vencedor; // Eliminados no mesmo tick: empate, sem vencedor
+    }
+    for (int j = 0; j < multi->numJogadores; j++) {
+        const JogadorMulti* jogador = &multi->jogadores[j];
+        if (!jogador->ativo) {
+            continue;
+        }
+        if (vencedor < 0 ||
+            jogador->partida.pontos > multi->jogadores[vencedor].partida.pontos ||
+            (jogador->partida.pontos == multi->jogadores[vencedor].partida.pontos &&
+             jogador->partida.vidas > multi->jogadores[vencedor].partida.vidas)) {
+            vencedor = j;
+        }
+    }
+    return vencedor;
+}
+
+#endif // MULTIJOGADOR_H
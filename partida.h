@@ -0,0 +1,235 @@
+/*
+ * TETRIS STACK - REGRAS DE PARTIDA PARA COMPARAR POLÍTICAS
+ *
+ * Transforma as operações do mestre.c em um jogo com placar, para que
+ * políticas de reserva/troca possam ser comparadas automaticamente:
+ * - a cada turno o tabuleiro pede um tipo de peça (a "demanda")
+ * - a política pode fazer até PARTIDA_ACOES_POR_TURNO - 1 ações de preparo
+ *   (reservar, troca simples, troca múltipla) e então coloca uma peça
+ *   (jogar a frente da fila ou usar o topo da reserva)
+ * - colocar o tipo pedido vale 1 ponto; colocar outro tipo custa uma vida
+ * - a partida termina sem vidas ou após o limite de turnos
+ *
+ * As peças e as demandas vêm de funções da semente e da posição (e não de
+ * rand()), então todas as políticas enfrentam exatamente a mesma sequência
+ * e várias partidas podem rodar em paralelo.
+ *
+ * Deve ser incluído depois de mestre.c (usa FilaPecas, PilhaReserva e as
+ * operações de fila, pilha e troca).
+ */
+
+#ifndef PARTIDA_H
+#define PARTIDA_H
+
+#include <stdint.h>
+
+#define PARTIDA_VIDAS            10
+#define PARTIDA_ACOES_POR_TURNO  3      // Até 2 ações de preparo + 1 que coloca a peça
+
+#ifndef PARTIDA_MAX_TURNOS
+#define PARTIDA_MAX_TURNOS       1000   // Configurável na compilação
+#endif
+
+/**
+ * Ações disponíveis em um turno (mesmas operações do menu do mestre.c)
+ */
+typedef enum {
+    ACAO_JOGAR,
+    ACAO_RESERVAR,
+    ACAO_USAR_RESERVA,
+    ACAO_TROCA_SIMPLES,
+    ACAO_TROCA_MULTIPLA,
+    NUM_ACOES
+} AcaoPartida;
+
+/**
+ * Estado de uma partida
+ */
+typedef struct {
+    FilaPecas fila;
+    PilhaReserva pilha;
+    uint64_t semente;       // Define as peças e as demandas
+    uint64_t pecasGeradas;  // Posição da próxima peça na sequência
+    int turno;              // Turnos já jogados
+    int pontos;             // Peças colocadas com o tipo pedido
+    int vidas;              // Vidas restantes
+} Partida;
+
+/**
+ * Política: escolhe a próxima ação do turno
+ * @param partida Estado atual (somente leitura)
+ * @param demanda Tipo de peça pedido neste turno
+ * @param acoesRestantes Ações que ainda cabem no turno (a última precisa colocar)
+ * @param rng Estado de um gerador da partida, para políticas aleatórias
+ * @return Ação escolhida
+ */
+typedef AcaoPartida (*PoliticaPartida)(const Partida* partida, char demanda, int acoesRestantes, uint64_t* rng);
+
+static const char tiposPartida[4] = {'I', 'O', 'T', 'L'};
+
+// ============================================================================
+// SEQUÊNCIAS DE PEÇAS E DEMANDAS
+// ============================================================================
+
+/**
+ * Mistura de 64 bits (finalizador do SplitMix64)
+ */
+static inline uint64_t misturar64(uint64_t x) {
+    x += 0x9E3779B97F4A7C15ULL;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+    return x ^ (x >> 31);
+}
+
+/**
+ * Tipo da peça em uma posição da sequência da partida
+ * @param semente Semente da partida
+ * @param posicao Posição da peça
+ * @return Tipo da peça ('I', 'O', 'T', 'L')
+ */
+static inline char tipoPecaPartida(uint64_t semente, uint64_t posicao) {
+    return tiposPartida[misturar64(misturar64(semente) ^ posicao) >> 62];
+}
+
+/**
+ * Tipo pedido em um turno da partida
+ * @param semente Semente da partida
+ * @param turno Número do turno
+ * @return Tipo pedido ('I', 'O', 'T', 'L')
+ */
+static inline char demandaPartida(uint64_t semente, int turno) {
+    return tiposPartida[misturar64(misturar64(~semente) ^ (uint64_t)turno) >> 62];
+}
+
+/**
+ * Gera a próxima peça da partida (equivalente ao gerarPeca do mestre.c)
+ * @param partida Partida em andamento
+ * @return Nova peça; o id é a posição na sequência
+ */
+static inline Peca gerarPecaPartida(Partida* partida) {
+    Peca peca;
+    peca.nome = tipoPecaPartida(partida->semente, partida->pecasGeradas);
+    peca.id = (int)partida->pecasGeradas++;
+    return peca;
+}
+
+// ============================================================================
+// AÇÕES E TURNOS
+// ============================================================================
+
+/**
+ * Inicia uma partida com a fila cheia e a reserva vazia
+ * @param partida Partida a inicializar
+ * @param semente Semente das peças e demandas
+ */
+static inline void iniciarPartida(Partida* partida, uint64_t semente) {
+    partida->semente = semente;
+    partida->pecasGeradas = 0;
+    partida->turno = 0;
+    partida->pontos = 0;
+    partida->vidas = PARTIDA_VIDAS;
+
+    partida->fila.frente = 0;
+    partida->fila.tras = 0;
+    partida->fila.tamanho = 0;
+    inicializarPilha(&partida->pilha);
+    for (int i = 0; i < CAPACIDADE_FILA; i++) {
+        enqueueFila(&partida->fila, gerarPecaPartida(partida));
+    }
+}
+
+/**
+ * Indica se a ação coloca uma peça no tabuleiro (encerrando o turno)
+ */
+static inline int acaoColocaPeca(AcaoPartida acao) {
+    return acao == ACAO_JOGAR || acao == ACAO_USAR_RESERVA;
+}
+
+/**
+ * Tipo da peça na posição i da fila (0 = frente)
+ */
+static inline char tipoNaFila(const Partida* partida, int i) {
+    return partida->fila.pecas[(partida->fila.frente + i) % CAPACIDADE_FILA].nome;
+}
+
+/**
+ * Tipo da peça na posição i da pilha (0 = topo); 0 se não houver
+ */
+static inline char tipoNaPilha(const Partida* partida, int i) {
+    return i <= partida->pilha.topo ? partida->pilha.pecas[partida->pilha.topo - i].nome : 0;
+}
+
+/**
+ * Aplica uma ação com as regras do mestre.c (jogar e reservar repõem a fila)
+ * @param partida Partida em andamento
+ * @param acao Ação a aplicar
+ * @param colocada Recebe a peça colocada, se a ação colocar uma
+ * @return 1 se a ação foi aplicada, 0 se a pré-condição falhou
+ */
+static inline int aplicarAcaoPartida(Partida* partida, AcaoPartida acao, Peca* colocada) {
+    Peca peca;
+
+    switch (acao) {
+        case ACAO_JOGAR:
+            if (!dequeueFila(&partida->fila, colocada)) {
+                return 0;
+            }
+            enqueueFila(&partida->fila, gerarPecaPartida(partida));
+            return 1;
+
+        case ACAO_RESERVAR:
+            if (pilhaCheia(&partida->pilha) || !dequeueFila(&partida->fila, &peca)) {
+                return 0;
+            }
+            pushPilha(&partida->pilha, peca);
+            enqueueFila(&partida->fila, gerarPecaPartida(partida));
+            return 1;
+
+        case ACAO_USAR_RESERVA:
+            return popPilha(&partida->pilha, colocada);
+
+        case ACAO_TROCA_SIMPLES:
+            return trocarSimples(&partida->fila, &partida->pilha);
+
+        case ACAO_TROCA_MULTIPLA:
+            return trocarMultipla(&partida->fila, &partida->pilha);
+
+        default:
+            return 0;
+    }
+}
+
+/**
+ * Joga um turno: consulta a política até uma peça ser colocada.
+ * Se as ações acabarem sem colocar, a frente da fila é jogada.
+ * @param partida Partida em andamento
+ * @param politica Política que escolhe as ações
+ * @param rng Gerador da partida, repassado à política
+ * @return 1 se a partida continua, 0 se terminou
+ */
+static inline int jogarTurnoPartida(Partida* partida, PoliticaPartida politica, uint64_t* rng) {
+    char demanda = demandaPartida(partida->semente, partida->turno);
+    Peca colocada;
+    int colocou = 0;
+
+    for (int acoes = PARTIDA_ACOES_POR_TURNO; acoes > 0 && !colocou; acoes--) {
+        AcaoPartida acao = politica(partida, demanda, acoes, rng);
+        if (acoes == 1 && !acaoColocaPeca(acao)) {
+            acao = ACAO_JOGAR;
+        }
+        colocou = aplicarAcaoPartida(partida, acao, &colocada) && acaoColocaPeca(acao);
+    }
+    if (!colocou) {
+        aplicarAcaoPartida(partida, ACAO_JOGAR, &colocada);
+    }
+
+    if (colocada.nome == demanda) {
+        partida->pontos++;
+    } else {
+        partida->vidas--;
+    }
+    partida->turno++;
+    return partida->vidas > 0 && partida->turno < PARTIDA_MAX_TURNOS;
+}
+
+#endif // PARTIDA_H
@@ -0,0 +1,366 @@
+/*
+ * TETRIS STACK - RASTREAMENTO DAS FASES DO LAÇO
+ *
+ * Marca o início e o fim de cada fase de uma iteração do laço principal
+ * (entrada, despacho da operação, geração de peça, desenho, publicação)
+ * com o contador de ciclos (TSC), em um anel por thread: só a thread dona
+ * escreve no seu anel, sem travas nem chamadas de sistema. Cada marca custa
+ * uma leitura do TSC e uma escrita de 16 bytes.
+ *
+ * Ao sair, os anéis de todas as threads são exportados em dois formatos:
+ * - PREFIXO.json: traço do Chrome (abrir em chrome://tracing ou Perfetto)
+ * - PREFIXO.folded: pilhas dobradas com o tempo próprio de cada pilha em
+ *   nanossegundos (flamegraph.pl PREFIXO.folded > chama.svg, ou speedscope)
+ *
+ * Tudo é desativado por padrão: sem -DTETRIS_RASTREAMENTO as macros RAST_*
+ * expandem para nada e nenhum código de rastreamento entra no binário.
+ *
+ * Com o rastreamento ativo:
+ * - TETRIS_RASTREAMENTO_SAIDA=prefixo escolhe os arquivos (padrão: rastreamento)
+ * - cada anel guarda os últimos RAST_EVENTOS_POR_THREAD eventos da thread
+ *   (configurável na compilação; potência de 2)
+ */
+
+#ifndef RASTREAMENTO_H
+#define RASTREAMENTO_H
+
+// ============================================================================
+// FASES RASTREADAS
+// ============================================================================
+
+typedef enum {
+    RAST_ITERACAO,      // Uma iteração completa do laço principal
+    RAST_ENTRADA,       // Leitura e interpretação da entrada do jogador
+    RAST_DESPACHO,      // Execução da operação escolhida
+    RAST_GERACAO,       // Geração de uma nova peça
+    RAST_ATUALIZACAO,   // Passos fixos do modo tempo real (gravidade)
+    RAST_DESENHO,       // Estado, menu ou quadro do modo tempo real
+    RAST_PUBLICACAO,    // Publicação do estado para os espectadores
+    RAST_NUM_FASES
+} FaseRastreamento;
+
+#ifdef TETRIS_RASTREAMENTO
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+#ifndef RAST_EVENTOS_POR_THREAD
+#define RAST_EVENTOS_POR_THREAD (1 << 16)
+#endif
+
+_Static_assert((RAST_EVENTOS_POR_THREAD & (RAST_EVENTOS_POR_THREAD - 1)) == 0,
+               "RAST_EVENTOS_POR_THREAD deve ser potencia de 2");
+
+#define RAST_PROFUNDIDADE_MAX   15      // Fases aninhadas (4 bits por nível na chave da pilha)
+#define RAST_PILHAS_MAX         1024    // Pilhas distintas no arquivo dobrado
+
+/**
+ * Marca de início ou fim de uma fase
+ */
+typedef struct {
+    uint64_t ciclos;
+    uint32_t fase;
+    uint32_t fim;       // 0 = início, 1 = fim
+} MarcaRastreamento;
+
+/**
+ * Anel de marcas de uma thread. Só a thread dona escreve; a exportação lê
+ * as últimas RAST_EVENTOS_POR_THREAD marcas a partir de "escritas".
+ */
+typedef struct AnelRastreamento {
+    MarcaRastreamento marcas[RAST_EVENTOS_POR_THREAD];
+    uint64_t escritas;
+    uint32_t numero;                    // Ordem de criação (tid no traço)
+    struct AnelRastreamento* proximo;
+} AnelRastreamento;
+
+static const char* nomesFasesRast[RAST_NUM_FASES] = {
+    "iteracao", "entrada", "despacho", "geracao", "atualizacao", "desenho", "publicacao"
+};
+
+// Lista global (somente inserção) com os anéis de todas as threads
+static AnelRastreamento* aneisRast = NULL;
+static _Thread_local AnelRastreamento* anelRastLocal = NULL;
+static uint32_t numAneisRast = 0;
+
+// Referência de calibração do TSC, tomada em rastInstalar()
+static uint64_t rastCiclosInicio;
+static uint64_t rastNsInicio;
+
+// ============================================================================
+// COLETA
+// ============================================================================
+
+/**
+ * Lê o contador de ciclos do processador (TSC em x86, relógio monotônico
+ * em nanossegundos nas demais arquiteturas)
+ * @return Valor atual do contador
+ */
+static inline uint64_t rastCiclos(void) {
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+#endif
+}
+
+static uint64_t rastNs(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+/**
+ * Cria o anel da thread atual (fora do caminho quente)
+ * @return Ponteiro para o anel da thread
+ */
+static __attribute__((noinline)) AnelRastreamento* rastCriarAnel(void) {
+    AnelRastreamento* anel = calloc(1, sizeof(AnelRastreamento));
+    if (anel == NULL) {
+        abort();
+    }
+    anel->numero = __atomic_fetch_add(&numAneisRast, 1, __ATOMIC_RELAXED) + 1;
+
+    // Insere na lista global sem travas
+    anel->proximo = __atomic_load_n(&aneisRast, __ATOMIC_RELAXED);
+    while (!__atomic_compare_exchange_n(&aneisRast, &anel->proximo, anel, 0,
+                                        __ATOMIC_RELEASE, __ATOMIC_RELAXED)) {
+    }
+    anelRastLocal = anel;
+    return anel;
+}
+
+/**
+ * Registra o início ou o fim de uma fase no anel da thread atual
+ * @param fase Fase marcada
+ * @param fim 0 no início da fase, 1 no fim
+ */
+static inline void rastMarcar(FaseRastreamento fase, uint32_t fim) {
+    AnelRastreamento* anel = anelRastLocal;
+    if (__builtin_expect(anel == NULL, 0)) {
+        anel = rastCriarAnel();
+    }
+    uint64_t n = anel->escritas;
+    MarcaRastreamento* marca = &anel->marcas[n & (RAST_EVENTOS_POR_THREAD - 1)];
+    marca->ciclos = rastCiclos();
+    marca->fase = (uint32_t)fase;
+    marca->fim = fim;
+    __atomic_store_n(&anel->escritas, n + 1, __ATOMIC_RELEASE);
+}
+
+// ============================================================================
+// EXPORTAÇÃO (TRAÇO DO CHROME E PILHAS DOBRADAS)
+// ============================================================================
+
+/**
+ * Tempo próprio acumulado de uma pilha de fases. A chave guarda uma fase
+ * por nível (4 bits, fase + 1), da raiz para o topo.
+ */
+typedef struct {
+    uint64_t chave;
+    uint64_t ciclos;
+} PilhaDobradaRast;
+
+/**
+ * Fase aberta durante a reconstrução das pilhas
+ */
+typedef struct {
+    uint32_t fase;
+    uint64_t inicio;
+    uint64_t filhos;    // Ciclos gastos em fases filhas
+    uint64_t chave;
+} AbertaRast;
+
+static void rastAcumularPilha(PilhaDobradaRast* pilhas, uint64_t chave, uint64_t ciclos) {
+    uint64_t h = chave * 0x9E3779B97F4A7C15ull;
+    for (uint32_t i = 0; i < RAST_PILHAS_MAX; i++) {
+        PilhaDobradaRast* p = &pilhas[(h + i) & (RAST_PILHAS_MAX - 1)];
+        if (p->chave == chave || p->chave == 0) {
+            p->chave = chave;
+            p->ciclos += ciclos;
+            return;
+        }
+    }
+}
+
+/**
+ * Escreve uma marca no traço do Chrome
+ */
+static void rastJsonMarca(FILE* json, int* primeira, const char* fase, char tipo,
+                          uint64_t ciclos, uint64_t base, double ciclosPorUs,
+                          long pid, uint32_t tid) {
+    fprintf(json, "%s\n{\"name\":\"%s\",\"ph\":\"%c\",\"ts\":%.3f,\"pid\":%ld,\"tid\":%u}",
+            *primeira ? "" : ",", fase, tipo, (double)(ciclos - base) / ciclosPorUs, pid, tid);
+    *primeira = 0;
+}
+
+/**
+ * Reconstrói as fases de um anel: grava as marcas casadas no traço do
+ * Chrome e acumula o tempo próprio de cada pilha. Marcas de fim sem início
+ * (perdido na volta do anel) são ignoradas; fases ainda abertas são
+ * fechadas na última marca do anel.
+ */
+static void rastExportarAnel(AnelRastreamento* anel, FILE* json, int* primeira,
+                             PilhaDobradaRast* pilhas, uint64_t base, double ciclosPorUs, long pid) {
+    uint64_t escritas = __atomic_load_n(&anel->escritas, __ATOMIC_ACQUIRE);
+    uint64_t primeiro = escritas > RAST_EVENTOS_POR_THREAD ? escritas - RAST_EVENTOS_POR_THREAD : 0;
+    AbertaRast abertas[RAST_PROFUNDIDADE_MAX];
+    int profundidade = 0;
+    uint64_t ultimo = base;
+
+    for (uint64_t n = primeiro; n < escritas; n++) {
+        const MarcaRastreamento* marca = &anel->marcas[n & (RAST_EVENTOS_POR_THREAD - 1)];
+        if (marca->fase >= RAST_NUM_FASES) {
+            continue;
+        }
+        ultimo = marca->ciclos;
+        if (!marca->fim) {
+            if (profundidade == RAST_PROFUNDIDADE_MAX) {
+                continue;
+            }
+            AbertaRast* aberta = &abertas[profundidade];
+            aberta->fase = marca->fase;
+            aberta->inicio = marca->ciclos;
+            aberta->filhos = 0;
+            aberta->chave = (profundidade > 0 ? abertas[profundidade - 1].chave << 4 : 0) | (marca->fase + 1);
+            profundidade++;
+            rastJsonMarca(json, primeira, nomesFasesRast[marca->fase], 'B', marca->ciclos,
+                          base, ciclosPorUs, pid, anel->numero);
+        } else if (profundidade > 0 && abertas[profundidade - 1].fase == marca->fase) {
+            AbertaRast* aberta = &abertas[--profundidade];
+            uint64_t total = marca->ciclos - aberta->inicio;
+            rastAcumularPilha(pilhas, aberta->chave, total - aberta->filhos);
+            if (profundidade > 0) {
+                abertas[profundidade - 1].filhos += total;
+            }
+            rastJsonMarca(json, primeira, nomesFasesRast[marca->fase], 'E', marca->ciclos,
+                          base, ciclosPorUs, pid, anel->numero);
+        }
+    }
+
+    while (profundidade > 0) {
+        AbertaRast* aberta = &abertas[--profundidade];
+        uint64_t total = ultimo - aberta->inicio;
+        rastAcumularPilha(pilhas, aberta->chave, total - aberta->filhos);
+        if (profundidade > 0) {
+            abertas[profundidade - 1].filhos += total;
+        }
+        rastJsonMarca(json, primeira, nomesFasesRast[aberta->fase], 'E', ultimo,
+                      base, ciclosPorUs, pid, anel->numero);
+    }
+}
+
+/**
+ * Exporta os anéis de todas as threads (chamada ao sair do programa)
+ */
+static void rastExportar(void) {
+    const char* prefixo = getenv("TETRIS_RASTREAMENTO_SAIDA");
+    if (prefixo == NULL || prefixo[0] == '\0') {
+        prefixo = "rastreamento";
+    }
+
+    // Calibração: ciclos do TSC por microssegundo desde rastInstalar()
+    // (com pelo menos 10 ms de intervalo)
+    uint64_t ns;
+    while ((ns = rastNs()) - rastNsInicio < 10000000ull) {
+    }
+    double ciclosPorUs = (double)(rastCiclos() - rastCiclosInicio) * 1000.0 / (double)(ns - rastNsInicio);
+
+    // Base de tempo: a marca mais antiga ainda presente nos anéis
+    uint64_t base = UINT64_MAX;
+    for (AnelRastreamento* a = __atomic_load_n(&aneisRast, __ATOMIC_ACQUIRE); a != NULL; a = a->proximo) {
+        uint64_t escritas = __atomic_load_n(&a->escritas, __ATOMIC_ACQUIRE);
+        if (escritas > 0) {
+            uint64_t primeiro = escritas > RAST_EVENTOS_POR_THREAD ? escritas - RAST_EVENTOS_POR_THREAD : 0;
+            uint64_t ciclos = a->marcas[primeiro & (RAST_EVENTOS_POR_THREAD - 1)].ciclos;
+            base = ciclos < base ? ciclos : base;
+        }
+    }
+    if (base == UINT64_MAX) {
+        return;
+    }
+
+    char caminho[4096];
+    snprintf(caminho, sizeof(caminho), "%s.json", prefixo);
+    FILE* json = fopen(caminho, "w");
+    PilhaDobradaRast* pilhas = calloc(RAST_PILHAS_MAX, sizeof(PilhaDobradaRast));
+    if (json == NULL || pilhas == NULL) {
+        fprintf(stderr, "Erro: nao foi possivel gravar o rastreamento em '%s'.\n", caminho);
+        if (json != NULL) {
+            fclose(json);
+        }
+        free(pilhas);
+        return;
+    }
+
+    long pid = (long)getpid();
+    int primeira = 1;
+    fprintf(json, "{\"displayTimeUnit\":\"ns\",\"otherData\":{\"ciclos_por_us\":%.3f},\"traceEvents\":[",
+            ciclosPorUs);
+    for (AnelRastreamento* a = __atomic_load_n(&aneisRast, __ATOMIC_ACQUIRE); a != NULL; a = a->proximo) {
+        rastExportarAnel(a, json, &primeira, pilhas, base, ciclosPorUs, pid);
+    }
+    fprintf(json, "\n]}\n");
+    fclose(json);
+
+    // Pilhas dobradas: "tetris;fase;subfase nanossegundos"
+    snprintf(caminho, sizeof(caminho), "%s.folded", prefixo);
+    FILE* dobradas = fopen(caminho, "w");
+    if (dobradas == NULL) {
+        fprintf(stderr, "Erro: nao foi possivel gravar o rastreamento em '%s'.\n", caminho);
+        free(pilhas);
+        return;
+    }
+    for (uint32_t i = 0; i < RAST_PILHAS_MAX; i++) {
+        if (pilhas[i].chave == 0) {
+            continue;
+        }
+        uint32_t fases[RAST_PROFUNDIDADE_MAX];
+        int niveis = 0;
+        for (uint64_t chave = pilhas[i].chave; chave != 0; chave >>= 4) {
+            fases[niveis++] = (uint32_t)(chave & 0xF) - 1;
+        }
+        fprintf(dobradas, "tetris");
+        while (niveis > 0) {
+            fprintf(dobradas, ";%s", nomesFasesRast[fases[--niveis]]);
+        }
+        fprintf(dobradas, " %llu\n", (unsigned long long)((double)pilhas[i].ciclos * 1000.0 / ciclosPorUs));
+    }
+    fclose(dobradas);
+    free(pilhas);
+}
+
+/**
+ * Toma a referência de calibração do TSC e agenda a exportação ao sair.
+ * Deve ser chamada uma vez no início do programa.
+ */
+static void rastInstalar(void) {
+    rastNsInicio = rastNs();
+    rastCiclosInicio = rastCiclos();
+    atexit(rastExportar);
+}
+
+#define RAST_INSTALAR()           rastInstalar()
+#define RAST_INICIO(fase)         rastMarcar((fase), 0)
+#define RAST_FIM(fase)            rastMarcar((fase), 1)
+
+#else
+
+// Rastreamento desativado: nenhuma instrução é gerada
+#define RAST_INSTALAR()           ((void)0)
+#define RAST_INICIO(fase)         ((void)0)
+#define RAST_FIM(fase)            ((void)0)
+
+#endif // TETRIS_RASTREAMENTO
+
+#endif // RASTREAMENTO_H
@@ -0,0 +1,135 @@
+/*
+ * TETRIS STACK - ARQUIVOS DE SEQUÊNCIA DE PEÇAS
+ *
+ * Sequências de peças pré-geradas, lidas com mmap para que todos os
+ * participantes (e vários processos ao mesmo tempo, via cache de páginas)
+ * vejam exatamente as mesmas peças, sem custo de sorteio.
+ *
+ * Formato:
+ *   Cabeçalho de 16 bytes: "TSEQ", versão (u32), número de peças (u64)
+ *   Dados: 2 bits por peça, 4 peças por byte; a peça i fica no byte i / 4,
+ *   nos bits (i % 4) * 2. Códigos: 0 = I, 1 = O, 2 = T, 3 = L.
+ *
+ * O id de cada peça é a sua posição na sequência.
+ */
+
+#ifndef SEQUENCIA_H
+#define SEQUENCIA_H
+
+#include <fcntl.h>
+#include <stdint.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define SEQUENCIA_MAGICO         "TSEQ"
+#define SEQUENCIA_VERSAO         1
+#define SEQUENCIA_TAM_CABECALHO  16
+
+/**
+ * Sequência de peças mapeada em memória
+ */
+typedef struct {
+    const unsigned char* mapa;   // Arquivo inteiro mapeado (somente leitura)
+    size_t tamanhoMapa;          // Tamanho do mapeamento em bytes
+    const unsigned char* dados;  // Início das peças compactadas
+    uint64_t numPecas;           // Número de peças da sequência
+} SequenciaPecas;
+
+/**
+ * Tamanho em bytes de um arquivo de sequência
+ * @param numPecas Número de peças
+ * @return Tamanho total (cabeçalho + dados)
+ */
+static inline uint64_t tamanhoArquivoSequencia(uint64_t numPecas) {
+    return SEQUENCIA_TAM_CABECALHO + (numPecas + 3) / 4;
+}
+
+/**
+ * Preenche o cabeçalho de um arquivo de sequência
+ * @param destino Ponteiro para os 16 bytes do cabeçalho
+ * @param numPecas Número de peças da sequência
+ */
+static inline void escreverCabecalhoSequencia(unsigned char* destino, uint64_t numPecas) {
+    memcpy(destino, SEQUENCIA_MAGICO, 4);
+    for (int i = 0; i < 4; i++) {
+        destino[4 + i] = (unsigned char)((SEQUENCIA_VERSAO >> (8 * i)) & 0xFF);
+    }
+    for (int i = 0; i < 8; i++) {
+        destino[8 + i] = (unsigned char)((numPecas >> (8 * i)) & 0xFF);
+    }
+}
+
+/**
+ * Abre e mapeia um arquivo de sequência
+ * @param caminho Caminho do arquivo
+ * @param sequencia Ponteiro para a estrutura a preencher
+ * @return 1 se bem-sucedido, 0 se o arquivo não existe ou é inválido
+ */
+static inline int abrirSequencia(const char* caminho, SequenciaPecas* sequencia) {
+    int fd = open(caminho, O_RDONLY);
+    if (fd < 0) {
+        return 0;
+    }
+
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size < SEQUENCIA_TAM_CABECALHO) {
+        close(fd);
+        return 0;
+    }
+
+    void* mapa = mmap(NULL, (size_t)info.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (mapa == MAP_FAILED) {
+        return 0;
+    }
+
+    const unsigned char* bytes = mapa;
+    uint32_t versao = 0;
+    for (int i = 0; i < 4; i++) {
+        versao |= (uint32_t)bytes[4 + i] << (8 * i);
+    }
+    uint64_t numPecas = 0;
+    for (int i = 0; i < 8; i++) {
+        numPecas |= (uint64_t)bytes[8 + i] << (8 * i);
+    }
+
+    if (memcmp(bytes, SEQUENCIA_MAGICO, 4) != 0 || versao != SEQUENCIA_VERSAO ||
+        numPecas == 0 || tamanhoArquivoSequencia(numPecas) > (uint64_t)info.st_size) {
+        munmap(mapa, (size_t)info.st_size);
+        return 0;
+    }
+
+    // Leitura essencialmente sequencial: favorece a leitura antecipada
+    madvise(mapa, (size_t)info.st_size, MADV_SEQUENTIAL);
+
+    sequencia->mapa = bytes;
+    sequencia->tamanhoMapa = (size_t)info.st_size;
+    sequencia->dados = bytes + SEQUENCIA_TAM_CABECALHO;
+    sequencia->numPecas = numPecas;
+    return 1;
+}
+
+/**
+ * Obtém o código de tipo da peça em uma posição da sequência
+ * @param sequencia Sequência mapeada
+ * @param posicao Posição da peça (0 .. numPecas - 1)
+ * @return Código do tipo (0..3)
+ */
+static inline int tipoNaSequencia(const SequenciaPecas* sequencia, uint64_t posicao) {
+    return (sequencia->dados[posicao >> 2] >> ((posicao & 3) * 2)) & 3;
+}
+
+/**
+ * Desfaz o mapeamento de uma sequência
+ * @param sequencia Sequência mapeada
+ */
+static inline void fecharSequencia(SequenciaPecas* sequencia) {
+    if (sequencia->mapa != NULL) {
+        munmap((void*)sequencia->mapa, sequencia->tamanhoMapa);
+        sequencia->mapa = NULL;
+    }
+}
+
+#endif // SEQUENCIA_H
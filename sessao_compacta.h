@@ -0,0 +1,255 @@
+/*
+ * TETRIS STACK - SESSÃO COMPACTA EM UMA LINHA DE CACHE
+ *
+ * Layout alternativo para hospedar muitas sessões: fila, pilha, índices e
+ * gerador de peças de uma sessão ocupam exatamente 64 bytes alinhados, ou
+ * seja, uma única linha de cache, sem preenchimento implícito.
+ *
+ *   bytes  0..15  cabeçalho: frente, tamanho e altura da pilha, próximo id
+ *                 e estado do gerador (xorshift64) da sessão
+ *   bytes 16..23  tipos das peças, um byte cada: fila (anel) e depois pilha
+ *   bytes 24..55  ids das peças (32 bits), na mesma ordem dos tipos
+ *   bytes 56..63  livres
+ *
+ * Em FilaPecas/PilhaReserva cada Peca tem 3 bytes de preenchimento e os
+ * contadores ficam no fim de cada estrutura, que juntas passam de uma linha
+ * de cache; aqui uma operação toca uma linha só.
+ *
+ * As operações seguem as regras do mestre.c (mesmas validações e mesma
+ * ordem das peças nas trocas), mas sem mensagens nem eventos. As peças novas
+ * vêm do gerador da própria sessão.
+ *
+ * Deve ser incluído depois de mestre.c (usa Peca, FilaPecas e PilhaReserva
+ * nas conversões).
+ */
+
+#ifndef SESSAO_COMPACTA_H
+#define SESSAO_COMPACTA_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define SESSAO_POSICOES         (CAPACIDADE_FILA + CAPACIDADE_PILHA)
+#define SESSAO_BYTES_TIPOS      ((SESSAO_POSICOES + 3) & ~3)    // Arredondado para alinhar os ids
+#define SESSAO_BYTES_LIVRES     (64 - 16 - SESSAO_BYTES_TIPOS - 4 * SESSAO_POSICOES)
+
+#if SESSAO_BYTES_LIVRES < 0
+#error "fila e pilha grandes demais para uma sessao compacta de 64 bytes"
+#endif
+
+/**
+ * Sessão compacta: uma linha de cache
+ */
+typedef struct {
+    // Cabeçalho
+    uint8_t frente;                         // Posição da frente da fila no anel
+    uint8_t tamanho;                        // Peças na fila
+    uint8_t altura;                         // Peças na pilha (topo = altura - 1)
+    uint8_t reservado;
+    uint32_t proximoId;                     // Id da próxima peça gerada
+    uint64_t rng;                           // Estado do gerador de tipos (nunca zero)
+
+    char tipos[SESSAO_BYTES_TIPOS];         // [0, CAPACIDADE_FILA): fila; depois: pilha da base ao topo
+    uint32_t ids[SESSAO_POSICOES];          // Ids, na mesma ordem dos tipos
+#if SESSAO_BYTES_LIVRES > 0
+    uint8_t livres[SESSAO_BYTES_LIVRES];
+#endif
+} __attribute__((aligned(64))) SessaoCompacta;
+
+_Static_assert(sizeof(SessaoCompacta) == 64, "a sessao compacta deve ocupar uma linha de cache");
+_Static_assert(_Alignof(SessaoCompacta) == 64, "a sessao compacta deve ser alinhada a linha de cache");
+_Static_assert(offsetof(SessaoCompacta, tipos) == 16 &&
+               offsetof(SessaoCompacta, ids) == 16 + SESSAO_BYTES_TIPOS,
+               "a sessao compacta nao deve ter preenchimento implicito");
+
+// Posição no array de tipos/ids da peça i da pilha (0 = base)
+#define SESSAO_PILHA(i)         (CAPACIDADE_FILA + (i))
+
+// ============================================================================
+// GERAÇÃO E INICIALIZAÇÃO
+// ============================================================================
+
+/**
+ * Gera a próxima peça da sessão no final da fila (a fila não pode estar cheia)
+ * @param sessao Sessão
+ */
+static inline void enqueueCompacta(SessaoCompacta* sessao) {
+    static const char tipos[4] = {'I', 'O', 'T', 'L'};
+    uint64_t x = sessao->rng;
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    sessao->rng = x;
+
+    int tras = (sessao->frente + sessao->tamanho) % CAPACIDADE_FILA;
+    sessao->tipos[tras] = tipos[x >> 62];
+    sessao->ids[tras] = sessao->proximoId++;
+    sessao->tamanho++;
+}
+
+/**
+ * Inicializa uma sessão com a fila cheia e a pilha vazia
+ * @param sessao Sessão a inicializar
+ * @param semente Semente do gerador de tipos
+ * @param primeiroId Id da primeira peça
+ */
+static inline void iniciarSessaoCompacta(SessaoCompacta* sessao, uint64_t semente, uint32_t primeiroId) {
+    memset(sessao, 0, sizeof(*sessao));
+    sessao->rng = semente != 0 ? semente : 0x9E3779B97F4A7C15ULL;
+    sessao->proximoId = primeiroId;
+    for (int i = 0; i < CAPACIDADE_FILA; i++) {
+        enqueueCompacta(sessao);
+    }
+}
+
+// ============================================================================
+// OPERAÇÕES (REGRAS DO MESTRE.C)
+// ============================================================================
+
+/**
+ * Joga a peça da frente e gera uma nova no final (opção 1)
+ * @return 1 se bem-sucedida, 0 se a fila está vazia
+ */
+static inline int jogarCompacta(SessaoCompacta* sessao) {
+    if (sessao->tamanho == 0) {
+        return 0;
+    }
+    sessao->frente = (uint8_t)((sessao->frente + 1) % CAPACIDADE_FILA);
+    sessao->tamanho--;
+    enqueueCompacta(sessao);
+    return 1;
+}
+
+/**
+ * Envia a peça da frente para a pilha e gera uma nova no final (opção 2)
+ * @return 1 se bem-sucedida, 0 se a pilha está cheia ou a fila vazia
+ */
+static inline int reservarCompacta(SessaoCompacta* sessao) {
+    if (sessao->altura == CAPACIDADE_PILHA || sessao->tamanho == 0) {
+        return 0;
+    }
+    sessao->tipos[SESSAO_PILHA(sessao->altura)] = sessao->tipos[sessao->frente];
+    sessao->ids[SESSAO_PILHA(sessao->altura)] = sessao->ids[sessao->frente];
+    sessao->altura++;
+    sessao->frente = (uint8_t)((sessao->frente + 1) % CAPACIDADE_FILA);
+    sessao->tamanho--;
+    enqueueCompacta(sessao);
+    return 1;
+}
+
+/**
+ * Usa (descarta) a peça do topo da pilha (opção 3)
+ * @return 1 se bem-sucedida, 0 se a pilha está vazia
+ */
+static inline int usarReservaCompacta(SessaoCompacta* sessao) {
+    if (sessao->altura == 0) {
+        return 0;
+    }
+    sessao->altura--;
+    return 1;
+}
+
+/**
+ * Troca as k peças da frente da fila com as k do topo da pilha, invertendo
+ * a ordem como permutarBloco do mestre.c. Não faz validações.
+ */
+static inline void permutarCompacta(SessaoCompacta* sessao, int k) {
+    int posicao = sessao->frente;
+    int topo = SESSAO_PILHA(sessao->altura - 1);
+    for (int i = 0; i < k; i++) {
+        char tipo = sessao->tipos[posicao];
+        uint32_t id = sessao->ids[posicao];
+        sessao->tipos[posicao] = sessao->tipos[topo - i];
+        sessao->ids[posicao] = sessao->ids[topo - i];
+        sessao->tipos[topo - i] = tipo;
+        sessao->ids[topo - i] = id;
+        posicao = posicao + 1 == CAPACIDADE_FILA ? 0 : posicao + 1;
+    }
+}
+
+/**
+ * Troca a frente da fila com o topo da pilha (opção 4)
+ * @return 1 se bem-sucedida, 0 se a fila ou a pilha está vazia
+ */
+static inline int trocarSimplesCompacta(SessaoCompacta* sessao) {
+    if (sessao->tamanho == 0 || sessao->altura == 0) {
+        return 0;
+    }
+    permutarCompacta(sessao, 1);
+    return 1;
+}
+
+/**
+ * Troca os CAPACIDADE_PILHA primeiros da fila com toda a pilha (opção 5)
+ * @return 1 se bem-sucedida, 0 se a fila ou a pilha não está cheia
+ */
+static inline int trocarMultiplaCompacta(SessaoCompacta* sessao) {
+    if (sessao->tamanho != CAPACIDADE_FILA || sessao->altura != CAPACIDADE_PILHA) {
+        return 0;
+    }
+    permutarCompacta(sessao, CAPACIDADE_PILHA);
+    return 1;
+}
+
+/**
+ * Troca os k primeiros da fila com os k do topo da pilha (opção 7)
+ * @return 1 se bem-sucedida, 0 se a fila ou a pilha tem menos de k peças
+ */
+static inline int trocarBlocoCompacta(SessaoCompacta* sessao, int k) {
+    if (k < 1 || k > sessao->tamanho || k > sessao->altura) {
+        return 0;
+    }
+    permutarCompacta(sessao, k);
+    return 1;
+}
+
+// ============================================================================
+// CONVERSÃO DE E PARA AS ESTRUTURAS DO MESTRE.C
+// ============================================================================
+
+/**
+ * Copia a fila e a pilha do mestre.c para uma sessão compacta (o gerador e
+ * o próximo id da sessão não são alterados)
+ * @param sessao Sessão de destino
+ * @param fila Fila de origem
+ * @param pilha Pilha de origem
+ */
+static inline void compactarSessao(SessaoCompacta* sessao, const FilaPecas* fila, const PilhaReserva* pilha) {
+    sessao->frente = (uint8_t)fila->frente;
+    sessao->tamanho = (uint8_t)fila->tamanho;
+    sessao->altura = (uint8_t)(pilha->topo + 1);
+    for (int i = 0; i < CAPACIDADE_FILA; i++) {
+        sessao->tipos[i] = fila->pecas[i].nome;
+        sessao->ids[i] = (uint32_t)fila->pecas[i].id;
+    }
+    for (int i = 0; i < CAPACIDADE_PILHA; i++) {
+        sessao->tipos[SESSAO_PILHA(i)] = pilha->pecas[i].nome;
+        sessao->ids[SESSAO_PILHA(i)] = (uint32_t)pilha->pecas[i].id;
+    }
+}
+
+/**
+ * Reconstrói a fila e a pilha do mestre.c a partir de uma sessão compacta
+ * (todas as posições marcadas como alteradas)
+ * @param sessao Sessão de origem
+ * @param fila Fila de destino
+ * @param pilha Pilha de destino
+ */
+static inline void expandirSessao(const SessaoCompacta* sessao, FilaPecas* fila, PilhaReserva* pilha) {
+    fila->frente = sessao->frente;
+    fila->tamanho = sessao->tamanho;
+    fila->tras = (sessao->frente + sessao->tamanho) % CAPACIDADE_FILA;
+    fila->sujo = SUJO_TUDO;
+    for (int i = 0; i < CAPACIDADE_FILA; i++) {
+        fila->pecas[i].nome = sessao->tipos[i];
+        fila->pecas[i].id = (int)sessao->ids[i];
+    }
+    pilha->topo = sessao->altura - 1;
+    pilha->sujo = SUJO_TUDO;
+    for (int i = 0; i < CAPACIDADE_PILHA; i++) {
+        pilha->pecas[i].nome = sessao->tipos[SESSAO_PILHA(i)];
+        pilha->pecas[i].id = (int)sessao->ids[SESSAO_PILHA(i)];
+    }
+}
+
+#endif // SESSAO_COMPACTA_H
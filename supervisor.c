@@ -0,0 +1,601 @@
+/*
+ * TETRIS STACK - SUPERVISOR DE SESSÕES PRÉ-INICIALIZADAS
+ *
+ * Mantém um pool de processos trabalhadores criados por fork (sem exec nem
+ * ligação dinâmica), cada um com a sessão do mestre já pronta: gerador
+ * semeado, fila cheia e pilha vazia. Cada jogador que conecta no socket
+ * local recebe um trabalhador pronto: o descritor da conexão é passado ao
+ * trabalhador (SCM_RIGHTS), que o assume como entrada e saída padrão e roda
+ * o laço do modo texto do mestre. O primeiro quadro custa só a entrega.
+ *
+ * O pool se ajusta à demanda: a quantidade de trabalhadores prontos acompanha
+ * a média das entregas por segundo, entre --minimo e --maximo. Trabalhadores
+ * encerram ao fim da sessão e são repostos; os excedentes são dispensados.
+ *
+ * Uso:
+ *   supervisor [--socket CAMINHO] [--minimo N] [--maximo N]
+ *   supervisor --medir N [--socket CAMINHO] [--executavel ./mestre]
+ * Com --medir, compara N sessões curtas (só a opção 0) pelo supervisor já em
+ * execução com N processos do mestre criados por fork + exec.
+ * Para jogar: socat - UNIX-CONNECT:CAMINHO (ou nc -U CAMINHO)
+ *
+ * Compilação: gcc -O2 supervisor.c -o supervisor
+ */
+
+#define MESTRE_SEM_MAIN
+#include "mestre.c"
+
+#include <errno.h>
+#include <signal.h>
+#include <stdint.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+
+// ============================================================================
+// DEFINIÇÕES E ESTRUTURAS
+// ============================================================================
+
+#define SUPERVISOR_SOCKET_PADRAO    "/tmp/tetris-supervisor.sock"
+#define SUPERVISOR_MAX_POOL         256     // Trabalhadores (prontos ou iniciando)
+#define SUPERVISOR_MAX_ESPERA       1024    // Jogadores esperando um trabalhador
+
+/**
+ * Trabalhador do pool, ainda sem jogador
+ */
+typedef struct {
+    pid_t pid;
+    int controle;   // Socket de controle (supervisor <-> trabalhador)
+    int pronto;     // 1 quando a sessão está inicializada
+} TrabalhadorPool;
+
+/**
+ * Estado do supervisor
+ */
+typedef struct {
+    int escuta;                                 // Socket de escuta dos jogadores
+    TrabalhadorPool pool[SUPERVISOR_MAX_POOL];
+    int tamanhoPool;
+    int espera[SUPERVISOR_MAX_ESPERA];          // Conexões esperando trabalhador (FIFO)
+    int numEspera;
+    int minimo, maximo, alvo;                   // Limites e alvo de trabalhadores no pool
+    double taxaEntregas;                        // Média móvel das entregas por segundo
+    int entregasNoSegundo;
+    uint64_t entregas, esperas, dispensados;    // Totais, para o resumo
+    int picoPool;
+} Supervisor;
+
+static volatile sig_atomic_t encerrar = 0;
+
+// ============================================================================
+// PASSAGEM DE DESCRITORES
+// ============================================================================
+
+/**
+ * Envia um descritor pelo socket de controle (SCM_RIGHTS)
+ * @return 1 se enviado, 0 caso contrário
+ */
+static int enviarDescritor(int controle, int descritor) {
+    char marca = 'J';
+    struct iovec dado = { &marca, 1 };
+    union {
+        struct cmsghdr cabecalho;
+        char espaco[CMSG_SPACE(sizeof(int))];
+    } controleMsg;
+    struct msghdr msg;
+
+    memset(&msg, 0, sizeof(msg));
+    memset(&controleMsg, 0, sizeof(controleMsg));
+    msg.msg_iov = &dado;
+    msg.msg_iovlen = 1;
+    msg.msg_control = controleMsg.espaco;
+    msg.msg_controllen = sizeof(controleMsg.espaco);
+
+    struct cmsghdr* cmsg = CMSG_FIRSTHDR(&msg);
+    cmsg->cmsg_level = SOL_SOCKET;
+    cmsg->cmsg_type = SCM_RIGHTS;
+    cmsg->cmsg_len = CMSG_LEN(sizeof(int));
+    memcpy(CMSG_DATA(cmsg), &descritor, sizeof(int));
+
+    return sendmsg(controle, &msg, MSG_NOSIGNAL) == 1;
+}
+
+/**
+ * Recebe um descritor pelo socket de controle, bloqueando até chegar
+ * @return Descritor recebido, ou -1 se o supervisor fechou o controle
+ */
+static int receberDescritor(int controle) {
+    char marca;
+    struct iovec dado = { &marca, 1 };
+    union {
+        struct cmsghdr cabecalho;
+        char espaco[CMSG_SPACE(sizeof(int))];
+    } controleMsg;
+    struct msghdr msg;
+
+    memset(&msg, 0, sizeof(msg));
+    msg.msg_iov = &dado;
+    msg.msg_iovlen = 1;
+    msg.msg_control = controleMsg.espaco;
+    msg.msg_controllen = sizeof(controleMsg.espaco);
+
+    ssize_t lidos;
+    do {
+        lidos = recvmsg(controle, &msg, MSG_CMSG_CLOEXEC);
+    } while (lidos < 0 && errno == EINTR);
+    if (lidos <= 0) {
+        return -1;
+    }
+
+    struct cmsghdr* cmsg = CMSG_FIRSTHDR(&msg);
+    if (cmsg == NULL || cmsg->cmsg_level != SOL_SOCKET || cmsg->cmsg_type != SCM_RIGHTS) {
+        return -1;
+    }
+    int descritor;
+    memcpy(&descritor, CMSG_DATA(cmsg), sizeof(int));
+    return descritor;
+}
+
+// ============================================================================
+// TRABALHADOR
+// ============================================================================
+
+/**
+ * Corpo do trabalhador: prepara a sessão, avisa que está pronto, espera um
+ * jogador e joga a sessão no modo texto com a conexão como entrada e saída
+ * @param controle Socket de controle com o supervisor
+ */
+static void executarTrabalhador(int controle) {
+    // Sessão pronta antes de qualquer jogador chegar
+    srand((unsigned int)time(NULL) ^ ((unsigned int)getpid() << 16));
+    FilaPecas fila;
+    PilhaReserva pilha;
+    inicializarFila(&fila);
+    inicializarPilha(&pilha);
+
+    char pronto = 'P';
+    if (write(controle, &pronto, 1) != 1) {
+        _exit(1);
+    }
+    int jogador = receberDescritor(controle);
+    if (jogador < 0) {
+        _exit(0);   // Dispensado (pool reduzido) ou supervisor encerrado
+    }
+    close(controle);
+
+    if (dup2(jogador, STDIN_FILENO) < 0 || dup2(jogador, STDOUT_FILENO) < 0) {
+        _exit(1);
+    }
+    close(jogador);
+
+    // Com buffer de linha nos dois sentidos, o prompt é enviado antes de cada leitura
+    setvbuf(stdin, NULL, _IOLBF, BUFSIZ);
+    setvbuf(stdout, NULL, _IOLBF, BUFSIZ);
+
+    exit(executarModoTexto(&fila, &pilha));
+}
+
+// ============================================================================
+// POOL
+// ============================================================================
+
+/**
+ * Cria um trabalhador por fork; ele herda o código já carregado do supervisor
+ * @return 1 se criado, 0 caso contrário
+ */
+static int criarTrabalhador(Supervisor* sup) {
+    int par[2];
+    if (sup->tamanhoPool >= SUPERVISOR_MAX_POOL ||
+        socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, par) != 0) {
+        return 0;
+    }
+
+    fflush(NULL);   // Nada de buffers do supervisor duplicados no filho
+    pid_t pid = fork();
+    if (pid < 0) {
+        close(par[0]);
+        close(par[1]);
+        return 0;
+    }
+    if (pid == 0) {
+        // O filho não deve segurar a escuta nem os controles dos irmãos
+        close(par[0]);
+        close(sup->escuta);
+        for (int i = 0; i < sup->tamanhoPool; i++) {
+            close(sup->pool[i].controle);
+        }
+        for (int i = 0; i < sup->numEspera; i++) {
+            close(sup->espera[i]);
+        }
+        signal(SIGINT, SIG_DFL);
+        signal(SIGTERM, SIG_DFL);
+        signal(SIGCHLD, SIG_DFL);
+        signal(SIGPIPE, SIG_DFL);
+        executarTrabalhador(par[1]);
+    }
+
+    close(par[1]);
+    TrabalhadorPool* trabalhador = &sup->pool[sup->tamanhoPool++];
+    trabalhador->pid = pid;
+    trabalhador->controle = par[0];
+    trabalhador->pronto = 0;
+    if (sup->tamanhoPool > sup->picoPool) {
+        sup->picoPool = sup->tamanhoPool;
+    }
+    return 1;
+}
+
+/**
+ * Retira um trabalhador do pool (fechando o controle) sem preservar a ordem
+ */
+static void removerTrabalhador(Supervisor* sup, int indice) {
+    close(sup->pool[indice].controle);
+    sup->pool[indice] = sup->pool[--sup->tamanhoPool];
+}
+
+/**
+ * Entrega uma conexão a um trabalhador pronto
+ * @return 1 se entregue, 0 se o trabalhador já tinha morrido
+ */
+static int entregarJogador(Supervisor* sup, int indice, int jogador) {
+    int entregue = enviarDescritor(sup->pool[indice].controle, jogador);
+    removerTrabalhador(sup, indice);
+    if (entregue) {
+        close(jogador);
+        sup->entregas++;
+        sup->entregasNoSegundo++;
+    }
+    return entregue;
+}
+
+/**
+ * Índice de um trabalhador pronto, ou -1 se não houver
+ */
+static int trabalhadorPronto(const Supervisor* sup) {
+    for (int i = 0; i < sup->tamanhoPool; i++) {
+        if (sup->pool[i].pronto) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+/**
+ * Atualiza o alvo do pool com a média das entregas por segundo e dispensa
+ * trabalhadores prontos acima do alvo (chamada uma vez por segundo)
+ */
+static void ajustarPool(Supervisor* sup) {
+    sup->taxaEntregas = 0.5 * sup->taxaEntregas + 0.5 * sup->entregasNoSegundo;
+    sup->entregasNoSegundo = 0;
+
+    int alvo = sup->minimo + (int)(sup->taxaEntregas + 0.999);
+    sup->alvo = alvo < sup->maximo ? alvo : sup->maximo;
+
+    for (int i = sup->tamanhoPool - 1; i >= 0 && sup->tamanhoPool > sup->alvo; i--) {
+        if (sup->pool[i].pronto) {
+            removerTrabalhador(sup, i);     // O trabalhador vê o controle fechado e sai
+            sup->dispensados++;
+        }
+    }
+}
+
+static void tratarSinalSupervisor(int sinal) {
+    (void)sinal;
+    encerrar = 1;
+}
+
+static double agoraSegundos(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+/**
+ * Laço do supervisor: aceita jogadores, entrega cada um a um trabalhador
+ * pronto (ou o põe na espera), repõe e ajusta o pool
+ * @return Código de saída do programa
+ */
+static int executarSupervisor(const char* caminho, int minimo, int maximo) {
+    static Supervisor sup;
+    struct sockaddr_un endereco;
+
+    memset(&endereco, 0, sizeof(endereco));
+    endereco.sun_family = AF_UNIX;
+    if (strlen(caminho) >= sizeof(endereco.sun_path)) {
+        fprintf(stderr, "Erro: caminho de socket longo demais.\n");
+        return 1;
+    }
+    strcpy(endereco.sun_path, caminho);
+    unlink(caminho);
+
+    sup.escuta = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC | SOCK_NONBLOCK, 0);
+    if (sup.escuta < 0 || bind(sup.escuta, (struct sockaddr*)&endereco, sizeof(endereco)) != 0 ||
+        listen(sup.escuta, 128) != 0) {
+        fprintf(stderr, "Erro: nao foi possivel escutar em '%s': %s\n", caminho, strerror(errno));
+        return 1;
+    }
+
+    // Trabalhadores encerrados são recolhidos pelo kernel
+    struct sigaction acao;
+    memset(&acao, 0, sizeof(acao));
+    acao.sa_handler = SIG_IGN;
+    acao.sa_flags = SA_NOCLDWAIT;
+    sigaction(SIGCHLD, &acao, NULL);
+    signal(SIGPIPE, SIG_IGN);
+    acao.sa_handler = tratarSinalSupervisor;
+    acao.sa_flags = 0;
+    sigaction(SIGINT, &acao, NULL);
+    sigaction(SIGTERM, &acao, NULL);
+
+    sup.minimo = minimo;
+    sup.maximo = maximo;
+    sup.alvo = minimo;
+    fprintf(stderr, "supervisor: escutando em %s (pool de %d a %d trabalhadores)\n", caminho, minimo, maximo);
+
+    double proximoAjuste = agoraSegundos() + 1.0;
+    // Depois de uma criação que falhou (fork com EAGAIN, pool no limite), a
+    // reposição espera um trabalhador mudar de estado ou o próximo ajuste, em
+    // vez de tentar de novo a cada volta com poll sem espera
+    int reposicaoSuspensa = 0;
+    while (!encerrar) {
+        // Jogadores esperando sem trabalhador a caminho: cria já
+        while (!reposicaoSuspensa && sup.tamanhoPool < sup.numEspera) {
+            reposicaoSuspensa = !criarTrabalhador(&sup);
+        }
+        int faltam = !reposicaoSuspensa && sup.tamanhoPool < sup.alvo + sup.numEspera;
+
+        struct pollfd fds[1 + SUPERVISOR_MAX_POOL];
+        fds[0].fd = sup.escuta;
+        fds[0].events = sup.numEspera < SUPERVISOR_MAX_ESPERA ? POLLIN : 0;
+        for (int i = 0; i < sup.tamanhoPool; i++) {
+            fds[1 + i].fd = sup.pool[i].controle;
+            fds[1 + i].events = POLLIN;
+            fds[1 + i].revents = 0;
+        }
+        int espera = faltam ? 0 : (int)((proximoAjuste - agoraSegundos()) * 1000.0);
+        int numFds = 1 + sup.tamanhoPool;
+        int eventos = poll(fds, (nfds_t)numFds, espera > 0 ? espera : 0);
+        if (eventos < 0 && errno != EINTR) {
+            break;
+        }
+
+        // O resto da reposição só com o supervisor ocioso, um fork por volta,
+        // para não atrasar a entrega de quem acabou de conectar
+        if (eventos == 0 && faltam) {
+            reposicaoSuspensa = !criarTrabalhador(&sup);
+        }
+
+        // Avisos de pronto (ou morte) dos trabalhadores; de trás para frente,
+        // pois removerTrabalhador move o último para a posição removida
+        for (int i = numFds - 2; i >= 0; i--) {
+            if (fds[1 + i].revents == 0) {
+                continue;
+            }
+            reposicaoSuspensa = 0;
+            char marca;
+            if (read(sup.pool[i].controle, &marca, 1) == 1) {
+                sup.pool[i].pronto = 1;
+            } else {
+                removerTrabalhador(&sup, i);
+            }
+        }
+
+        // Novos jogadores
+        if (fds[0].revents & POLLIN) {
+            int jogador;
+            while (sup.numEspera < SUPERVISOR_MAX_ESPERA &&
+                   (jogador = accept4(sup.escuta, NULL, NULL, SOCK_CLOEXEC)) >= 0) {
+                sup.espera[sup.numEspera++] = jogador;
+            }
+        }
+
+        // Entrega os jogadores em espera, na ordem de chegada
+        int atendidos = 0;
+        while (atendidos < sup.numEspera) {
+            int indice = trabalhadorPronto(&sup);
+            if (indice < 0) {
+                sup.esperas += (uint64_t)(sup.numEspera - atendidos);
+                break;
+            }
+            if (entregarJogador(&sup, indice, sup.espera[atendidos])) {
+                atendidos++;
+            }
+        }
+        memmove(sup.espera, sup.espera + atendidos, sizeof(int) * (size_t)(sup.numEspera - atendidos));
+        sup.numEspera -= atendidos;
+
+        if (agoraSegundos() >= proximoAjuste) {
+            ajustarPool(&sup);
+            proximoAjuste += 1.0;
+            reposicaoSuspensa = 0;
+        }
+    }
+
+    // Fechar os controles dispensa os trabalhadores ainda sem jogador
+    while (sup.tamanhoPool > 0) {
+        removerTrabalhador(&sup, sup.tamanhoPool - 1);
+    }
+    for (int i = 0; i < sup.numEspera; i++) {
+        close(sup.espera[i]);
+    }
+    close(sup.escuta);
+    unlink(caminho);
+    fprintf(stderr, "supervisor: %llu sessoes entregues, %llu esperas por trabalhador, "
+                    "%llu dispensados, pico do pool %d\n",
+            (unsigned long long)sup.entregas, (unsigned long long)sup.esperas,
+            (unsigned long long)sup.dispensados, sup.picoPool);
+    return 0;
+}
+
+// ============================================================================
+// MEDIÇÃO
+// ============================================================================
+
+/**
+ * Envia a opção 0 e lê a sessão até o fim
+ * @param primeiroByte Recebe o instante do primeiro byte recebido
+ * @return 1 se a sessão produziu saída
+ */
+static int jogarSessaoCurta(int conexao, double* primeiroByte) {
+    char buffer[4096];
+    ssize_t lidos;
+    int recebeu = 0;
+
+    if (write(conexao, "0\n", 2) != 2) {
+        return 0;
+    }
+    while ((lidos = read(conexao, buffer, sizeof(buffer))) > 0) {
+        if (!recebeu) {
+            *primeiroByte = agoraSegundos();
+            recebeu = 1;
+        }
+    }
+    return recebeu;
+}
+
+/**
+ * Uma sessão curta pelo supervisor
+ * @return 1 se bem-sucedida
+ */
+static int medirViaSupervisor(const char* caminho, double* primeiro, double* total) {
+    struct sockaddr_un endereco;
+    memset(&endereco, 0, sizeof(endereco));
+    endereco.sun_family = AF_UNIX;
+    snprintf(endereco.sun_path, sizeof(endereco.sun_path), "%s", caminho);
+
+    double inicio = agoraSegundos(), primeiroByte = 0;
+    int conexao = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (conexao < 0 || connect(conexao, (struct sockaddr*)&endereco, sizeof(endereco)) != 0) {
+        if (conexao >= 0) {
+            close(conexao);
+        }
+        return 0;
+    }
+    int ok = jogarSessaoCurta(conexao, &primeiroByte);
+    *total = agoraSegundos() - inicio;
+    *primeiro = primeiroByte - inicio;
+    close(conexao);
+    return ok;
+}
+
+/**
+ * Uma sessão curta em um processo novo (fork + exec do executável)
+ * @return 1 se bem-sucedida
+ */
+static int medirViaExec(const char* executavel, double* primeiro, double* total) {
+    int par[2];
+    if (socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, par) != 0) {
+        return 0;
+    }
+
+    double inicio = agoraSegundos(), primeiroByte = 0;
+    pid_t pid = fork();
+    if (pid == 0) {
+        dup2(par[1], STDIN_FILENO);
+        dup2(par[1], STDOUT_FILENO);
+        execl(executavel, executavel, (char*)NULL);
+        _exit(127);
+    }
+    close(par[1]);
+    int ok = pid > 0 && jogarSessaoCurta(par[0], &primeiroByte);
+    *total = agoraSegundos() - inicio;
+    *primeiro = primeiroByte - inicio;
+    close(par[0]);
+    if (pid > 0) {
+        waitpid(pid, NULL, 0);
+    }
+    return ok;
+}
+
+static int compararTempos(const void* a, const void* b) {
+    double x = *(const double*)a, y = *(const double*)b;
+    return (x > y) - (x < y);
+}
+
+/**
+ * Imprime mediana e p99 de uma série de tempos (em microssegundos)
+ */
+static void imprimirTempos(const char* nome, double* primeiros, double* totais, int n) {
+    qsort(primeiros, (size_t)n, sizeof(double), compararTempos);
+    qsort(totais, (size_t)n, sizeof(double), compararTempos);
+    int p99 = (int)((n - 1) * 0.99);
+    printf("%-12s %14.1f %10.1f %14.1f %10.1f\n", nome, primeiros[n / 2] * 1e6, primeiros[p99] * 1e6,
+           totais[n / 2] * 1e6, totais[p99] * 1e6);
+}
+
+/**
+ * Compara sessões curtas pelo supervisor com processos novos do mestre
+ * @return Código de saída do programa
+ */
+static int executarMedicao(const char* caminho, const char* executavel, int n) {
+    double* tempos = malloc(sizeof(double) * 4 * (size_t)n);
+    if (tempos == NULL) {
+        fprintf(stderr, "Erro: memoria insuficiente.\n");
+        return 1;
+    }
+    double *primeirosPool = tempos, *totaisPool = tempos + n;
+    double *primeirosExec = tempos + 2 * n, *totaisExec = tempos + 3 * n;
+
+    for (int i = 0; i < n; i++) {
+        if (!medirViaSupervisor(caminho, &primeirosPool[i], &totaisPool[i])) {
+            fprintf(stderr, "Erro: supervisor nao respondeu em '%s'.\n", caminho);
+            free(tempos);
+            return 1;
+        }
+    }
+    for (int i = 0; i < n; i++) {
+        if (!medirViaExec(executavel, &primeirosExec[i], &totaisExec[i])) {
+            fprintf(stderr, "Erro: nao foi possivel executar '%s'.\n", executavel);
+            free(tempos);
+            return 1;
+        }
+    }
+
+    printf("=== INICIO DE SESSAO: SUPERVISOR x PROCESSO NOVO ===\n");
+    printf("Sessoes: %d (opcao 0 e fim)  Tempos em microssegundos\n\n", n);
+    printf("%-12s %14s %10s %14s %10s\n", "origem", "1o byte (med)", "p99", "sessao (med)", "p99");
+    imprimirTempos("supervisor", primeirosPool, totaisPool, n);
+    imprimirTempos("fork+exec", primeirosExec, totaisExec, n);
+    printf("\n(o mestre em processo novo escreve em buffer cheio: o 1o byte so sai ao fim)\n");
+
+    free(tempos);
+    return 0;
+}
+
+// ============================================================================
+// PROGRAMA PRINCIPAL
+// ============================================================================
+
+int main(int argc, char* argv[]) {
+    const char* caminho = SUPERVISOR_SOCKET_PADRAO;
+    const char* executavel = "./mestre";
+    int minimo = 4, maximo = 64, medir = 0;
+
+    for (int i = 1; i < argc; i++) {
+        if (i + 1 < argc && strcmp(argv[i], "--socket") == 0) {
+            caminho = argv[++i];
+        } else if (i + 1 < argc && strcmp(argv[i], "--minimo") == 0) {
+            minimo = atoi(argv[++i]);
+        } else if (i + 1 < argc && strcmp(argv[i], "--maximo") == 0) {
+            maximo = atoi(argv[++i]);
+        } else if (i + 1 < argc && strcmp(argv[i], "--medir") == 0) {
+            medir = atoi(argv[++i]);
+        } else if (i + 1 < argc && strcmp(argv[i], "--executavel") == 0) {
+            executavel = argv[++i];
+        } else {
+            minimo = -1;
+            break;
+        }
+    }
+    if (minimo < 1 || maximo < minimo || maximo > SUPERVISOR_MAX_POOL || medir < 0) {
+        fprintf(stderr, "Uso: %s [--socket CAMINHO] [--minimo N] [--maximo N (ate %d)]\n"
+                        "     %s --medir N [--socket CAMINHO] [--executavel ./mestre]\n",
+                argv[0], SUPERVISOR_MAX_POOL, argv[0]);
+        return 1;
+    }
+
+    if (medir > 0) {
+        return executarMedicao(caminho, executavel, medir);
+    }
+    return executarSupervisor(caminho, minimo, maximo);
+}
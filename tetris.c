@@ -0,0 +1,1570 @@
+/*
+ * TETRIS STACK - FONTE ÚNICA DOS SIMULADORES
+ *
+ * Fila circular de peças futuras, pilha de reserva e operações de troca.
+ * O nível de funcionalidades e as capacidades são escolhidos na compilação;
+ * o que um nível não usa não é compilado:
+ *   NIVEL=1  novato:      só a fila (jogar e inserir peças)
+ *   NIVEL=2  aventureiro: fila sempre cheia e pilha de reserva
+ *   NIVEL=3  mestre:      trocas, modo tempo real, eventos, sequências,
+ *                         espectadores e estatísticas (padrão)
+ *
+ * novato.c, aventureiro.c e mestre.c apenas escolhem o nível e incluem este
+ * arquivo.
+ * Compilação: gcc -DNIVEL=N tetris.c -o PROGRAMA
+ */
+
+#define _GNU_SOURCE // ppoll
+
+#ifndef NIVEL
+#define NIVEL 3
+#endif
+
+_Static_assert(NIVEL >= 1 && NIVEL <= 3, "NIVEL deve ser 1 (novato), 2 (aventureiro) ou 3 (mestre)");
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "estatisticas.h"
+#include "rastreamento.h"
+
+#if NIVEL >= 3
+#include <stdarg.h>
+#include <string.h>
+#include <poll.h>
+#include <signal.h>
+#include <termios.h>
+#include <unistd.h>
+
+#include "espectador.h"
+#include "eventos.h"
+#include "sequencia.h"
+#else
+// Sem fluxo de eventos nos níveis 1 e 2
+#define emitirEvento(...) ((void)0)
+#endif
+
+// ============================================================================
+// DEFINIÇÕES E ESTRUTURAS
+// ============================================================================
+
+// Capacidades da fila e da pilha (configuráveis na compilação, ex.: -DCAPACIDADE_PILHA=5)
+#ifndef CAPACIDADE_FILA
+#define CAPACIDADE_FILA 5
+#endif
+
+#ifndef CAPACIDADE_PILHA
+#define CAPACIDADE_PILHA 3
+#endif
+
+// Marcas de alteração (campo `sujo` da fila e da pilha): um bit por posição
+// do array e um bit para os índices. As operações marcam o que mudaram e o
+// desenho refaz apenas o que está marcado, limpando as marcas.
+#define SUJO_POSICAO(i)     (1u << (i))
+#define SUJO_INDICES        (1u << 31)
+#define SUJO_TUDO           0xFFFFFFFFu
+
+_Static_assert(CAPACIDADE_FILA <= 31 && CAPACIDADE_PILHA <= 31,
+               "as marcas de alteracao usam um bit por posicao");
+
+#if NIVEL >= 3
+_Static_assert(CAPACIDADE_PILHA >= 1 && CAPACIDADE_PILHA <= CAPACIDADE_FILA,
+               "a troca multipla exige CAPACIDADE_PILHA entre 1 e CAPACIDADE_FILA");
+#endif
+
+/**
+ * Estrutura que representa uma peça do Tetris
+ */
+typedef struct {
+    char nome;  // Tipo da peça ('I', 'O', 'T', 'L')
+    int id;     // Identificador único da peça
+} Peca;
+
+/**
+ * Estrutura que representa a fila circular de peças futuras
+ */
+typedef struct {
+    Peca pecas[CAPACIDADE_FILA];  // Array de peças com tamanho fixo
+    int frente;     // Índice da frente da fila
+    int tras;       // Índice do final da fila
+    int tamanho;    // Número atual de elementos na fila (sempre CAPACIDADE_FILA a partir do nível 2)
+    unsigned int sujo;  // Posições e índices alterados desde o último desenho
+} FilaPecas;
+
+#if NIVEL >= 2
+/**
+ * Estrutura que representa a pilha de peças reservadas
+ */
+typedef struct {
+    Peca pecas[CAPACIDADE_PILHA];  // Array de peças com capacidade máxima CAPACIDADE_PILHA
+    int topo;       // Índice do topo da pilha (-1 quando vazia)
+    unsigned int sujo;  // Posições e índices alterados desde o último desenho
+} PilhaReserva;
+#endif
+
+// Variável global para controlar o ID das peças
+int proximoId = 0;
+
+#if NIVEL >= 3
+// Sequência pré-gerada usada no lugar do sorteio (--sequencia); vazia se não houver
+SequenciaPecas sequenciaPecas = { NULL, 0, NULL, 0 };
+
+// Indica se o programa está no modo tempo real (mensagens vão para a linha de status)
+int modoTempoReal = 0;
+
+// Suprime as mensagens de operação (usado por ferramentas que incluem este arquivo)
+int modoSilencioso = 0;
+#endif
+
+// ============================================================================
+// DECLARAÇÕES DAS FUNÇÕES
+// ============================================================================
+
+// Funções da fila
+void inicializarFila(FilaPecas* fila);
+int enqueueAutomatico(FilaPecas* fila);
+int enqueueFila(FilaPecas* fila, Peca peca);
+int dequeueFila(FilaPecas* fila, Peca* peca);
+void exibirFila(FilaPecas* fila);
+
+#if NIVEL >= 2
+// Funções da pilha
+void inicializarPilha(PilhaReserva* pilha);
+int pilhaCheia(PilhaReserva* pilha);
+int pilhaVazia(PilhaReserva* pilha);
+int pushPilha(PilhaReserva* pilha, Peca peca);
+int popPilha(PilhaReserva* pilha, Peca* peca);
+void exibirPilha(PilhaReserva* pilha);
+#endif
+
+#if NIVEL >= 3
+// Funções de troca (NOVAS)
+int trocarSimples(FilaPecas* fila, PilhaReserva* pilha);
+int trocarMultipla(FilaPecas* fila, PilhaReserva* pilha);
+int trocarBloco(FilaPecas* fila, PilhaReserva* pilha, int k);
+#endif
+
+// Funções auxiliares
+Peca gerarPeca();
+#if NIVEL >= 2
+void exibirEstadoCompleto(FilaPecas* fila, PilhaReserva* pilha);
+int exibirEstadoAlterado(FilaPecas* fila, PilhaReserva* pilha);
+#endif
+#if NIVEL >= 3
+unsigned long long checksumEstado(FilaPecas* fila, PilhaReserva* pilha);
+void registrarFimSessao(FilaPecas* fila, PilhaReserva* pilha);
+void publicarEspectador(FilaPecas* fila, PilhaReserva* pilha);
+void exibirMensagem(const char* formato, ...);
+#endif
+void exibirMenu();
+int obterOpcao();
+
+#if NIVEL >= 3
+// Funções do modo tempo real
+void registrarStatusTempoReal(const char* formato, va_list args);
+int executarTempoReal(FilaPecas* fila, PilhaReserva* pilha);
+#endif
+
+// ============================================================================
+// IMPLEMENTAÇÃO DAS FUNÇÕES DA FILA
+// ============================================================================
+
+/**
+ * Inicializa a fila de peças, preenchendo-a com CAPACIDADE_FILA peças geradas automaticamente
+ * @param fila Ponteiro para a estrutura da fila
+ */
+void inicializarFila(FilaPecas* fila) {
+    fila->frente = 0;
+    fila->tras = 0;
+    fila->tamanho = 0;
+    fila->sujo = SUJO_TUDO;
+    
+    // Preenche a fila com as peças iniciais
+    for (int i = 0; i < CAPACIDADE_FILA; i++) {
+        enqueueAutomatico(fila);
+    }
+}
+
+/**
+ * Adiciona automaticamente uma nova peça ao final da fila
+ * @param fila Ponteiro para a estrutura da fila
+ * @return 1 se inserção bem-sucedida, 0 caso contrário
+ */
+int enqueueAutomatico(FilaPecas* fila) {
+    if (fila->tamanho >= CAPACIDADE_FILA) {
+        return 0; // Fila já está cheia
+    }
+    
+    RAST_INICIO(RAST_GERACAO);
+    Peca novaPeca = gerarPeca();
+    RAST_FIM(RAST_GERACAO);
+    enqueueFila(fila, novaPeca);
+    
+    emitirEvento(EVT_PECA_GERADA, EVT_OK, novaPeca.nome, novaPeca.id, 0, -1);
+    
+    return 1; // Inserção bem-sucedida
+}
+
+/**
+ * Insere uma peça já existente no final da fila (enqueue)
+ * @param fila Ponteiro para a estrutura da fila
+ * @param peca Peça a ser inserida
+ * @return 1 se inserção bem-sucedida, 0 se fila cheia
+ */
+int enqueueFila(FilaPecas* fila, Peca peca) {
+    if (fila->tamanho >= CAPACIDADE_FILA) {
+        return 0; // Fila cheia, não é possível inserir
+    }
+    
+    // Insere a peça na posição 'tras'
+    fila->pecas[fila->tras] = peca;
+    fila->sujo |= SUJO_POSICAO(fila->tras) | SUJO_INDICES;
+    
+    // Atualiza o índice 'tras' de forma circular
+    fila->tras = (fila->tras + 1) % CAPACIDADE_FILA;
+    
+    // Incrementa o tamanho da fila
+    fila->tamanho++;
+    
+    return 1; // Inserção bem-sucedida
+}
+
+/**
+ * Remove uma peça da frente da fila (dequeue)
+ * @param fila Ponteiro para a estrutura da fila
+ * @param peca Ponteiro para armazenar a peça removida
+ * @return 1 se remoção bem-sucedida, 0 se fila vazia
+ */
+int dequeueFila(FilaPecas* fila, Peca* peca) {
+    if (fila->tamanho == 0) {
+        return 0; // Fila vazia, não é possível remover
+    }
+    
+    // Copia a peça da frente para o ponteiro fornecido
+    *peca = fila->pecas[fila->frente];
+    
+    // Atualiza o índice 'frente' de forma circular
+    fila->frente = (fila->frente + 1) % CAPACIDADE_FILA;
+    
+    // Decrementa o tamanho da fila
+    fila->tamanho--;
+    fila->sujo |= SUJO_INDICES;
+    
+    return 1; // Remoção bem-sucedida
+}
+
+/**
+ * Exibe o estado atual da fila de peças
+ * @param fila Ponteiro para a estrutura da fila
+ */
+void exibirFila(FilaPecas* fila) {
+#if NIVEL == 1
+    printf("\nFila de pecas\n");
+#else
+    printf("Fila de pecas: ");
+#endif
+    
+    if (fila->tamanho == 0) {
+        printf("Fila vazia!\n");
+        return;
+    }
+    
+    // Percorre a fila de forma circular para exibir as peças
+    int indice = fila->frente;
+    for (int i = 0; i < fila->tamanho; i++) {
+        printf("[%c %d] ", fila->pecas[indice].nome, fila->pecas[indice].id);
+        indice = (indice + 1) % CAPACIDADE_FILA;
+    }
+    printf("\n");
+}
+
+#if NIVEL >= 2
+// ============================================================================
+// IMPLEMENTAÇÃO DAS FUNÇÕES DA PILHA
+// ============================================================================
+
+/**
+ * Inicializa a pilha de reserva (vazia)
+ * @param pilha Ponteiro para a estrutura da pilha
+ */
+void inicializarPilha(PilhaReserva* pilha) {
+    pilha->topo = -1; // Pilha vazia
+    pilha->sujo = SUJO_TUDO;
+}
+
+/**
+ * Verifica se a pilha está cheia
+ * @param pilha Ponteiro para a estrutura da pilha
+ * @return 1 se cheia, 0 caso contrário
+ */
+int pilhaCheia(PilhaReserva* pilha) {
+    return pilha->topo == CAPACIDADE_PILHA - 1; // Índice máximo é CAPACIDADE_PILHA - 1
+}
+
+/**
+ * Verifica se a pilha está vazia
+ * @param pilha Ponteiro para a estrutura da pilha
+ * @return 1 se vazia, 0 caso contrário
+ */
+int pilhaVazia(PilhaReserva* pilha) {
+    return pilha->topo == -1;
+}
+
+/**
+ * Insere uma peça no topo da pilha (push)
+ * @param pilha Ponteiro para a estrutura da pilha
+ * @param peca Peça a ser inserida
+ * @return 1 se inserção bem-sucedida, 0 se pilha cheia
+ */
+int pushPilha(PilhaReserva* pilha, Peca peca) {
+    if (pilhaCheia(pilha)) {
+        return 0; // Pilha cheia, não é possível inserir
+    }
+    
+    // Incrementa o topo e insere a peça
+    pilha->topo++;
+    pilha->pecas[pilha->topo] = peca;
+    pilha->sujo |= SUJO_POSICAO(pilha->topo) | SUJO_INDICES;
+    
+    return 1; // Inserção bem-sucedida
+}
+
+/**
+ * Remove uma peça do topo da pilha (pop)
+ * @param pilha Ponteiro para a estrutura da pilha
+ * @param peca Ponteiro para armazenar a peça removida
+ * @return 1 se remoção bem-sucedida, 0 se pilha vazia
+ */
+int popPilha(PilhaReserva* pilha, Peca* peca) {
+    if (pilhaVazia(pilha)) {
+        return 0; // Pilha vazia, não é possível remover
+    }
+    
+    // Copia a peça do topo para o ponteiro fornecido
+    *peca = pilha->pecas[pilha->topo];
+    
+    // Decrementa o topo
+    pilha->topo--;
+    pilha->sujo |= SUJO_INDICES;
+    
+    return 1; // Remoção bem-sucedida
+}
+
+/**
+ * Exibe o estado atual da pilha de reserva
+ * @param pilha Ponteiro para a estrutura da pilha
+ */
+void exibirPilha(PilhaReserva* pilha) {
+    printf("Pilha de reserva (Topo -> Base): ");
+    
+    if (pilhaVazia(pilha)) {
+        printf("Vazia");
+    } else {
+        // Exibe da posição do topo até a base
+        for (int i = pilha->topo; i >= 0; i--) {
+            printf("[%c %d] ", pilha->pecas[i].nome, pilha->pecas[i].id);
+        }
+    }
+    printf("\n");
+}
+#endif // NIVEL >= 2
+
+#if NIVEL >= 3
+// ============================================================================
+// IMPLEMENTAÇÃO DAS FUNÇÕES DE TROCA (NOVAS)
+// ============================================================================
+
+/**
+ * Realiza troca simples entre a frente da fila e o topo da pilha
+ * @param fila Ponteiro para a estrutura da fila
+ * @param pilha Ponteiro para a estrutura da pilha
+ * @return 1 se troca bem-sucedida, 0 caso contrário
+ */
+int trocarSimples(FilaPecas* fila, PilhaReserva* pilha) {
+    EST_MARCAR_INICIO(inicioOperacao);
+    
+    // Validações: ambas devem ter pelo menos 1 peça
+    if (fila->tamanho == 0) {
+        EST_FALHA(EST_FALHA_FILA_VAZIA);
+        emitirEvento(EVT_TROCA_SIMPLES, EVT_ERRO_FILA_VAZIA, 0, -1, 0, -1);
+        exibirMensagem("\nErro: Fila vazia! Nao e possivel realizar a troca.\n");
+        return 0;
+    }
+    
+    if (pilhaVazia(pilha)) {
+        EST_FALHA(EST_FALHA_PILHA_VAZIA);
+        emitirEvento(EVT_TROCA_SIMPLES, EVT_ERRO_PILHA_VAZIA, 0, -1, 0, -1);
+        exibirMensagem("\nErro: Pilha vazia! Nao e possivel realizar a troca.\n");
+        return 0;
+    }
+    
+    // Salva as peças que serão trocadas
+    Peca pecaFila = fila->pecas[fila->frente];
+    Peca pecaPilha = pilha->pecas[pilha->topo];
+    
+    // Realiza a troca
+    fila->pecas[fila->frente] = pecaPilha;
+    pilha->pecas[pilha->topo] = pecaFila;
+    fila->sujo |= SUJO_POSICAO(fila->frente);
+    pilha->sujo |= SUJO_POSICAO(pilha->topo);
+    EST_REGISTRAR(EST_TROCA_SIMPLES, inicioOperacao);
+    
+    emitirEvento(EVT_TROCA_SIMPLES, EVT_OK, pecaFila.nome, pecaFila.id, pecaPilha.nome, pecaPilha.id);
+    exibirMensagem("\nTroca simples realizada: [%c %d] da fila <-> [%c %d] da pilha\n",
+                   pecaFila.nome, pecaFila.id, pecaPilha.nome, pecaPilha.id);
+    
+    return 1; // Troca bem-sucedida
+}
+
+/**
+ * Troca as k peças da frente da fila com as k peças do topo da pilha,
+ * invertendo a ordem (o topo da pilha vai para a frente da fila e a frente
+ * da fila vai para o topo da pilha). Não faz validações.
+ * A fila é percorrida em no máximo dois trechos contíguos (antes e depois
+ * da volta do anel), sem cálculo de módulo por elemento.
+ * @param fila Ponteiro para a estrutura da fila
+ * @param pilha Ponteiro para a estrutura da pilha
+ * @param k Número de peças trocadas
+ */
+static void permutarBloco(FilaPecas* fila, PilhaReserva* pilha, int k) {
+    Peca* topo = &pilha->pecas[pilha->topo];
+    Peca* frente = &fila->pecas[fila->frente];
+    
+    // Primeiro trecho: da frente até o fim do array da fila
+    int primeiro = CAPACIDADE_FILA - fila->frente;
+    if (primeiro > k) {
+        primeiro = k;
+    }
+    for (int i = 0; i < primeiro; i++) {
+        Peca temp = frente[i];
+        frente[i] = topo[-i];
+        topo[-i] = temp;
+    }
+    fila->sujo |= ((1u << primeiro) - 1) << fila->frente;
+    
+    // Segundo trecho: continua do início do array (volta do anel)
+    for (int i = primeiro; i < k; i++) {
+        Peca temp = fila->pecas[i - primeiro];
+        fila->pecas[i - primeiro] = topo[-i];
+        topo[-i] = temp;
+    }
+    fila->sujo |= (1u << (k - primeiro)) - 1;
+    pilha->sujo |= ((1u << k) - 1) << (pilha->topo - k + 1);
+}
+
+/**
+ * Realiza troca múltipla entre os primeiros da fila e toda a pilha
+ * (com as capacidades padrão: os 3 primeiros da fila e as 3 peças da pilha)
+ * @param fila Ponteiro para a estrutura da fila
+ * @param pilha Ponteiro para a estrutura da pilha
+ * @return 1 se troca bem-sucedida, 0 caso contrário
+ */
+int trocarMultipla(FilaPecas* fila, PilhaReserva* pilha) {
+    EST_MARCAR_INICIO(inicioOperacao);
+    
+    // Validações: fila deve estar cheia E pilha deve estar cheia
+    if (fila->tamanho != CAPACIDADE_FILA) {
+        EST_FALHA(EST_FALHA_TROCA_MULTIPLA_FILA);
+        emitirEvento(EVT_TROCA_MULTIPLA, EVT_ERRO_TAMANHO_FILA, 0, CAPACIDADE_PILHA, 0, -1);
+        exibirMensagem("\nErro: Fila deve ter exatamente %d pecas para troca multipla.\n", CAPACIDADE_FILA);
+        return 0;
+    }
+    
+    if (!pilhaCheia(pilha)) {
+        EST_FALHA(EST_FALHA_TROCA_MULTIPLA_PILHA);
+        emitirEvento(EVT_TROCA_MULTIPLA, EVT_ERRO_TAMANHO_PILHA, 0, CAPACIDADE_PILHA, 0, -1);
+        exibirMensagem("\nErro: Pilha deve ter exatamente %d pecas para troca multipla.\n", CAPACIDADE_PILHA);
+        return 0;
+    }
+    
+    // Topo da pilha vai para a frente da fila; frente da fila vai para o topo da pilha
+    permutarBloco(fila, pilha, CAPACIDADE_PILHA);
+    EST_REGISTRAR(EST_TROCA_MULTIPLA, inicioOperacao);
+    
+    emitirEvento(EVT_TROCA_MULTIPLA, EVT_OK, 0, CAPACIDADE_PILHA, 0, -1);
+    exibirMensagem("\nTroca multipla realizada: %d primeiros da fila <-> %d pecas da pilha\n",
+                   CAPACIDADE_PILHA, CAPACIDADE_PILHA);
+    
+    return 1; // Troca bem-sucedida
+}
+
+/**
+ * Realiza troca das k primeiras peças da fila com as k peças do topo da pilha
+ * @param fila Ponteiro para a estrutura da fila
+ * @param pilha Ponteiro para a estrutura da pilha
+ * @param k Número de peças (1 <= k <= mínimo entre o tamanho da fila e o da pilha)
+ * @return 1 se troca bem-sucedida, 0 caso contrário
+ */
+int trocarBloco(FilaPecas* fila, PilhaReserva* pilha, int k) {
+    EST_MARCAR_INICIO(inicioOperacao);
+    
+    // Validações: fila e pilha devem ter pelo menos k peças
+    if (k < 1 || k > fila->tamanho) {
+        EST_FALHA(EST_FALHA_TROCA_MULTIPLA_FILA);
+        emitirEvento(EVT_TROCA_MULTIPLA, EVT_ERRO_TAMANHO_FILA, 0, k, 0, -1);
+        exibirMensagem("\nErro: A fila nao tem %d pecas para trocar.\n", k);
+        return 0;
+    }
+    
+    if (k > pilha->topo + 1) {
+        EST_FALHA(EST_FALHA_TROCA_MULTIPLA_PILHA);
+        emitirEvento(EVT_TROCA_MULTIPLA, EVT_ERRO_TAMANHO_PILHA, 0, k, 0, -1);
+        exibirMensagem("\nErro: A pilha nao tem %d pecas para trocar.\n", k);
+        return 0;
+    }
+    
+    permutarBloco(fila, pilha, k);
+    EST_REGISTRAR(EST_TROCA_MULTIPLA, inicioOperacao);
+    
+    emitirEvento(EVT_TROCA_MULTIPLA, EVT_OK, 0, k, 0, -1);
+    exibirMensagem("\nTroca realizada: %d primeiros da fila <-> %d do topo da pilha\n", k, k);
+    
+    return 1; // Troca bem-sucedida
+}
+#endif // NIVEL >= 3
+
+// ============================================================================
+// IMPLEMENTAÇÃO DAS FUNÇÕES AUXILIARES
+// ============================================================================
+
+/**
+ * Gera uma nova peça com tipo aleatório e ID único
+ * @return Nova peça gerada
+ */
+Peca gerarPeca() {
+    Peca novaPeca;
+    char tipos[] = {'I', 'O', 'T', 'L'};
+    
+#if NIVEL >= 3
+    if (sequenciaPecas.mapa != NULL) {
+        // Sequência pré-gerada: o id é a posição da peça no arquivo
+        // (ao fim do arquivo a sequência recomeça, mantendo os ids crescentes)
+        novaPeca.nome = tipos[tipoNaSequencia(&sequenciaPecas, proximoId % sequenciaPecas.numPecas)];
+        novaPeca.id = proximoId++;
+        return novaPeca;
+    }
+#endif
+    
+    // Seleciona um tipo aleatório
+    novaPeca.nome = tipos[rand() % 4];
+    
+    // Atribui ID único e incrementa para a próxima peça
+    novaPeca.id = proximoId++;
+    
+    return novaPeca;
+}
+
+#if NIVEL >= 3
+/**
+ * Calcula um checksum (FNV-1a de 64 bits) do estado completo: peças da fila
+ * na ordem da frente para o final, seguidas das peças da pilha da base ao topo
+ * @param fila Ponteiro para a estrutura da fila
+ * @param pilha Ponteiro para a estrutura da pilha
+ * @return Checksum do estado
+ */
+unsigned long long checksumEstado(FilaPecas* fila, PilhaReserva* pilha) {
+    unsigned long long hash = 14695981039346656037ULL;
+    
+    // Mistura um valor de 32 bits no hash, byte a byte
+    #define MISTURAR(valor) \
+        for (int b = 0; b < 4; b++) { \
+            hash ^= ((unsigned int)(valor) >> (8 * b)) & 0xFF; \
+            hash *= 1099511628211ULL; \
+        }
+    
+    MISTURAR(fila->tamanho);
+    int indice = fila->frente;
+    for (int i = 0; i < fila->tamanho; i++) {
+        MISTURAR(fila->pecas[indice].nome);
+        MISTURAR(fila->pecas[indice].id);
+        indice = (indice + 1) % CAPACIDADE_FILA;
+    }
+    MISTURAR(pilha->topo + 1);
+    for (int i = 0; i <= pilha->topo; i++) {
+        MISTURAR(pilha->pecas[i].nome);
+        MISTURAR(pilha->pecas[i].id);
+    }
+    
+    #undef MISTURAR
+    return hash;
+}
+
+/**
+ * Registra o evento de fim de sessão com o checksum do estado final
+ * @param fila Ponteiro para a estrutura da fila
+ * @param pilha Ponteiro para a estrutura da pilha
+ */
+void registrarFimSessao(FilaPecas* fila, PilhaReserva* pilha) {
+    unsigned long long checksum = checksumEstado(fila, pilha);
+    emitirEvento(EVT_FIM, EVT_OK, 0, (int)(checksum & 0xFFFFFFFF), 0, (int)(checksum >> 32));
+    finalizarEventos();
+    fecharPublicadorEspectador();
+}
+
+/**
+ * Publica o estado atual para os espectadores (--espectador); sem
+ * publicador configurado, retorna imediatamente
+ * @param fila Ponteiro para a estrutura da fila
+ * @param pilha Ponteiro para a estrutura da pilha
+ */
+void publicarEspectador(FilaPecas* fila, PilhaReserva* pilha) {
+    EstadoEspectador* estado = iniciarPublicacaoEspectador();
+    if (estado == NULL) {
+        return;
+    }
+    RAST_INICIO(RAST_PUBLICACAO);
+    
+    estado->tamanhoFila = (uint32_t)fila->tamanho;
+    int indice = fila->frente;
+    for (int i = 0; i < fila->tamanho; i++) {
+        estado->fila[i].nome = fila->pecas[indice].nome;
+        estado->fila[i].id = fila->pecas[indice].id;
+        indice = (indice + 1) % CAPACIDADE_FILA;
+    }
+    estado->tamanhoPilha = (uint32_t)(pilha->topo + 1);
+    for (int i = 0; i <= pilha->topo; i++) {
+        estado->pilha[i].nome = pilha->pecas[i].nome;
+        estado->pilha[i].id = pilha->pecas[i].id;
+    }
+    
+    estado->ultimoTipo = resumoEventos.operacoes > 0 ? resumoEventos.ultima.tipo : EVT_INICIO;
+    estado->ultimoResultado = resumoEventos.ultima.resultado;
+    estado->ultimoNomeA = resumoEventos.ultima.nomeA;
+    estado->ultimoIdA = resumoEventos.ultima.idA;
+    estado->ultimoNomeB = resumoEventos.ultima.nomeB;
+    estado->ultimoIdB = resumoEventos.ultima.idB;
+    estado->operacoes = resumoEventos.operacoes;
+    estado->falhas = resumoEventos.falhas;
+    estado->pecasGeradas = (uint64_t)proximoId;
+    estado->ativa = 1;
+    
+    concluirPublicacaoEspectador();
+    RAST_FIM(RAST_PUBLICACAO);
+}
+#endif // NIVEL >= 3
+
+#if NIVEL >= 2
+/**
+ * Exibe o estado completo do sistema (fila + pilha)
+ * @param fila Ponteiro para a estrutura da fila
+ * @param pilha Ponteiro para a estrutura da pilha
+ */
+void exibirEstadoCompleto(FilaPecas* fila, PilhaReserva* pilha) {
+    printf("\n=== ESTADO ATUAL ===\n");
+    exibirFila(fila);
+    exibirPilha(pilha);
+}
+
+/**
+ * Exibe apenas a parte do estado alterada desde o último desenho (a fila,
+ * a pilha ou ambas) e limpa as marcas; se nada mudou, não escreve nada
+ * @param fila Ponteiro para a estrutura da fila
+ * @param pilha Ponteiro para a estrutura da pilha
+ * @return 1 se algo foi exibido, 0 caso contrário
+ */
+int exibirEstadoAlterado(FilaPecas* fila, PilhaReserva* pilha) {
+    if (fila->sujo == 0 && pilha->sujo == 0) {
+        return 0;
+    }
+    
+    printf("\n=== ESTADO ATUAL ===\n");
+    if (fila->sujo != 0) {
+        exibirFila(fila);
+    }
+    if (pilha->sujo != 0) {
+        exibirPilha(pilha);
+    }
+    fila->sujo = 0;
+    pilha->sujo = 0;
+    return 1;
+}
+#endif
+
+#if NIVEL >= 3
+/**
+ * Exibe uma mensagem de resultado de operação. No modo texto ela é impressa
+ * normalmente; no modo tempo real vai para a linha de status da tela.
+ * @param formato Formato no estilo printf
+ */
+void exibirMensagem(const char* formato, ...) {
+    va_list args;
+    va_start(args, formato);
+    
+    if (modoSilencioso) {
+        // Mensagens suprimidas
+    } else if (!modoTempoReal) {
+        vprintf(formato, args);
+    } else {
+        registrarStatusTempoReal(formato, args);
+    }
+    
+    va_end(args);
+}
+#endif // NIVEL >= 3
+
+/**
+ * Exibe o menu de opções para o usuário
+ */
+void exibirMenu() {
+#if NIVEL == 1
+    printf("\nOpcoes de acao:\n");
+    printf("1 - Jogar peca (dequeue)\n");
+    printf("2 - Inserir nova peca (enqueue)\n");
+    printf("0 - Sair\n");
+    printf("Escolha uma opcao: ");
+#elif NIVEL == 2
+    printf("\nOpcoes de acao:\n");
+    printf("1 - Jogar peca\n");
+    printf("2 - Reservar peca\n");
+    printf("3 - Usar peca reservada\n");
+    printf("0 - Sair\n");
+    printf("Opcao: ");
+#else
+    printf("\nOpcoes disponiveis:\n");
+    printf("1 - Jogar peca da frente da fila\n");
+    printf("2 - Enviar peca da fila para a pilha de reserva\n");
+    printf("3 - Usar peca da pilha de reserva\n");
+    printf("4 - Trocar peca da frente da fila com o topo da pilha\n");
+    printf("5 - Trocar os %d primeiros da fila com as %d pecas da pilha\n", CAPACIDADE_PILHA, CAPACIDADE_PILHA);
+    printf("6 - Exibir estado atual\n");
+    printf("7 - Trocar os k primeiros da fila com os k do topo da pilha\n");
+    printf("0 - Sair\n");
+    printf("Opcao escolhida: ");
+#endif
+}
+
+/**
+ * Obtém a opção escolhida pelo usuário
+ * @return Opção escolhida (0 a OPCAO_MAXIMA); 0 (sair) no fim da entrada,
+ *         por exemplo quando o jogador de uma sessão remota desconecta;
+ *         -1 (inválida) se a linha não começa com um número
+ */
+int obterOpcao() {
+    int opcao;
+    if (scanf("%d", &opcao) != 1) {
+        if (feof(stdin)) {
+            return 0;
+        }
+        int caractere;
+        while ((caractere = getchar()) != '\n' && caractere != EOF); // Descarta a linha
+        return -1;
+    }
+    return opcao;
+}
+
+#if NIVEL >= 3
+// ============================================================================
+// MODO TEMPO REAL
+// ============================================================================
+
+// Parâmetros do laço de atualização
+#define TEMPO_REAL_HZ        60          // Atualizações (e quadros) por segundo
+#define QUADROS_POR_LINHA    30          // Gravidade: a peça desce uma linha a cada 30 quadros
+#define ALTURA_POCO          12          // Linhas do poço por onde a peça cai
+
+// Dimensões da tela desenhada
+#define TELA_LINHAS          (ALTURA_POCO + 8)
+#define TELA_COLUNAS         64
+
+/**
+ * Estado do modo tempo real: a peça da frente da fila cai pelo poço e é
+ * jogada automaticamente ao chegar ao fundo
+ */
+typedef struct {
+    int alturaQueda;        // Linha atual da peça em queda (0 = topo do poço)
+    int quadrosAteDescer;   // Quadros restantes até a próxima descida
+    int pecasJogadas;       // Peças jogadas (queda, jogada direta ou reserva usada)
+    int rodando;            // 0 quando o jogador pede para sair
+} EstadoTempoReal;
+
+// Conteúdo exibido no terminal e conteúdo do próximo quadro
+static char telaAtual[TELA_LINHAS][TELA_COLUNAS];
+static char telaNova[TELA_LINHAS][TELA_COLUNAS];
+
+// Última mensagem de operação, mostrada na linha de status
+static char mensagemStatus[TELA_COLUNAS + 1];
+static int statusAlterado = 0;  // Mensagem nova desde o último quadro
+
+// Configuração original do terminal, restaurada ao sair
+static struct termios terminalOriginal;
+static int terminalAlterado = 0;
+// Sequência que mostra o cursor abaixo da tela, montada ao ativar o modo cru:
+// o tratador de sinal só pode chamar write(), não snprintf()
+static char sequenciaRestauracao[32];
+static int tamanhoRestauracao = 0;
+
+/**
+ * Guarda a mensagem de uma operação para a linha de status
+ * (sem as quebras de linha usadas no modo texto)
+ * @param formato Formato no estilo printf
+ * @param args Argumentos do formato
+ */
+void registrarStatusTempoReal(const char* formato, va_list args) {
+    char texto[256];
+    vsnprintf(texto, sizeof(texto), formato, args);
+    
+    // Remove quebras de linha do início e do fim
+    char* inicio = texto;
+    while (*inicio == '\n') {
+        inicio++;
+    }
+    size_t tamanho = strlen(inicio);
+    while (tamanho > 0 && inicio[tamanho - 1] == '\n') {
+        inicio[--tamanho] = '\0';
+    }
+    
+    snprintf(mensagemStatus, sizeof(mensagemStatus), "%s", inicio);
+    statusAlterado = 1;
+}
+
+/**
+ * Restaura o terminal ao modo original (linha a linha, com eco)
+ */
+static void restaurarTerminal(void) {
+    if (terminalAlterado) {
+        tcsetattr(STDIN_FILENO, TCSAFLUSH, &terminalOriginal);
+        terminalAlterado = 0;
+        
+        // Mostra o cursor e posiciona abaixo da tela desenhada
+        if (write(STDOUT_FILENO, sequenciaRestauracao, tamanhoRestauracao) < 0) {
+            // Nada a fazer: o terminal já está sendo restaurado
+        }
+    }
+}
+
+/**
+ * Restaura o terminal antes de encerrar por sinal (Ctrl+C, kill)
+ * @param sinal Sinal recebido
+ */
+static void tratarSinalTempoReal(int sinal) {
+    restaurarTerminal();
+    removerNomeEspectador();
+    signal(sinal, SIG_DFL);
+    raise(sinal);
+}
+
+/**
+ * Coloca o terminal em modo cru: teclas chegam uma a uma, sem eco e sem
+ * esperar Enter
+ * @return 1 se bem-sucedido, 0 se a entrada não é um terminal
+ */
+static int ativarTerminalCru(void) {
+    if (!isatty(STDIN_FILENO) || tcgetattr(STDIN_FILENO, &terminalOriginal) != 0) {
+        return 0;
+    }
+    
+    struct termios cru = terminalOriginal;
+    cru.c_lflag &= ~(ICANON | ECHO);
+    cru.c_iflag &= ~(IXON | ICRNL);
+    cru.c_cc[VMIN] = 0;
+    cru.c_cc[VTIME] = 0;
+    if (tcsetattr(STDIN_FILENO, TCSAFLUSH, &cru) != 0) {
+        return 0;
+    }
+    tamanhoRestauracao = snprintf(sequenciaRestauracao, sizeof(sequenciaRestauracao),
+                                  "\x1b[?25h\x1b[%d;1H\n", TELA_LINHAS + 1);
+    terminalAlterado = 1;
+    
+    atexit(restaurarTerminal);
+    signal(SIGINT, tratarSinalTempoReal);
+    signal(SIGTERM, tratarSinalTempoReal);
+    return 1;
+}
+
+/**
+ * Escreve um texto no quadro em construção, cortando no limite da linha
+ * @param linha Linha da tela (0 = primeira)
+ * @param coluna Coluna inicial
+ * @param formato Formato no estilo printf
+ */
+static void escreverTela(int linha, int coluna, const char* formato, ...) {
+    char texto[TELA_COLUNAS + 1];
+    va_list args;
+    va_start(args, formato);
+    vsnprintf(texto, sizeof(texto), formato, args);
+    va_end(args);
+    
+    for (int i = 0; texto[i] != '\0' && coluna + i < TELA_COLUNAS; i++) {
+        telaNova[linha][coluna + i] = texto[i];
+    }
+}
+
+/**
+ * Preenche um trecho de uma linha do quadro em construção com espaços
+ * @param linha Linha da tela
+ * @param coluna Coluna inicial
+ * @param largura Número de células
+ */
+static void limparTela(int linha, int coluna, int largura) {
+    memset(&telaNova[linha][coluna], ' ', largura);
+}
+
+/**
+ * Monta as partes fixas do quadro (bordas do poço, títulos e ajuda); as
+ * demais regiões são refeitas por montarQuadro conforme mudam
+ */
+static void montarMolduraQuadro(void) {
+    memset(telaNova, ' ', sizeof(telaNova));
+    for (int linha = 0; linha < ALTURA_POCO; linha++) {
+        escreverTela(linha + 1, 0, "|");
+        escreverTela(linha + 1, 6, "|");
+    }
+    escreverTela(ALTURA_POCO + 1, 0, "+-----+");
+    escreverTela(2, 10, "Fila:");
+    escreverTela(2, 30, "Pilha (topo):");
+    escreverTela(ALTURA_POCO + 5, 0, "espaco/j: jogar  r: reservar  u: usar reserva");
+    escreverTela(ALTURA_POCO + 6, 0, "s: troca simples  m: troca multipla  q: sair");
+}
+
+/**
+ * Redesenha a linha de uma posição da fila (0 = frente)
+ * @param fila Ponteiro para a estrutura da fila
+ * @param i Posição a partir da frente
+ */
+static void montarPosicaoFila(FilaPecas* fila, int i) {
+    limparTela(3 + i, 12, 18);
+    if (i < fila->tamanho) {
+        int indice = (fila->frente + i) % CAPACIDADE_FILA;
+        escreverTela(3 + i, 12, "[%c %d]", fila->pecas[indice].nome, fila->pecas[indice].id);
+    }
+}
+
+/**
+ * Redesenha a linha de uma posição da pilha (0 = topo)
+ * @param pilha Ponteiro para a estrutura da pilha
+ * @param i Posição a partir do topo
+ */
+static void montarPosicaoPilha(PilhaReserva* pilha, int i) {
+    limparTela(3 + i, 32, TELA_COLUNAS - 32);
+    if (i <= pilha->topo) {
+        escreverTela(3 + i, 32, "[%c %d]", pilha->pecas[pilha->topo - i].nome, pilha->pecas[pilha->topo - i].id);
+    } else if (i == 0) {
+        escreverTela(3, 32, "Vazia");
+    }
+}
+
+/**
+ * Monta o próximo quadro sobre o anterior: cabeçalho, poço com a peça em
+ * queda e status são refeitos sempre; da fila e da pilha, só as posições
+ * marcadas como alteradas (todas, se os índices mudaram)
+ * @param fila Ponteiro para a estrutura da fila
+ * @param pilha Ponteiro para a estrutura da pilha
+ * @param estado Estado do modo tempo real
+ */
+static void montarQuadro(FilaPecas* fila, PilhaReserva* pilha, EstadoTempoReal* estado) {
+    limparTela(0, 0, TELA_COLUNAS);
+    escreverTela(0, 0, "=== TETRIS STACK - TEMPO REAL ===   Jogadas: %d", estado->pecasJogadas);
+    
+    // Poço com a peça da frente da fila caindo
+    for (int linha = 0; linha < ALTURA_POCO; linha++) {
+        limparTela(linha + 1, 1, 5);
+    }
+    if (fila->tamanho > 0) {
+        escreverTela(estado->alturaQueda + 1, 2, "[%c]", fila->pecas[fila->frente].nome);
+    }
+    
+    // Fila e pilha ao lado do poço
+    for (int i = 0; i < CAPACIDADE_FILA; i++) {
+        int indice = (fila->frente + i) % CAPACIDADE_FILA;
+        if (fila->sujo & (SUJO_INDICES | SUJO_POSICAO(indice))) {
+            montarPosicaoFila(fila, i);
+        }
+    }
+    for (int i = 0; i < CAPACIDADE_PILHA; i++) {
+        if ((pilha->sujo & SUJO_INDICES) || (i <= pilha->topo && (pilha->sujo & SUJO_POSICAO(pilha->topo - i)))) {
+            montarPosicaoPilha(pilha, i);
+        }
+    }
+    fila->sujo = 0;
+    pilha->sujo = 0;
+    
+    limparTela(ALTURA_POCO + 3, 0, TELA_COLUNAS);
+    escreverTela(ALTURA_POCO + 3, 0, "%s", mensagemStatus);
+    statusAlterado = 0;
+}
+
+/**
+ * Escreve todo o buffer no terminal, repetindo em escritas parciais
+ */
+static void escreverSaidaQuadro(const char* saida, size_t n) {
+    size_t escrito = 0;
+    while (escrito < n) {
+        ssize_t r = write(STDOUT_FILENO, saida + escrito, n - escrito);
+        if (r <= 0) {
+            break;
+        }
+        escrito += (size_t)r;
+    }
+}
+
+/**
+ * Envia ao terminal apenas as células que mudaram desde o último quadro,
+ * usando posicionamento de cursor ANSI, normalmente em uma única escrita
+ * (o buffer só é descarregado antes se um quadro muito fragmentado o encher)
+ */
+static void apresentarQuadro(void) {
+    char saida[TELA_LINHAS * (TELA_COLUNAS + 16)];
+    size_t n = 0;
+    
+    for (int linha = 0; linha < TELA_LINHAS; linha++) {
+        int coluna = 0;
+        while (coluna < TELA_COLUNAS) {
+            if (telaNova[linha][coluna] == telaAtual[linha][coluna]) {
+                coluna++;
+                continue;
+            }
+            
+            // Agrupa a sequência de células alteradas em um único movimento de cursor
+            if (n + 32 > sizeof(saida)) {
+                escreverSaidaQuadro(saida, n);
+                n = 0;
+            }
+            n += snprintf(saida + n, sizeof(saida) - n, "\x1b[%d;%dH", linha + 1, coluna + 1);
+            while (coluna < TELA_COLUNAS && telaNova[linha][coluna] != telaAtual[linha][coluna]) {
+                if (n == sizeof(saida)) {
+                    escreverSaidaQuadro(saida, n);
+                    n = 0;
+                }
+                saida[n++] = telaNova[linha][coluna];
+                telaAtual[linha][coluna] = telaNova[linha][coluna];
+                coluna++;
+            }
+        }
+    }
+    
+    escreverSaidaQuadro(saida, n);
+}
+
+/**
+ * Joga a peça da frente da fila e repõe a fila (mesma lógica da opção 1)
+ * @param fila Ponteiro para a estrutura da fila
+ * @param estado Estado do modo tempo real
+ */
+static void jogarPecaTempoReal(FilaPecas* fila, EstadoTempoReal* estado) {
+    Peca peca;
+    EST_MARCAR_INICIO(inicioOperacao);
+    
+    if (dequeueFila(fila, &peca)) {
+        emitirEvento(EVT_JOGAR, EVT_OK, peca.nome, peca.id, 0, -1);
+        enqueueAutomatico(fila);
+        EST_REGISTRAR(EST_JOGAR, inicioOperacao);
+        exibirMensagem("Peca jogada: [%c %d]", peca.nome, peca.id);
+        estado->pecasJogadas++;
+    } else {
+        EST_FALHA(EST_FALHA_FILA_VAZIA);
+        emitirEvento(EVT_JOGAR, EVT_ERRO_FILA_VAZIA, 0, -1, 0, -1);
+    }
+    
+    // A nova peça da frente começa a cair do topo
+    estado->alturaQueda = 0;
+    estado->quadrosAteDescer = QUADROS_POR_LINHA;
+}
+
+/**
+ * Tamanho da sequência de escape no início de teclas: setas e teclas de
+ * função chegam como ESC [ ... (CSI) ou ESC O x no mesmo read
+ * @param teclas Bytes lidos, começando em um ESC
+ * @param restantes Bytes disponíveis a partir do ESC
+ * @return Número de bytes da sequência (1 se o ESC não inicia uma)
+ */
+static ssize_t tamanhoSequenciaEscape(const char* teclas, ssize_t restantes) {
+    if (restantes >= 2 && teclas[1] == '[') {
+        // Parâmetros e intermediários até o byte final (0x40 a 0x7E)
+        ssize_t i = 2;
+        while (i < restantes && (teclas[i] < 0x40 || teclas[i] > 0x7E)) {
+            i++;
+        }
+        return i < restantes ? i + 1 : restantes;
+    }
+    if (restantes >= 2 && teclas[1] == 'O') {
+        return restantes >= 3 ? 3 : restantes;
+    }
+    return 1;
+}
+
+/**
+ * Processa uma tecla do jogador
+ * @param tecla Tecla lida do terminal
+ * @param fila Ponteiro para a estrutura da fila
+ * @param pilha Ponteiro para a estrutura da pilha
+ * @param estado Estado do modo tempo real
+ */
+static void processarTecla(char tecla, FilaPecas* fila, PilhaReserva* pilha, EstadoTempoReal* estado) {
+    Peca peca;
+    EST_MARCAR_INICIO(inicioOperacao);
+    
+    switch (tecla) {
+        case ' ':
+        case 'j': // Jogada direta: a peça cai até o fundo imediatamente
+            jogarPecaTempoReal(fila, estado);
+            break;
+            
+        case 'r': // Reservar a peça em queda
+            if (pilhaCheia(pilha)) {
+                EST_FALHA(EST_FALHA_PILHA_CHEIA);
+                emitirEvento(EVT_RESERVAR, EVT_ERRO_PILHA_CHEIA, 0, -1, 0, -1);
+                exibirMensagem("Erro: Pilha de reserva cheia!");
+            } else if (dequeueFila(fila, &peca) && pushPilha(pilha, peca)) {
+                emitirEvento(EVT_RESERVAR, EVT_OK, peca.nome, peca.id, 0, -1);
+                enqueueAutomatico(fila);
+                EST_REGISTRAR(EST_RESERVAR, inicioOperacao);
+                exibirMensagem("Peca enviada para reserva: [%c %d]", peca.nome, peca.id);
+                estado->alturaQueda = 0;
+                estado->quadrosAteDescer = QUADROS_POR_LINHA;
+            }
+            break;
+            
+        case 'u': // Usar a peça do topo da reserva
+            if (popPilha(pilha, &peca)) {
+                emitirEvento(EVT_USAR_RESERVA, EVT_OK, peca.nome, peca.id, 0, -1);
+                EST_REGISTRAR(EST_USAR_RESERVA, inicioOperacao);
+                exibirMensagem("Peca da reserva usada: [%c %d]", peca.nome, peca.id);
+                estado->pecasJogadas++;
+            } else {
+                EST_FALHA(EST_FALHA_PILHA_VAZIA);
+                emitirEvento(EVT_USAR_RESERVA, EVT_ERRO_PILHA_VAZIA, 0, -1, 0, -1);
+                exibirMensagem("Erro: Pilha de reserva vazia!");
+            }
+            break;
+            
+        case 's':
+            trocarSimples(fila, pilha);
+            break;
+            
+        case 'm':
+            trocarMultipla(fila, pilha);
+            break;
+            
+        case 'q':
+        case 27: // ESC isolado (sequências de escape são descartadas antes)
+            estado->rodando = 0;
+            break;
+    }
+}
+
+/**
+ * Lê o relógio monotônico
+ * @return Tempo atual em nanossegundos
+ */
+static long long agoraNs(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (long long)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+/**
+ * Laço do modo tempo real: entrada não bloqueante via poll, atualização em
+ * passo fixo (gravidade) e redesenho apenas das células alteradas.
+ * Cada tecla é aplicada e desenhada assim que chega, sem esperar o próximo
+ * quadro, mantendo a latência entrada-tela abaixo de um quadro.
+ * @param fila Ponteiro para a estrutura da fila
+ * @param pilha Ponteiro para a estrutura da pilha
+ * @return Código de saída do programa
+ */
+int executarTempoReal(FilaPecas* fila, PilhaReserva* pilha) {
+    if (!ativarTerminalCru()) {
+        fprintf(stderr, "Erro: o modo tempo real precisa de um terminal interativo.\n");
+        return 1;
+    }
+    modoTempoReal = 1;
+    
+    EstadoTempoReal estado = {0, QUADROS_POR_LINHA, 0, 1};
+    const long long passoNs = 1000000000LL / TEMPO_REAL_HZ;
+    long long proximoPasso = agoraNs() + passoNs;
+    
+    // Limpa a tela, esconde o cursor e desenha o primeiro quadro completo
+    printf("\x1b[2J\x1b[?25l");
+    fflush(stdout);
+    memset(telaAtual, ' ', sizeof(telaAtual));
+    snprintf(mensagemStatus, sizeof(mensagemStatus), "Boa sorte!");
+    montarMolduraQuadro();
+    fila->sujo = SUJO_TUDO;
+    pilha->sujo = SUJO_TUDO;
+    montarQuadro(fila, pilha, &estado);
+    apresentarQuadro();
+    
+    while (estado.rodando) {
+        RAST_INICIO(RAST_ITERACAO);
+        
+        // Espera por uma tecla até o instante do próximo passo
+        RAST_INICIO(RAST_ENTRADA);
+        long long espera = proximoPasso - agoraNs();
+        if (espera < 0) {
+            espera = 0;
+        }
+        struct timespec limite = { espera / 1000000000LL, espera % 1000000000LL };
+        struct pollfd entrada = { STDIN_FILENO, POLLIN, 0 };
+        int pronto = ppoll(&entrada, 1, &limite, NULL);
+        RAST_FIM(RAST_ENTRADA);
+        
+        if (pronto > 0 && (entrada.revents & POLLIN)) {
+            char teclas[64];
+            RAST_INICIO(RAST_ENTRADA);
+            ssize_t lidas = read(STDIN_FILENO, teclas, sizeof(teclas));
+            RAST_FIM(RAST_ENTRADA);
+            if (lidas == 0) {
+                estado.rodando = 0; // Fim da entrada
+            }
+            RAST_INICIO(RAST_DESPACHO);
+            for (ssize_t i = 0; i < lidas && estado.rodando; i++) {
+                // ESC seguido de '[' ou 'O' é uma sequência (setas, F1...) e é
+                // ignorada; qualquer outro ESC (sozinho, após outras teclas,
+                // ESC ESC) é a tecla de sair
+                if (teclas[i] == 27 && i + 1 < lidas && (teclas[i + 1] == '[' || teclas[i + 1] == 'O')) {
+                    i += tamanhoSequenciaEscape(teclas + i, lidas - i) - 1;
+                    continue;
+                }
+                processarTecla(teclas[i], fila, pilha, &estado);
+            }
+            RAST_FIM(RAST_DESPACHO);
+            
+            // Teclas sem efeito (ou operações que falharam sem mensagem nova) não geram quadro
+            if (fila->sujo != 0 || pilha->sujo != 0 || statusAlterado) {
+                publicarEspectador(fila, pilha);
+                RAST_INICIO(RAST_DESENHO);
+                montarQuadro(fila, pilha, &estado);
+                apresentarQuadro();
+                RAST_FIM(RAST_DESENHO);
+            }
+        }
+        
+        // Atualizações em passo fixo, recuperando passos atrasados
+        RAST_INICIO(RAST_ATUALIZACAO);
+        int atualizou = 0;
+        long long agora = agoraNs();
+        while (agora >= proximoPasso && estado.rodando) {
+            if (--estado.quadrosAteDescer == 0) {
+                estado.quadrosAteDescer = QUADROS_POR_LINHA;
+                if (++estado.alturaQueda >= ALTURA_POCO) {
+                    jogarPecaTempoReal(fila, &estado); // Chegou ao fundo
+                }
+                atualizou = 1;
+            }
+            proximoPasso += passoNs;
+        }
+        RAST_FIM(RAST_ATUALIZACAO);
+        if (atualizou) {
+            publicarEspectador(fila, pilha);
+            RAST_INICIO(RAST_DESENHO);
+            montarQuadro(fila, pilha, &estado);
+            apresentarQuadro();
+            RAST_FIM(RAST_DESENHO);
+        }
+        
+        RAST_FIM(RAST_ITERACAO);
+    }
+    
+    restaurarTerminal();
+    modoTempoReal = 0;
+    registrarFimSessao(fila, pilha);
+    printf("Saindo do modo tempo real... Pecas jogadas: %d\n", estado.pecasJogadas);
+    return 0;
+}
+#endif // NIVEL >= 3
+
+// ============================================================================
+// PROGRAMA PRINCIPAL
+// ============================================================================
+
+// Textos de cada nível
+#if NIVEL == 1
+#define OPCAO_MAXIMA            2
+#define TEXTO_BOAS_VINDAS       "=== TETRIS STACK - FILA DE PECAS ===\n" \
+                                "Bem-vindo ao simulador da fila de pecas do Tetris Stack!\n"
+#define TEXTO_ERRO_JOGAR        "\nErro: Fila vazia! Nao e possivel jogar uma peca.\n"
+#define TEXTO_DESPEDIDA         "Obrigado por jogar Tetris Stack!\n"
+#define TEXTO_OPCAO_INVALIDA    "\nOpcao invalida! Por favor, escolha 0, 1 ou 2.\n"
+#elif NIVEL == 2
+#define OPCAO_MAXIMA            3
+#define TEXTO_BOAS_VINDAS       "=== TETRIS STACK - SISTEMA COMPLETO ===\n" \
+                                "Bem-vindo ao simulador completo do Tetris Stack!\n" \
+                                "Gerencie suas pecas usando a fila e a pilha de reserva.\n"
+#define TEXTO_ERRO_JOGAR        "\nErro: Nao foi possivel jogar a peca.\n"
+#define TEXTO_RESERVADA         "\nPeca reservada: [%c %d]\n"
+#define TEXTO_ERRO_RESERVAR     "\nErro: Nao foi possivel reservar a peca.\n"
+#define TEXTO_RESERVA_USADA     "\nPeca reservada usada: [%c %d]\n"
+#define TEXTO_DICA_RESERVA      "Reserve uma peca primeiro.\n"
+#define TEXTO_DESPEDIDA         "Obrigado por jogar Tetris Stack!\n"
+#define TEXTO_OPCAO_INVALIDA    "\nOpcao invalida! Por favor, escolha 0, 1, 2 ou 3.\n"
+#else
+#define OPCAO_MAXIMA            7
+#define TEXTO_BOAS_VINDAS       "=== TETRIS STACK - SISTEMA EXPERT ===\n" \
+                                "Bem-vindo ao simulador expert do Tetris Stack!\n" \
+                                "Gerencie suas pecas com operacoes avancadas de troca.\n"
+#define TEXTO_ERRO_JOGAR        "\nErro: Nao foi possivel jogar a peca.\n"
+#define TEXTO_RESERVADA         "\nPeca enviada para reserva: [%c %d]\n"
+#define TEXTO_ERRO_RESERVAR     "\nErro: Nao foi possivel enviar a peca para reserva.\n"
+#define TEXTO_RESERVA_USADA     "\nPeca da reserva usada: [%c %d]\n"
+#define TEXTO_DICA_RESERVA      "Envie uma peca para a reserva primeiro.\n"
+#define TEXTO_DESPEDIDA         "Obrigado por jogar Tetris Stack Expert!\n"
+#define TEXTO_OPCAO_INVALIDA    "\nOpcao invalida! Por favor, escolha uma opcao de 0 a 7.\n"
+#endif
+
+/**
+ * Laço principal de interação com o usuário no modo texto: exibe o estado
+ * e o menu, lê a opção e a executa até o jogador sair. Usado pelo main e
+ * por ferramentas que hospedam sessões já inicializadas (ex.: supervisor.c).
+ * @param fila Ponteiro para a fila já preenchida
+ * @param pilha Ponteiro para a pilha já inicializada (a partir do nível 2)
+ * @return Código de saída do programa
+ */
+#if NIVEL == 1
+int executarModoTexto(FilaPecas* fila) {
+#else
+int executarModoTexto(FilaPecas* fila, PilhaReserva* pilha) {
+#endif
+    // Variáveis para controle do loop e operações
+    int opcao;
+    Peca pecaProcessada;
+    
+    printf(TEXTO_BOAS_VINDAS);
+    
+    // Loop principal do programa
+    do {
+        RAST_INICIO(RAST_ITERACAO);
+        
+        // Exibe o que mudou no estado (nada, se a última opção falhou)
+        RAST_INICIO(RAST_DESENHO);
+#if NIVEL == 1
+        if (fila->sujo != 0) {
+            exibirFila(fila);
+            fila->sujo = 0;
+        }
+#else
+        exibirEstadoAlterado(fila, pilha);
+#endif
+        
+        // Exibe o menu e obtém a opção do usuário
+        exibirMenu();
+        RAST_FIM(RAST_DESENHO);
+        RAST_INICIO(RAST_ENTRADA);
+        opcao = obterOpcao();
+        RAST_FIM(RAST_ENTRADA);
+        EST_MARCAR_INICIO(inicioOperacao);
+        
+        // Processa a opção escolhida
+        RAST_INICIO(RAST_DESPACHO);
+        switch (opcao) {
+            case 1: // Jogar peça da frente da fila
+                if (dequeueFila(fila, &pecaProcessada)) {
+                    emitirEvento(EVT_JOGAR, EVT_OK, pecaProcessada.nome, pecaProcessada.id, 0, -1);
+#if NIVEL >= 2
+                    // Gera automaticamente uma nova peça para manter a fila cheia
+                    enqueueAutomatico(fila);
+#endif
+                    EST_REGISTRAR(EST_JOGAR, inicioOperacao);
+                    printf("\nPeca jogada: [%c %d]\n", 
+                           pecaProcessada.nome, pecaProcessada.id);
+#if NIVEL >= 2
+                    printf("Nova peca gerada automaticamente para a fila.\n");
+#endif
+                } else {
+                    EST_FALHA(EST_FALHA_FILA_VAZIA);
+                    emitirEvento(EVT_JOGAR, EVT_ERRO_FILA_VAZIA, 0, -1, 0, -1);
+                    printf(TEXTO_ERRO_JOGAR);
+                }
+                break;
+                
+#if NIVEL == 1
+            case 2: // Inserir nova peça no final da fila
+                if (fila->tamanho < CAPACIDADE_FILA) {
+                    RAST_INICIO(RAST_GERACAO);
+                    pecaProcessada = gerarPeca();
+                    RAST_FIM(RAST_GERACAO);
+                    enqueueFila(fila, pecaProcessada);
+                    printf("\nNova peca inserida: [%c %d]\n", 
+                           pecaProcessada.nome, pecaProcessada.id);
+                } else {
+                    printf("\nErro: Fila cheia! Nao e possivel inserir nova peca.\n");
+                    printf("Jogue uma peca primeiro para liberar espaco.\n");
+                }
+                break;
+#else
+            case 2: // Enviar peça da fila para a pilha de reserva
+                if (pilhaCheia(pilha)) {
+                    EST_FALHA(EST_FALHA_PILHA_CHEIA);
+                    emitirEvento(EVT_RESERVAR, EVT_ERRO_PILHA_CHEIA, 0, -1, 0, -1);
+                    printf("\nErro: Pilha de reserva cheia! Nao e possivel reservar mais pecas.\n");
+                    printf("Use uma peca reservada primeiro para liberar espaco.\n");
+                } else if (dequeueFila(fila, &pecaProcessada)) {
+                    if (pushPilha(pilha, pecaProcessada)) {
+                        emitirEvento(EVT_RESERVAR, EVT_OK, pecaProcessada.nome, pecaProcessada.id, 0, -1);
+                        
+                        // Gera automaticamente uma nova peça para manter a fila cheia
+                        enqueueAutomatico(fila);
+                        EST_REGISTRAR(EST_RESERVAR, inicioOperacao);
+                        printf(TEXTO_RESERVADA, pecaProcessada.nome, pecaProcessada.id);
+                        printf("Nova peca gerada automaticamente para a fila.\n");
+                    } else {
+                        printf(TEXTO_ERRO_RESERVAR);
+                    }
+                } else {
+                    emitirEvento(EVT_RESERVAR, EVT_ERRO_FILA_VAZIA, 0, -1, 0, -1);
+                    printf("\nErro: Nao foi possivel remover peca da fila.\n");
+                }
+                break;
+                
+            case 3: // Usar peça da pilha de reserva
+                if (popPilha(pilha, &pecaProcessada)) {
+                    emitirEvento(EVT_USAR_RESERVA, EVT_OK, pecaProcessada.nome, pecaProcessada.id, 0, -1);
+                    EST_REGISTRAR(EST_USAR_RESERVA, inicioOperacao);
+                    printf(TEXTO_RESERVA_USADA, pecaProcessada.nome, pecaProcessada.id);
+                } else {
+                    EST_FALHA(EST_FALHA_PILHA_VAZIA);
+                    emitirEvento(EVT_USAR_RESERVA, EVT_ERRO_PILHA_VAZIA, 0, -1, 0, -1);
+                    printf("\nErro: Pilha de reserva vazia! Nao ha pecas reservadas para usar.\n");
+                    printf(TEXTO_DICA_RESERVA);
+                }
+                break;
+#endif
+                
+#if NIVEL >= 3
+            case 4: // Trocar peça da frente da fila com o topo da pilha
+                trocarSimples(fila, pilha);
+                break;
+                
+            case 5: // Trocar os primeiros da fila com todas as peças da pilha
+                trocarMultipla(fila, pilha);
+                break;
+                
+            case 7: // Trocar os k primeiros da fila com os k do topo da pilha
+                printf("\nQuantas pecas trocar (1 a %d)? ", CAPACIDADE_PILHA);
+                trocarBloco(fila, pilha, obterOpcao());
+                break;
+                
+            case 6: // Exibir estado atual
+                printf("\nExibindo estado atual do sistema...\n");
+                // O estado completo será exibido no início do próximo loop
+                fila->sujo = SUJO_TUDO;
+                pilha->sujo = SUJO_TUDO;
+                break;
+#endif
+                
+            case 0: // Sair
+                printf("\nSaindo do programa...\n");
+                printf(TEXTO_DESPEDIDA);
+                break;
+                
+            default: // Opção inválida
+                printf(TEXTO_OPCAO_INVALIDA);
+                break;
+        }
+        RAST_FIM(RAST_DESPACHO);
+        
+#if NIVEL >= 3
+        publicarEspectador(fila, pilha);
+#endif
+        
+        // Pausa para melhor visualização (apenas em modo interativo)
+        if (opcao >= 1 && opcao <= OPCAO_MAXIMA) {
+            printf("\nPressione Enter para continuar...");
+            RAST_INICIO(RAST_ENTRADA);
+            int caractere;
+            while ((caractere = getchar()) != '\n' && caractere != EOF); // Limpa o buffer de entrada
+            RAST_FIM(RAST_ENTRADA);
+        }
+        
+        RAST_FIM(RAST_ITERACAO);
+    } while (opcao != 0);
+    
+#if NIVEL >= 3
+    registrarFimSessao(fila, pilha);
+#endif
+    
+    return 0;
+}
+
+// Ferramentas que reutilizam a lógica deste arquivo o incluem com
+// MESTRE_SEM_MAIN definido (ex.: bench_lote.c)
+#ifndef MESTRE_SEM_MAIN
+
+/**
+ * Função principal do programa Tetris Stack
+ * Implementa o loop principal de interação com o usuário
+ * Argumentos opcionais (nível 3):
+ *   --tempo-real         executa o modo tempo real com teclas únicas
+ *   --eventos-bin ARQ    grava o fluxo de eventos em formato binário
+ *   --eventos-json ARQ   grava o fluxo de eventos em JSON Lines
+ *   --sequencia ARQ      lê as peças de um arquivo de sequência pré-gerado
+ *   --espectador NOME    publica o estado em memória compartilhada (/dev/shm/NOME)
+ */
+int main(int argc, char* argv[]) {
+#if NIVEL >= 3
+    int tempoReal = 0;
+    
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--tempo-real") == 0) {
+            tempoReal = 1;
+        } else if ((strcmp(argv[i], "--eventos-bin") == 0 ||
+                    strcmp(argv[i], "--eventos-json") == 0) && i + 1 < argc &&
+                   emissor.formato == EMISSOR_DESATIVADO) {
+            // Um segundo --eventos-* cai no uso: só há um fluxo por sessão
+            FormatoEmissor formato = argv[i][10] == 'b' ? EMISSOR_BINARIO : EMISSOR_JSON;
+            if (!iniciarEventos(argv[i + 1], formato, CAPACIDADE_FILA, CAPACIDADE_PILHA)) {
+                fprintf(stderr, "Erro: nao foi possivel abrir o arquivo de eventos '%s'.\n", argv[i + 1]);
+                return 1;
+            }
+            i++;
+        } else if (strcmp(argv[i], "--sequencia") == 0 && i + 1 < argc) {
+            if (!abrirSequencia(argv[i + 1], &sequenciaPecas)) {
+                fprintf(stderr, "Erro: arquivo de sequencia invalido '%s'.\n", argv[i + 1]);
+                return 1;
+            }
+            i++;
+        } else if (strcmp(argv[i], "--espectador") == 0 && i + 1 < argc &&
+                   segmentoEspectador == NULL) {
+            // Um segundo --espectador cai no uso: só há um segmento por sessão
+            if (!abrirPublicadorEspectador(argv[i + 1], CAPACIDADE_FILA, CAPACIDADE_PILHA)) {
+                if (errno == EEXIST) {
+                    fprintf(stderr, "Erro: o segmento de espectador '%s' ja esta em uso por outra sessao.\n",
+                            argv[i + 1]);
+                } else {
+                    fprintf(stderr, "Erro: nao foi possivel criar o segmento de espectador '%s'.\n", argv[i + 1]);
+                }
+                return 1;
+            }
+            i++;
+        } else {
+            fprintf(stderr, "Uso: %s [--tempo-real] [--eventos-bin ARQ | --eventos-json ARQ] "
+                            "[--sequencia ARQ] [--espectador NOME]\n", argv[0]);
+            return 1;
+        }
+    }
+#else
+    // Os níveis 1 e 2 não têm opções de linha de comando
+    (void)argc;
+    (void)argv;
+#endif
+    
+    // Inicializa o gerador de números aleatórios
+    srand(time(NULL));
+    
+    // Instala o despejo de estatísticas e a exportação do rastreamento
+    // (sem efeito se compilados fora)
+    EST_INSTALAR();
+    RAST_INSTALAR();
+    
+    // Declara e inicializa as estruturas
+    FilaPecas fila;
+    inicializarFila(&fila);
+#if NIVEL >= 2
+    PilhaReserva pilha;
+    inicializarPilha(&pilha);
+#endif
+#if NIVEL >= 3
+    publicarEspectador(&fila, &pilha);
+    
+    if (tempoReal) {
+        return executarTempoReal(&fila, &pilha);
+    }
+#endif
+    
+#if NIVEL == 1
+    return executarModoTexto(&fila);
+#else
+    return executarModoTexto(&fila, &pilha);
+#endif
+}
+
+#endif // MESTRE_SEM_MAIN
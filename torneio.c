@@ -0,0 +1,506 @@
+/*
+ * TETRIS STACK - TORNEIO DE POLÍTICAS
+ *
+ * Compara políticas de reserva/troca jogando partidas (regras em partida.h)
+ * com as mesmas sementes para todas. Cada par (política, semente) é uma
+ * tarefa; como a duração das partidas varia muito, as tarefas são
+ * distribuídas em um pool de threads com roubo de trabalho (deques de
+ * Chase-Lev): cada thread consome a própria deque pelo fundo e, quando ela
+ * esvazia, rouba tarefas do topo da deque de outra thread.
+ *
+ * Os resultados vão para um buffer próprio de cada thread, sem travas, e são
+ * reduzidos no final em um ranking com intervalos de confiança de 95%.
+ *
+ * Uso: torneio [SEMENTES] [THREADS] [SEMENTE_INICIAL]
+ * Compilação: gcc -O2 torneio.c -o torneio -lpthread -lm
+ */
+
+#define MESTRE_SEM_MAIN
+#include "mestre.c"
+
+#include <limits.h>
+#include <math.h>
+#include <pthread.h>
+#include <stdint.h>
+
+#include "partida.h"
+
+// ============================================================================
+// POLÍTICAS
+// ============================================================================
+
+static inline uint64_t sortearTorneio(uint64_t* estado) {
+    uint64_t x = *estado;
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    return *estado = x;
+}
+
+/**
+ * Sempre joga a frente da fila
+ */
+static AcaoPartida politicaSempreJogar(const Partida* partida, char demanda, int acoesRestantes, uint64_t* rng) {
+    (void)partida; (void)demanda; (void)acoesRestantes; (void)rng;
+    return ACAO_JOGAR;
+}
+
+/**
+ * Joga a frente ou usa o topo da reserva, o que servir; se nenhum servir,
+ * guarda a frente na reserva enquanto houver espaço e ações no turno
+ */
+static AcaoPartida politicaReservaGulosa(const Partida* partida, char demanda, int acoesRestantes, uint64_t* rng) {
+    (void)rng;
+    if (tipoNaFila(partida, 0) == demanda) {
+        return ACAO_JOGAR;
+    }
+    if (tipoNaPilha(partida, 0) == demanda) {
+        return ACAO_USAR_RESERVA;
+    }
+    if (acoesRestantes > 1 && !pilhaCheia((PilhaReserva*)&partida->pilha)) {
+        return ACAO_RESERVAR;
+    }
+    return ACAO_JOGAR;
+}
+
+/**
+ * Reserva gulosa que, com a reserva cheia, usa a troca múltipla para
+ * trazer as peças guardadas de volta à fila
+ */
+static AcaoPartida politicaReservaComTroca(const Partida* partida, char demanda, int acoesRestantes, uint64_t* rng) {
+    if (tipoNaFila(partida, 0) != demanda && tipoNaPilha(partida, 0) != demanda &&
+        acoesRestantes > 1 && pilhaCheia((PilhaReserva*)&partida->pilha)) {
+        // Depois da troca múltipla, a frente passa a ser o antigo topo (que não serve),
+        // mas a segunda posição é a peça logo abaixo dele
+        if (tipoNaPilha(partida, 1) == demanda) {
+            return ACAO_TROCA_MULTIPLA;
+        }
+    }
+    return politicaReservaGulosa(partida, demanda, acoesRestantes, rng);
+}
+
+/**
+ * Escolhe ações ao acaso (base de comparação)
+ */
+static AcaoPartida politicaAleatoria(const Partida* partida, char demanda, int acoesRestantes, uint64_t* rng) {
+    (void)partida; (void)demanda; (void)acoesRestantes;
+    return (AcaoPartida)(sortearTorneio(rng) % NUM_ACOES);
+}
+
+/**
+ * Variedade de tipos ao alcance no próximo turno: tipos distintos entre a
+ * frente da fila e o topo da pilha (peso maior) e entre as duas primeiras
+ * posições da fila e toda a pilha. Só olha posições já visíveis antes do turno.
+ */
+static int variedadePartida(const Partida* partida) {
+    int imediatos = 0, alcance = 0;
+    char candidatos[2 + CAPACIDADE_PILHA];
+    int n = 0;
+
+    candidatos[n++] = tipoNaFila(partida, 0);
+    candidatos[n++] = tipoNaFila(partida, 1);
+    for (int i = 0; i <= partida->pilha.topo; i++) {
+        candidatos[n++] = tipoNaPilha(partida, i);
+    }
+
+    for (int t = 0; t < 4; t++) {
+        char tipo = tiposPartida[t];
+        imediatos += candidatos[0] == tipo || (partida->pilha.topo >= 0 && candidatos[2] == tipo);
+        for (int i = 0; i < n; i++) {
+            if (candidatos[i] == tipo) {
+                alcance++;
+                break;
+            }
+        }
+    }
+    return 10 * imediatos + alcance;
+}
+
+/**
+ * Valor do melhor plano que começa com a ação indicada
+ * @return Valor (INT_MIN se a ação é inválida ou não dá para colocar a tempo)
+ */
+static int valorPlano(const Partida* partida, AcaoPartida acao, char demanda, int acoesRestantes) {
+    Partida copia = *partida;
+    Peca colocada;
+
+    if ((acoesRestantes == 1 && !acaoColocaPeca(acao)) || !aplicarAcaoPartida(&copia, acao, &colocada)) {
+        return INT_MIN;
+    }
+    if (acaoColocaPeca(acao)) {
+        return (colocada.nome == demanda ? 1000 : 0) + variedadePartida(&copia);
+    }
+
+    int melhor = INT_MIN;
+    for (int proxima = 0; proxima < NUM_ACOES; proxima++) {
+        int valor = valorPlano(&copia, (AcaoPartida)proxima, demanda, acoesRestantes - 1);
+        if (valor > melhor) {
+            melhor = valor;
+        }
+    }
+    return melhor;
+}
+
+/**
+ * Testa todas as sequências de ações que cabem no turno e segue a que coloca
+ * o tipo pedido deixando mais variedade para o próximo turno
+ */
+static AcaoPartida politicaPlanejadora(const Partida* partida, char demanda, int acoesRestantes, uint64_t* rng) {
+    (void)rng;
+    AcaoPartida melhorAcao = ACAO_JOGAR;
+    int melhorValor = INT_MIN;
+
+    for (int acao = 0; acao < NUM_ACOES; acao++) {
+        int valor = valorPlano(partida, (AcaoPartida)acao, demanda, acoesRestantes);
+        if (valor > melhorValor) {
+            melhorValor = valor;
+            melhorAcao = (AcaoPartida)acao;
+        }
+    }
+    return melhorAcao;
+}
+
+/**
+ * Políticas inscritas no torneio
+ */
+static const struct {
+    const char* nome;
+    PoliticaPartida decidir;
+} politicas[] = {
+    { "sempre_jogar",      politicaSempreJogar },
+    { "aleatoria",         politicaAleatoria },
+    { "reserva_gulosa",    politicaReservaGulosa },
+    { "reserva_com_troca", politicaReservaComTroca },
+    { "planejadora",       politicaPlanejadora },
+};
+
+#define NUM_POLITICAS ((int)(sizeof(politicas) / sizeof(politicas[0])))
+
+// ============================================================================
+// DEQUE DE CHASE-LEV
+// ============================================================================
+
+#define TAREFA_VAZIA    (-1)    // Deque vazia
+#define TAREFA_DISPUTA  (-2)    // Roubo perdeu a disputa para outra thread
+
+/**
+ * Deque de tarefas de uma thread. A dona empilha e desempilha no fundo;
+ * as outras threads roubam do topo. A capacidade é fixa (as tarefas são
+ * todas conhecidas no início).
+ */
+typedef struct {
+    int64_t topo __attribute__((aligned(64)));      // Alterado pelos ladrões (CAS)
+    int64_t fundo __attribute__((aligned(64)));     // Alterado só pela dona
+    int64_t* tarefas;
+    int64_t mascara;                                // Capacidade - 1 (potência de 2)
+} DequeTarefas;
+
+static void criarDeque(DequeTarefas* deque, size_t capacidadeMinima) {
+    size_t capacidade = 1;
+    while (capacidade < capacidadeMinima) {
+        capacidade <<= 1;
+    }
+    deque->topo = 0;
+    deque->fundo = 0;
+    deque->tarefas = malloc(sizeof(int64_t) * capacidade);
+    deque->mascara = (int64_t)capacidade - 1;
+}
+
+/**
+ * Insere uma tarefa no fundo (somente a dona)
+ */
+static void empilharTarefa(DequeTarefas* deque, int64_t tarefa) {
+    int64_t fundo = __atomic_load_n(&deque->fundo, __ATOMIC_RELAXED);
+    __atomic_store_n(&deque->tarefas[fundo & deque->mascara], tarefa, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    __atomic_store_n(&deque->fundo, fundo + 1, __ATOMIC_RELAXED);
+}
+
+/**
+ * Retira a tarefa do fundo (somente a dona)
+ * @return Tarefa ou TAREFA_VAZIA
+ */
+static int64_t desempilharTarefa(DequeTarefas* deque) {
+    int64_t fundo = __atomic_load_n(&deque->fundo, __ATOMIC_RELAXED) - 1;
+    __atomic_store_n(&deque->fundo, fundo, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    int64_t topo = __atomic_load_n(&deque->topo, __ATOMIC_RELAXED);
+
+    if (topo > fundo) {
+        // Deque vazia: desfaz a reserva
+        __atomic_store_n(&deque->fundo, fundo + 1, __ATOMIC_RELAXED);
+        return TAREFA_VAZIA;
+    }
+
+    int64_t tarefa = __atomic_load_n(&deque->tarefas[fundo & deque->mascara], __ATOMIC_RELAXED);
+    if (topo == fundo) {
+        // Última tarefa: disputa com os ladrões pelo topo
+        if (!__atomic_compare_exchange_n(&deque->topo, &topo, topo + 1, 0,
+                                         __ATOMIC_SEQ_CST, __ATOMIC_RELAXED)) {
+            tarefa = TAREFA_VAZIA;
+        }
+        __atomic_store_n(&deque->fundo, fundo + 1, __ATOMIC_RELAXED);
+    }
+    return tarefa;
+}
+
+/**
+ * Rouba a tarefa do topo (qualquer outra thread)
+ * @return Tarefa, TAREFA_VAZIA ou TAREFA_DISPUTA
+ */
+static int64_t roubarTarefa(DequeTarefas* deque) {
+    int64_t topo = __atomic_load_n(&deque->topo, __ATOMIC_ACQUIRE);
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    int64_t fundo = __atomic_load_n(&deque->fundo, __ATOMIC_ACQUIRE);
+
+    if (topo >= fundo) {
+        return TAREFA_VAZIA;
+    }
+    int64_t tarefa = __atomic_load_n(&deque->tarefas[topo & deque->mascara], __ATOMIC_RELAXED);
+    if (!__atomic_compare_exchange_n(&deque->topo, &topo, topo + 1, 0,
+                                     __ATOMIC_SEQ_CST, __ATOMIC_RELAXED)) {
+        return TAREFA_DISPUTA;
+    }
+    return tarefa;
+}
+
+// ============================================================================
+// POOL DE THREADS
+// ============================================================================
+
+/**
+ * Resultado de uma partida
+ */
+typedef struct {
+    int politica;
+    int pontos;
+    int turnos;
+} ResultadoPartida;
+
+/**
+ * Estado de cada thread: deque, buffer de resultados e contadores.
+ * Alinhado para que threads vizinhas não disputem a mesma linha de cache.
+ */
+typedef struct {
+    DequeTarefas deque;
+    ResultadoPartida* resultados;   // Escrito só por esta thread
+    size_t numResultados;
+    size_t roubos;
+    pthread_t thread;
+    int indice;
+} __attribute__((aligned(64))) Trabalhador;
+
+/**
+ * Dados compartilhados do torneio (somente leitura durante a execução,
+ * exceto o contador de tarefas pendentes)
+ */
+typedef struct {
+    Trabalhador* trabalhadores;
+    int numTrabalhadores;
+    int numSementes;
+    uint64_t sementeInicial;
+    int64_t pendentes;              // Tarefas ainda não concluídas (atômico)
+    pthread_barrier_t largada;      // Todas as threads começam juntas
+} Torneio;
+
+static Torneio torneio;
+
+/**
+ * Joga a partida de uma tarefa e guarda o resultado no buffer da thread
+ * @param trabalhador Thread que executa
+ * @param tarefa Índice da tarefa (política * sementes + semente)
+ */
+static void executarTarefa(Trabalhador* trabalhador, int64_t tarefa) {
+    int politica = (int)(tarefa / torneio.numSementes);
+    uint64_t semente = torneio.sementeInicial + (uint64_t)(tarefa % torneio.numSementes);
+
+    // Gerador das políticas aleatórias derivado da tarefa: o resultado não
+    // depende de qual thread executou a partida
+    uint64_t rng = misturar64((uint64_t)tarefa) | 1;
+
+    Partida partida;
+    iniciarPartida(&partida, semente);
+    while (jogarTurnoPartida(&partida, politicas[politica].decidir, &rng)) {
+    }
+
+    ResultadoPartida* resultado = &trabalhador->resultados[trabalhador->numResultados++];
+    resultado->politica = politica;
+    resultado->pontos = partida.pontos;
+    resultado->turnos = partida.turno;
+    __atomic_fetch_sub(&torneio.pendentes, 1, __ATOMIC_RELEASE);
+}
+
+/**
+ * Laço de cada thread: esvazia a própria deque e depois rouba das outras
+ * até todas as tarefas terminarem
+ * @param argumento Ponteiro para o Trabalhador
+ * @return NULL
+ */
+static void* threadTrabalhador(void* argumento) {
+    Trabalhador* trabalhador = argumento;
+    uint64_t rng = misturar64((uint64_t)trabalhador->indice + 1);
+
+    pthread_barrier_wait(&torneio.largada);
+
+    for (;;) {
+        int64_t tarefa = desempilharTarefa(&trabalhador->deque);
+        if (tarefa >= 0) {
+            executarTarefa(trabalhador, tarefa);
+            continue;
+        }
+
+        if (__atomic_load_n(&torneio.pendentes, __ATOMIC_ACQUIRE) == 0) {
+            break;
+        }
+
+        // Tenta vítimas a partir de uma posição sorteada
+        int inicio = (int)(sortearTorneio(&rng) % (uint64_t)torneio.numTrabalhadores);
+        for (int i = 0; i < torneio.numTrabalhadores; i++) {
+            Trabalhador* vitima = &torneio.trabalhadores[(inicio + i) % torneio.numTrabalhadores];
+            if (vitima == trabalhador) {
+                continue;
+            }
+            tarefa = roubarTarefa(&vitima->deque);
+            if (tarefa >= 0) {
+                trabalhador->roubos++;
+                executarTarefa(trabalhador, tarefa);
+                break;
+            }
+        }
+        if (tarefa < 0) {
+            sched_yield();
+        }
+    }
+    return NULL;
+}
+
+// ============================================================================
+// REDUÇÃO E RANKING
+// ============================================================================
+
+/**
+ * Estatísticas de uma política
+ */
+typedef struct {
+    int politica;
+    size_t partidas;
+    double somaPontos;
+    double somaQuadrados;
+    double somaTurnos;
+    double media;
+    double margem;          // Meia largura do intervalo de 95%
+} Classificacao;
+
+static int compararClassificacao(const void* a, const void* b) {
+    const Classificacao* x = a;
+    const Classificacao* y = b;
+    return (x->media < y->media) - (x->media > y->media);
+}
+
+static double agoraSegundos(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// ============================================================================
+// PROGRAMA PRINCIPAL
+// ============================================================================
+
+int main(int argc, char* argv[]) {
+    int numSementes = argc > 1 ? atoi(argv[1]) : 1000;
+    long numThreads = argc > 2 ? strtol(argv[2], NULL, 10) : sysconf(_SC_NPROCESSORS_ONLN);
+    uint64_t sementeInicial = argc > 3 ? strtoull(argv[3], NULL, 10) : 1;
+    if (argc > 4 || numSementes < 2 || numThreads < 1) {
+        fprintf(stderr, "Uso: %s [SEMENTES >= 2] [THREADS] [SEMENTE_INICIAL]\n", argv[0]);
+        return 1;
+    }
+
+    modoSilencioso = 1;
+
+    int64_t numTarefas = (int64_t)NUM_POLITICAS * numSementes;
+    torneio.numTrabalhadores = (int)numThreads;
+    torneio.numSementes = numSementes;
+    torneio.sementeInicial = sementeInicial;
+    torneio.pendentes = numTarefas;
+    torneio.trabalhadores = aligned_alloc(64, sizeof(Trabalhador) * (size_t)numThreads);
+
+    // Distribuição inicial em blocos contíguos: cada thread começa com as
+    // partidas de poucas políticas, que têm durações bem diferentes; o
+    // roubo de trabalho corrige o desequilíbrio.
+    for (int t = 0; t < torneio.numTrabalhadores; t++) {
+        Trabalhador* trabalhador = &torneio.trabalhadores[t];
+        memset(trabalhador, 0, sizeof(*trabalhador));
+        trabalhador->indice = t;
+        criarDeque(&trabalhador->deque, (size_t)numTarefas);
+        trabalhador->resultados = malloc(sizeof(ResultadoPartida) * (size_t)numTarefas);
+
+        int64_t inicio = numTarefas * t / numThreads;
+        int64_t fim = numTarefas * (t + 1) / numThreads;
+        for (int64_t tarefa = fim - 1; tarefa >= inicio; tarefa--) {
+            empilharTarefa(&trabalhador->deque, tarefa);
+        }
+    }
+
+    pthread_barrier_init(&torneio.largada, NULL, (unsigned)numThreads);
+    double inicio = agoraSegundos();
+    for (int t = 0; t < torneio.numTrabalhadores; t++) {
+        pthread_create(&torneio.trabalhadores[t].thread, NULL, threadTrabalhador, &torneio.trabalhadores[t]);
+    }
+    for (int t = 0; t < torneio.numTrabalhadores; t++) {
+        pthread_join(torneio.trabalhadores[t].thread, NULL);
+    }
+    double segundos = agoraSegundos() - inicio;
+    pthread_barrier_destroy(&torneio.largada);
+
+    // Redução dos buffers das threads
+    Classificacao ranking[NUM_POLITICAS];
+    memset(ranking, 0, sizeof(ranking));
+    for (int p = 0; p < NUM_POLITICAS; p++) {
+        ranking[p].politica = p;
+    }
+    size_t totalPartidas = 0;
+    for (int t = 0; t < torneio.numTrabalhadores; t++) {
+        Trabalhador* trabalhador = &torneio.trabalhadores[t];
+        for (size_t i = 0; i < trabalhador->numResultados; i++) {
+            ResultadoPartida* resultado = &trabalhador->resultados[i];
+            Classificacao* c = &ranking[resultado->politica];
+            c->partidas++;
+            c->somaPontos += resultado->pontos;
+            c->somaQuadrados += (double)resultado->pontos * resultado->pontos;
+            c->somaTurnos += resultado->turnos;
+        }
+        totalPartidas += trabalhador->numResultados;
+    }
+
+    // Intervalo de 95% pela aproximação normal da média
+    for (int p = 0; p < NUM_POLITICAS; p++) {
+        Classificacao* c = &ranking[p];
+        double n = (double)c->partidas;
+        c->media = c->somaPontos / n;
+        double variancia = (c->somaQuadrados - n * c->media * c->media) / (n - 1);
+        c->margem = 1.96 * sqrt(variancia > 0 ? variancia : 0) / sqrt(n);
+    }
+    qsort(ranking, NUM_POLITICAS, sizeof(Classificacao), compararClassificacao);
+
+    printf("=== TORNEIO DE POLITICAS ===\n");
+    printf("Politicas: %d  Sementes: %d (a partir de %llu)  Partidas: %zu  Threads: %ld\n\n",
+           NUM_POLITICAS, numSementes, (unsigned long long)sementeInicial, totalPartidas, numThreads);
+    printf("Pos  %-18s %10s  %-21s %12s\n", "Politica", "Pontos", "IC 95%", "Turnos");
+    for (int i = 0; i < NUM_POLITICAS; i++) {
+        Classificacao* c = &ranking[i];
+        printf("%3d  %-18s %10.2f  [%8.2f, %8.2f]  %12.1f\n", i + 1, politicas[c->politica].nome,
+               c->media, c->media - c->margem, c->media + c->margem, c->somaTurnos / (double)c->partidas);
+    }
+
+    printf("\nThreads:");
+    for (int t = 0; t < torneio.numTrabalhadores; t++) {
+        printf(" %zu(%zu roubadas)", torneio.trabalhadores[t].numResultados, torneio.trabalhadores[t].roubos);
+        free(torneio.trabalhadores[t].deque.tarefas);
+        free(torneio.trabalhadores[t].resultados);
+    }
+    printf("\nTempo: %.3f s (%.0f partidas/s)\n", segundos, totalPartidas / segundos);
+
+    free(torneio.trabalhadores);
+    return totalPartidas == (size_t)numTarefas ? 0 : 1;
+}
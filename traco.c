@@ -0,0 +1,368 @@
+/*
+ * TETRIS STACK - TRAÇOS COMPACTOS
+ *
+ * Converte fluxos de eventos binários (--eventos-bin) para o formato de
+ * traco.h e de volta, e mede tamanho e velocidade do formato em uma partida
+ * longa simulada com as operações do mestre.c.
+ *
+ * Uso: traco converter EVENTOS... TRACO   (os fluxos são concatenados)
+ *      traco exportar TRACO EVENTOS
+ *      traco bench [NUM_EVENTOS] [SEMENTE]
+ * Compilação: gcc -O2 traco.c -o traco
+ */
+
+#define MESTRE_SEM_MAIN
+#include "mestre.c"
+
+#include <stdint.h>
+
+#include "traco.h"
+
+#define EVENTOS_POR_LOTE 4096
+
+// ============================================================================
+// CONVERSÃO
+// ============================================================================
+
+/**
+ * Acrescenta ao traço todos os eventos de um fluxo binário
+ * @return Número de eventos, ou -1 se o fluxo é inválido
+ */
+static long long converterFluxo(const char* caminho, EscritorTraco* escritor) {
+    int fd = open(caminho, O_RDONLY);
+    if (fd < 0) {
+        return -1;
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size < EVENTOS_TAM_CABECALHO) {
+        close(fd);
+        return -1;
+    }
+    const unsigned char* mapa = mmap(NULL, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (mapa == MAP_FAILED) {
+        return -1;
+    }
+    if (memcmp(mapa, EVENTOS_MAGICO, 4) != 0) {
+        munmap((void*)mapa, (size_t)info.st_size);
+        return -1;
+    }
+
+    long long numEventos = (info.st_size - EVENTOS_TAM_CABECALHO) / EVENTOS_TAM_QUADRO;
+    for (long long i = 0; i < numEventos; i++) {
+        Evento evento;
+        decodificarEvento(mapa + EVENTOS_TAM_CABECALHO + i * EVENTOS_TAM_QUADRO, &evento);
+        if (!escreverEventoTraco(escritor, &evento)) {
+            numEventos = -1;
+            break;
+        }
+    }
+    munmap((void*)mapa, (size_t)info.st_size);
+    return numEventos;
+}
+
+static int converter(int numFluxos, char* fluxos[], const char* saida) {
+    EscritorTraco escritor;
+    if (!abrirEscritorTraco(saida, &escritor)) {
+        fprintf(stderr, "Erro: nao foi possivel criar '%s'.\n", saida);
+        return 1;
+    }
+
+    long long total = 0;
+    for (int f = 0; f < numFluxos; f++) {
+        long long n = converterFluxo(fluxos[f], &escritor);
+        if (n < 0) {
+            fprintf(stderr, "Erro: fluxo de eventos invalido '%s'.\n", fluxos[f]);
+            fecharEscritorTraco(&escritor);
+            return 1;
+        }
+        total += n;
+    }
+    struct stat info;
+    if (!fecharEscritorTraco(&escritor) || stat(saida, &info) != 0) {
+        fprintf(stderr, "Erro: falha ao gravar '%s'.\n", saida);
+        return 1;
+    }
+    uint64_t tamanho = (uint64_t)info.st_size;
+
+    uint64_t tamanhoBruto = (uint64_t)total * EVENTOS_TAM_QUADRO;
+    printf("Eventos: %lld  Quadros: %.1f KiB  Traco: %.1f KiB  (%.1fx menor, %.2f bits/evento)\n",
+           total, tamanhoBruto / 1024.0, tamanho / 1024.0,
+           tamanho > 0 ? (double)tamanhoBruto / tamanho : 0.0, total > 0 ? 8.0 * tamanho / total : 0.0);
+    return 0;
+}
+
+static int exportar(const char* entrada, const char* saida) {
+    LeitorTraco leitor;
+    if (!abrirLeitorTraco(entrada, &leitor)) {
+        fprintf(stderr, "Erro: traco invalido '%s'.\n", entrada);
+        return 1;
+    }
+    int fd = open(saida, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        fprintf(stderr, "Erro: nao foi possivel criar '%s'.\n", saida);
+        fecharLeitorTraco(&leitor);
+        return 1;
+    }
+
+    // Cabeçalho do fluxo com as capacidades do primeiro evento de início
+    char cabecalho[EVENTOS_TAM_CABECALHO] = {0};
+    Evento primeiro;
+    memcpy(cabecalho, EVENTOS_MAGICO, 4);
+    escreverU16(cabecalho + 4, EVENTOS_VERSAO);
+    escreverU16(cabecalho + 6, EVENTOS_TAM_QUADRO);
+    if (lerEventosTraco(&leitor, &primeiro, 1) == 1 && primeiro.tipo == EVT_INICIO) {
+        escreverU16(cabecalho + 8, (uint16_t)primeiro.idA);
+        escreverU16(cabecalho + 10, (uint16_t)primeiro.idB);
+    }
+    posicionarTraco(&leitor, 0);
+
+    Evento* lote = malloc(sizeof(Evento) * EVENTOS_POR_LOTE);
+    char* quadros = malloc((size_t)EVENTOS_TAM_QUADRO * EVENTOS_POR_LOTE);
+    int ok = gravarTudoTraco(fd, cabecalho, sizeof(cabecalho));
+    size_t lidos;
+    while (ok && (lidos = lerEventosTraco(&leitor, lote, EVENTOS_POR_LOTE)) > 0) {
+        for (size_t i = 0; i < lidos; i++) {
+            char* quadro = quadros + i * EVENTOS_TAM_QUADRO;
+            escreverU32(quadro, lote[i].sequencia);
+            quadro[4] = (char)lote[i].tipo;
+            quadro[5] = (char)lote[i].resultado;
+            quadro[6] = lote[i].nomeA;
+            quadro[7] = lote[i].nomeB;
+            escreverU32(quadro + 8, (uint32_t)lote[i].idA);
+            escreverU32(quadro + 12, (uint32_t)lote[i].idB);
+        }
+        ok = gravarTudoTraco(fd, quadros, lidos * EVENTOS_TAM_QUADRO);
+    }
+
+    close(fd);
+    free(lote);
+    free(quadros);
+    uint64_t lidosTotal = leitor.posicao, numEventos = leitor.numEventos;
+    fecharLeitorTraco(&leitor);
+    if (!ok) {
+        fprintf(stderr, "Erro: falha ao gravar '%s'.\n", saida);
+        return 1;
+    }
+    if (lidosTotal != numEventos) {
+        fprintf(stderr, "Erro: traco corrompido '%s' (%llu de %llu eventos lidos).\n", entrada,
+                (unsigned long long)lidosTotal, (unsigned long long)numEventos);
+        return 1;
+    }
+    return 0;
+}
+
+// ============================================================================
+// BENCHMARK
+// ============================================================================
+
+static double segundosDesde(const struct timespec* inicio) {
+    struct timespec agora;
+    clock_gettime(CLOCK_MONOTONIC, &agora);
+    return (agora.tv_sec - inicio->tv_sec) + (agora.tv_nsec - inicio->tv_nsec) / 1e9;
+}
+
+static Evento eventoBench(uint32_t sequencia, TipoEvento tipo, ResultadoEvento resultado,
+                          char nome, int32_t id) {
+    Evento evento = { sequencia, (uint8_t)tipo, (uint8_t)resultado, nome, 0, id, -1 };
+    return evento;
+}
+
+/**
+ * Simula uma partida longa com as operações do mestre.c, gerando os mesmos
+ * eventos que o --eventos-bin gravaria
+ * @param eventos Recebe os eventos
+ * @param numEventos Número de eventos a gerar
+ * @param semente Semente do sorteio das peças e das operações
+ */
+static void simularEventos(Evento* eventos, size_t numEventos, unsigned semente) {
+    FilaPecas fila;
+    PilhaReserva pilha;
+    uint32_t n = 0;
+
+    srand(semente);
+    proximoId = 0;
+    fila.frente = 0;
+    fila.tras = 0;
+    fila.tamanho = 0;
+    inicializarPilha(&pilha);
+
+    eventos[n] = eventoBench(n, EVT_INICIO, EVT_OK, 0, CAPACIDADE_FILA);
+    eventos[n].idB = CAPACIDADE_PILHA;
+    n++;
+
+    // Um evento por volta (a peça reposta entra na volta seguinte); o último é "fim"
+    while (n + 1 < numEventos) {
+        Peca peca;
+        if (fila.tamanho < CAPACIDADE_FILA) {
+            peca = gerarPeca();
+            enqueueFila(&fila, peca);
+            eventos[n] = eventoBench(n, EVT_PECA_GERADA, EVT_OK, peca.nome, peca.id);
+            n++;
+            continue;
+        }
+
+        int sorteio = rand() % 100;
+        if (sorteio < 50) {
+            dequeueFila(&fila, &peca);
+            eventos[n] = eventoBench(n, EVT_JOGAR, EVT_OK, peca.nome, peca.id);
+        } else if (sorteio < 65) {
+            if (pilhaCheia(&pilha)) {
+                eventos[n] = eventoBench(n, EVT_RESERVAR, EVT_ERRO_PILHA_CHEIA, 0, -1);
+            } else {
+                dequeueFila(&fila, &peca);
+                pushPilha(&pilha, peca);
+                eventos[n] = eventoBench(n, EVT_RESERVAR, EVT_OK, peca.nome, peca.id);
+            }
+        } else if (sorteio < 80) {
+            if (popPilha(&pilha, &peca)) {
+                eventos[n] = eventoBench(n, EVT_USAR_RESERVA, EVT_OK, peca.nome, peca.id);
+            } else {
+                eventos[n] = eventoBench(n, EVT_USAR_RESERVA, EVT_ERRO_PILHA_VAZIA, 0, -1);
+            }
+        } else {
+            // Trocas: o evento emitido pela própria função fica no resumo
+            if (sorteio < 90) {
+                trocarSimples(&fila, &pilha);
+            } else if (sorteio < 95) {
+                trocarMultipla(&fila, &pilha);
+            } else {
+                trocarBloco(&fila, &pilha, 1 + rand() % CAPACIDADE_PILHA);
+            }
+            eventos[n] = resumoEventos.ultima;
+            eventos[n].sequencia = n;
+        }
+        n++;
+    }
+    unsigned long long checksum = checksumEstado(&fila, &pilha);
+    eventos[n] = eventoBench(n, EVT_FIM, EVT_OK, 0, (int32_t)(checksum & 0xFFFFFFFF));
+    eventos[n].idB = (int32_t)(checksum >> 32);
+}
+
+static int mesmoEvento(const Evento* a, const Evento* b) {
+    return a->sequencia == b->sequencia && a->tipo == b->tipo && a->resultado == b->resultado &&
+           a->nomeA == b->nomeA && a->nomeB == b->nomeB && a->idA == b->idA && a->idB == b->idB;
+}
+
+static int executarBench(size_t numEventos, unsigned semente) {
+    Evento* eventos = malloc(sizeof(Evento) * numEventos);
+    Evento* lote = malloc(sizeof(Evento) * EVENTOS_POR_LOTE);
+    char caminho[] = "/tmp/traco_bench_XXXXXX";
+    int fd = mkstemp(caminho);
+    if (eventos == NULL || lote == NULL || fd < 0) {
+        fprintf(stderr, "Erro: memoria ou arquivo temporario indisponivel.\n");
+        return 1;
+    }
+    close(fd);
+
+    simularEventos(eventos, numEventos, semente);
+
+    // Escrita
+    struct timespec inicio;
+    EscritorTraco escritor;
+    clock_gettime(CLOCK_MONOTONIC, &inicio);
+    if (!abrirEscritorTraco(caminho, &escritor)) {
+        fprintf(stderr, "Erro: nao foi possivel criar '%s'.\n", caminho);
+        return 1;
+    }
+    for (size_t i = 0; i < numEventos; i++) {
+        escreverEventoTraco(&escritor, &eventos[i]);
+    }
+    fecharEscritorTraco(&escritor);
+    double tempoEscrita = segundosDesde(&inicio);
+
+    LeitorTraco leitor;
+    if (!abrirLeitorTraco(caminho, &leitor)) {
+        fprintf(stderr, "Erro: traco gerado invalido.\n");
+        unlink(caminho);
+        return 1;
+    }
+
+    // Leitura sequencial: a primeira passada também confere os eventos
+    size_t divergencias = 0;
+    double melhorLeitura = 1e30;
+    for (int passada = 0; passada < 5; passada++) {
+        posicionarTraco(&leitor, 0);
+        size_t posicao = 0, lidos;
+        clock_gettime(CLOCK_MONOTONIC, &inicio);
+        while ((lidos = lerEventosTraco(&leitor, lote, EVENTOS_POR_LOTE)) > 0) {
+            if (passada == 0) {
+                for (size_t i = 0; i < lidos; i++) {
+                    divergencias += !mesmoEvento(&lote[i], &eventos[posicao + i]);
+                }
+            }
+            posicao += lidos;
+        }
+        double tempo = segundosDesde(&inicio);
+        if (passada > 0 && tempo < melhorLeitura) {
+            melhorLeitura = tempo;
+        }
+        if (posicao != numEventos) {
+            divergencias += numEventos - posicao;
+        }
+    }
+
+    // Acesso aleatório: posiciona e lê um evento
+    const int consultas = 10000;
+    uint64_t rng = semente * 0x9E3779B97F4A7C15ULL + 1;
+    clock_gettime(CLOCK_MONOTONIC, &inicio);
+    for (int c = 0; c < consultas; c++) {
+        rng ^= rng << 13;
+        rng ^= rng >> 7;
+        rng ^= rng << 17;
+        size_t posicao = (size_t)(rng % numEventos);
+        Evento evento;
+        if (!posicionarTraco(&leitor, posicao) || lerEventosTraco(&leitor, &evento, 1) != 1 ||
+            !mesmoEvento(&evento, &eventos[posicao])) {
+            divergencias++;
+        }
+    }
+    double tempoAleatorio = segundosDesde(&inicio);
+
+    uint64_t tamanho = leitor.tamanhoMapa;
+    uint64_t tamanhoBruto = (uint64_t)numEventos * sizeof(Evento);
+    printf("=== BENCHMARK DO FORMATO DE TRACOS ===\n");
+    printf("Eventos: %zu  Blocos: %u\n", numEventos, leitor.numBlocos);
+    printf("Tamanho: %.1f MiB (structs Evento: %.1f MiB, %.1fx menor, %.2f bits/evento)\n",
+           tamanho / 1048576.0, tamanhoBruto / 1048576.0, (double)tamanhoBruto / tamanho,
+           8.0 * tamanho / numEventos);
+    printf("Escrita: %.1f M eventos/s\n", numEventos / tempoEscrita / 1e6);
+    printf("Leitura sequencial: %.1f M eventos/s\n", numEventos / melhorLeitura / 1e6);
+    printf("Acesso aleatorio: %.1f us por posicionamento\n", tempoAleatorio / consultas * 1e6);
+    printf("Conferencia: %s\n", divergencias == 0 ? "todos os eventos identicos" : "DIVERGENCIAS");
+
+    fecharLeitorTraco(&leitor);
+    unlink(caminho);
+    free(eventos);
+    free(lote);
+    return divergencias == 0 ? 0 : 1;
+}
+
+// ============================================================================
+// PROGRAMA PRINCIPAL
+// ============================================================================
+
+int main(int argc, char* argv[]) {
+    modoSilencioso = 1;
+
+    if (argc >= 4 && strcmp(argv[1], "converter") == 0) {
+        return converter(argc - 3, argv + 2, argv[argc - 1]);
+    }
+    if (argc == 4 && strcmp(argv[1], "exportar") == 0) {
+        return exportar(argv[2], argv[3]);
+    }
+    if (argc >= 2 && argc <= 4 && strcmp(argv[1], "bench") == 0) {
+        long long numEventos = argc >= 3 ? atoll(argv[2]) : 16000000;
+        unsigned semente = argc == 4 ? (unsigned)strtoul(argv[3], NULL, 10) : 1;
+        if (numEventos < 2) {
+            fprintf(stderr, "Erro: o benchmark precisa de pelo menos 2 eventos.\n");
+            return 1;
+        }
+        return executarBench((size_t)numEventos, semente);
+    }
+
+    fprintf(stderr, "Uso: %s converter EVENTOS... TRACO\n"
+                    "       %s exportar TRACO EVENTOS\n"
+                    "       %s bench [NUM_EVENTOS] [SEMENTE]\n", argv[0], argv[0], argv[0]);
+    return 1;
+}
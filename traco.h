@@ -0,0 +1,1128 @@
+/*
+ * TETRIS STACK - FORMATO COMPACTO DE TRAÇOS
+ *
+ * Guarda longos fluxos de eventos (os mesmos Evento de eventos.h) em blocos
+ * colunares, bem menores que os quadros de 16 bytes do --eventos-bin, e
+ * permite ler a partir de qualquer posição.
+ *
+ * Quase toda a informação de um evento é previsível: os ids das peças
+ * geradas crescem de 1 em 1 e as peças jogadas, reservadas, usadas e
+ * trocadas são as que estão na frente da fila ou no topo da pilha. Escritor
+ * e leitor mantêm o mesmo modelo da fila e da pilha (ModeloTraco), atualizado
+ * a cada evento, e só gravam o que o modelo não acerta.
+ *
+ * Formato (little-endian):
+ *   Cabeçalho de 16 bytes: "TSTR", versão (u16), reservado.
+ *   Blocos de até TRACO_EVENTOS_POR_BLOCO eventos, cada um com:
+ *     u32 número de eventos | u32 sequência esperada do primeiro evento |
+ *     u32 tamanho de cada coluna (ops, tipos, resultados, desvios, brutos) |
+ *     modelo no início do bloco: u8 tamanho da fila, u8 tamanho da pilha,
+ *     i32 último id gerado, i32 último k, peças (u8 nome, i32 id) da fila
+ *     (frente -> final) e da pilha (base -> topo)
+ *     e as colunas:
+ *     - ops: 4 bits por evento (TRACO_OP_*)
+ *     - tipos: 2 bits por peça gerada (0 = I, 1 = O, 2 = T, 3 = L)
+ *     - resultados: 1 byte por operação que falhou
+ *     - desvios: peças que o modelo não previu, como varint(acertos antes)
+ *       seguido de u8 nome e varint zigzag (id - id previsto); termina com
+ *       varint(acertos restantes)
+ *     - brutos: quadros de 16 bytes (formato de eventos.h) dos eventos fora
+ *       do padrão (início, fim, sequência com salto, peças inesperadas)
+ *   Índice: u64 posição de cada bloco no arquivo.
+ *   Rodapé de 24 bytes: u64 posição do índice, u64 número de eventos,
+ *   "TSTI", u32 número de blocos.
+ *
+ * O evento de número n está no bloco n / TRACO_EVENTOS_POR_BLOCO; como cada
+ * bloco traz o modelo inicial, ele é decodificado sem depender dos
+ * anteriores, e o modelo do leitor é o estado da fila e da pilha após o
+ * último evento lido.
+ *
+ * O leitor não confia no arquivo: cada bloco precisa ter o número de eventos
+ * que a sua posição exige e colunas do tamanho que os seus ops consomem, e os
+ * varints nunca passam do fim da coluna de desvios. Um traço corrompido é
+ * lido até o ponto do defeito (posicao < numEventos no fim).
+ */
+
+#ifndef TRACO_H
+#define TRACO_H
+
+#include <fcntl.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "eventos.h"
+
+// ============================================================================
+// DEFINIÇÕES DO FORMATO
+// ============================================================================
+
+#define TRACO_MAGICO              "TSTR"
+#define TRACO_MAGICO_INDICE       "TSTI"
+#define TRACO_VERSAO              1
+#define TRACO_TAM_CABECALHO       16
+#define TRACO_TAM_RODAPE          24
+#define TRACO_EVENTOS_POR_BLOCO   4096
+#define TRACO_MAX_PECAS           64      // Peças do modelo por estrutura (potência de 2)
+
+/**
+ * Códigos de operação (4 bits). As operações com código próprio seguem o
+ * padrão do mestre.c: peças só nas operações bem-sucedidas, id -1 e nome 0
+ * nas demais, k em idA na troca múltipla.
+ */
+enum {
+    TRACO_OP_BRUTO = 0,                                 // Evento completo na coluna de brutos
+    TRACO_OP_OK = 0,                                    // + tipo (EVT_PECA_GERADA..EVT_TROCA_MULTIPLA)
+    TRACO_OP_FALHA = EVT_TROCA_MULTIPLA - EVT_PECA_GERADA + 1   // + tipo; resultado na coluna
+};
+
+/**
+ * Peça no modelo
+ */
+typedef struct {
+    char nome;
+    int32_t id;
+} PecaTraco;
+
+/**
+ * Modelo da fila e da pilha, mantido igual no escritor e no leitor
+ */
+typedef struct {
+    PecaTraco fila[TRACO_MAX_PECAS];        // Anel a partir de frente
+    PecaTraco pilha[TRACO_MAX_PECAS];       // Da base para o topo
+    uint32_t frente;
+    uint32_t tamanhoFila;
+    uint32_t tamanhoPilha;
+    int32_t ultimoIdGerado;
+    int32_t ultimoK;                    // k da última troca múltipla
+} ModeloTraco;
+
+static const char tiposTraco[4] = {'I', 'O', 'T', 'L'};
+
+// ============================================================================
+// MODELO
+// ============================================================================
+
+static inline void reiniciarModeloTraco(ModeloTraco* modelo) {
+    modelo->frente = 0;
+    modelo->tamanhoFila = 0;
+    modelo->tamanhoPilha = 0;
+    modelo->ultimoIdGerado = -1;
+    modelo->ultimoK = 0;
+}
+
+static inline PecaTraco* frenteModeloTraco(ModeloTraco* modelo, uint32_t i) {
+    return &modelo->fila[(modelo->frente + i) & (TRACO_MAX_PECAS - 1)];
+}
+
+/**
+ * Peça prevista na frente da fila ou no topo da pilha (nome 0 se vazia)
+ */
+static inline PecaTraco previsaoFilaTraco(ModeloTraco* modelo) {
+    PecaTraco vazia = { 0, -1 };
+    return modelo->tamanhoFila > 0 ? *frenteModeloTraco(modelo, 0) : vazia;
+}
+
+static inline PecaTraco previsaoPilhaTraco(const ModeloTraco* modelo) {
+    PecaTraco vazia = { 0, -1 };
+    return modelo->tamanhoPilha > 0 ? modelo->pilha[modelo->tamanhoPilha - 1] : vazia;
+}
+
+/**
+ * Aplica um evento ao modelo, com a mesma semântica das operações do mestre.c
+ * @param modelo Modelo a atualizar
+ * @param evento Evento (já com as peças reais)
+ */
+static inline void aplicarModeloTraco(ModeloTraco* modelo, const Evento* evento) {
+    PecaTraco pecaA = { evento->nomeA, evento->idA };
+    PecaTraco pecaB = { evento->nomeB, evento->idB };
+
+    if (evento->tipo == EVT_INICIO) {
+        reiniciarModeloTraco(modelo);
+        return;
+    }
+    if (evento->tipo == EVT_TROCA_MULTIPLA) {
+        modelo->ultimoK = evento->idA;
+    }
+    if (evento->resultado != EVT_OK) {
+        return;
+    }
+
+    switch (evento->tipo) {
+        case EVT_PECA_GERADA:
+            if (modelo->tamanhoFila < TRACO_MAX_PECAS) {
+                *frenteModeloTraco(modelo, modelo->tamanhoFila++) = pecaA;
+            }
+            modelo->ultimoIdGerado = evento->idA;
+            break;
+
+        case EVT_RESERVAR:
+            if (modelo->tamanhoPilha < TRACO_MAX_PECAS) {
+                modelo->pilha[modelo->tamanhoPilha++] = pecaA;
+            }
+            // fall through - a peça também sai da frente da fila
+        case EVT_JOGAR:
+            if (modelo->tamanhoFila > 0) {
+                modelo->frente = (modelo->frente + 1) & (TRACO_MAX_PECAS - 1);
+                modelo->tamanhoFila--;
+            }
+            break;
+
+        case EVT_USAR_RESERVA:
+            if (modelo->tamanhoPilha > 0) {
+                modelo->tamanhoPilha--;
+            }
+            break;
+
+        case EVT_TROCA_SIMPLES:
+            if (modelo->tamanhoFila > 0 && modelo->tamanhoPilha > 0) {
+                *frenteModeloTraco(modelo, 0) = pecaB;
+                modelo->pilha[modelo->tamanhoPilha - 1] = pecaA;
+            }
+            break;
+
+        case EVT_TROCA_MULTIPLA: {
+            // fila[frente + i] <-> pilha[topo - i]
+            uint32_t k = (uint32_t)evento->idA;
+            if (k <= modelo->tamanhoFila && k <= modelo->tamanhoPilha) {
+                for (uint32_t i = 0; i < k; i++) {
+                    PecaTraco* naFila = frenteModeloTraco(modelo, i);
+                    PecaTraco* naPilha = &modelo->pilha[modelo->tamanhoPilha - 1 - i];
+                    PecaTraco temp = *naFila;
+                    *naFila = *naPilha;
+                    *naPilha = temp;
+                }
+            }
+            break;
+        }
+    }
+}
+
+/**
+ * Tamanho do modelo serializado no cabeçalho do bloco
+ */
+static inline size_t tamanhoModeloTraco(const ModeloTraco* modelo) {
+    return 10 + 5 * (size_t)(modelo->tamanhoFila + modelo->tamanhoPilha);
+}
+
+static inline void escreverPecaTraco(unsigned char* destino, PecaTraco peca) {
+    destino[0] = (unsigned char)peca.nome;
+    escreverU32((char*)destino + 1, (uint32_t)peca.id);
+}
+
+static inline PecaTraco lerPecaTraco(const unsigned char* origem) {
+    PecaTraco peca = { (char)origem[0], (int32_t)lerU32(origem + 1) };
+    return peca;
+}
+
+static inline size_t serializarModeloTraco(ModeloTraco* modelo, unsigned char* destino) {
+    unsigned char* p = destino;
+    *p++ = (unsigned char)modelo->tamanhoFila;
+    *p++ = (unsigned char)modelo->tamanhoPilha;
+    escreverU32((char*)p, (uint32_t)modelo->ultimoIdGerado);
+    escreverU32((char*)p + 4, (uint32_t)modelo->ultimoK);
+    p += 8;
+    for (uint32_t i = 0; i < modelo->tamanhoFila; i++, p += 5) {
+        escreverPecaTraco(p, *frenteModeloTraco(modelo, i));
+    }
+    for (uint32_t i = 0; i < modelo->tamanhoPilha; i++, p += 5) {
+        escreverPecaTraco(p, modelo->pilha[i]);
+    }
+    return (size_t)(p - destino);
+}
+
+/**
+ * Lê o modelo serializado (no máximo "disponivel" bytes)
+ * @return Bytes lidos, ou 0 se o modelo é inválido
+ */
+static inline size_t desserializarModeloTraco(ModeloTraco* modelo, const unsigned char* origem, size_t disponivel) {
+    if (disponivel < 10 || origem[0] > TRACO_MAX_PECAS || origem[1] > TRACO_MAX_PECAS) {
+        return 0;
+    }
+    modelo->frente = 0;
+    modelo->tamanhoFila = origem[0];
+    modelo->tamanhoPilha = origem[1];
+    modelo->ultimoIdGerado = (int32_t)lerU32(origem + 2);
+    modelo->ultimoK = (int32_t)lerU32(origem + 6);
+    size_t tamanho = tamanhoModeloTraco(modelo);
+    if (tamanho > disponivel) {
+        return 0;
+    }
+    const unsigned char* p = origem + 10;
+    for (uint32_t i = 0; i < modelo->tamanhoFila; i++, p += 5) {
+        modelo->fila[i] = lerPecaTraco(p);
+    }
+    for (uint32_t i = 0; i < modelo->tamanhoPilha; i++, p += 5) {
+        modelo->pilha[i] = lerPecaTraco(p);
+    }
+    return tamanho;
+}
+
+// ============================================================================
+// VARINTS
+// ============================================================================
+
+static inline size_t escreverVarintTraco(unsigned char* destino, uint64_t valor) {
+    size_t n = 0;
+    while (valor >= 0x80) {
+        destino[n++] = (unsigned char)(valor | 0x80);
+        valor >>= 7;
+    }
+    destino[n++] = (unsigned char)valor;
+    return n;
+}
+
+/**
+ * Lê um varint sem passar de fim
+ * @param origem Posição de leitura (avança sobre o varint)
+ * @param fim Fim da coluna
+ * @param valor Recebe o valor
+ * @return 1 se bem-sucedido, 0 se o varint passa de fim ou de 10 bytes
+ */
+static inline int lerVarintTraco(const unsigned char** origem, const unsigned char* fim, uint64_t* valor) {
+    const unsigned char* p = *origem;
+    uint64_t lido = 0;
+    for (int deslocamento = 0; p < fim && deslocamento < 70; deslocamento += 7) {
+        unsigned char byte = *p++;
+        lido |= (uint64_t)(byte & 0x7F) << deslocamento;
+        if (!(byte & 0x80)) {
+            *origem = p;
+            *valor = lido;
+            return 1;
+        }
+    }
+    return 0;
+}
+
+static inline uint64_t zigzagTraco(int64_t valor) {
+    return ((uint64_t)valor << 1) ^ (uint64_t)(valor >> 63);
+}
+
+static inline int64_t desfazerZigzagTraco(uint64_t valor) {
+    return (int64_t)(valor >> 1) ^ -(int64_t)(valor & 1);
+}
+
+/**
+ * Código do tipo de uma peça gerada (0..3), ou -1 se não é I, O, T ou L
+ */
+static inline int codigoTipoTraco(char nome) {
+    switch (nome) {
+        case 'I': return 0;
+        case 'O': return 1;
+        case 'T': return 2;
+        case 'L': return 3;
+        default: return -1;
+    }
+}
+
+// ============================================================================
+// ESCRITOR
+// ============================================================================
+
+/**
+ * Escritor de traço: acumula as colunas do bloco atual e grava cada bloco
+ * completo com uma única escrita
+ */
+typedef struct {
+    int fd;
+    uint64_t posicaoArquivo;        // Bytes já gravados
+    uint64_t numEventos;
+    uint64_t* indice;               // Posição de cada bloco
+    size_t numBlocos;
+    size_t capacidadeIndice;
+
+    ModeloTraco modelo;
+    uint32_t sequenciaEsperada;
+    uint32_t eventosBloco;
+    uint32_t sequenciaInicialBloco;
+    uint32_t numTipos;
+    uint64_t acertos;               // Peças previstas desde o último desvio
+    size_t tamanhoModeloInicial;
+    size_t tamanhoResultados;
+    size_t tamanhoDesvios;
+    size_t tamanhoBrutos;
+    unsigned char* modeloInicial;
+    unsigned char* ops;
+    unsigned char* tipos;
+    unsigned char* resultados;
+    unsigned char* desvios;
+    unsigned char* brutos;
+    unsigned char* saida;           // Bloco montado para a escrita
+} EscritorTraco;
+
+#define TRACO_TAM_MODELO_MAX    (10 + 5 * 2 * TRACO_MAX_PECAS)
+#define TRACO_TAM_DESVIOS_MAX   (2 * TRACO_EVENTOS_POR_BLOCO * 9 + 8)   // Até 9 bytes por peça
+#define TRACO_TAM_BLOCO_MAX     (28 + TRACO_TAM_MODELO_MAX + TRACO_EVENTOS_POR_BLOCO / 2 + \
+                                 TRACO_EVENTOS_POR_BLOCO / 4 + TRACO_EVENTOS_POR_BLOCO + \
+                                 TRACO_TAM_DESVIOS_MAX + TRACO_EVENTOS_POR_BLOCO * EVENTOS_TAM_QUADRO)
+
+static inline int gravarTudoTraco(int fd, const void* dados, size_t tamanho) {
+    const char* p = dados;
+    while (tamanho > 0) {
+        ssize_t n = write(fd, p, tamanho);
+        if (n <= 0) {
+            return 0;
+        }
+        p += n;
+        tamanho -= (size_t)n;
+    }
+    return 1;
+}
+
+static inline void iniciarBlocoTraco(EscritorTraco* escritor) {
+    escritor->eventosBloco = 0;
+    escritor->sequenciaInicialBloco = escritor->sequenciaEsperada;
+    escritor->numTipos = 0;
+    escritor->acertos = 0;
+    escritor->tamanhoResultados = 0;
+    escritor->tamanhoDesvios = 0;
+    escritor->tamanhoBrutos = 0;
+    escritor->tamanhoModeloInicial = serializarModeloTraco(&escritor->modelo, escritor->modeloInicial);
+    memset(escritor->ops, 0, TRACO_EVENTOS_POR_BLOCO / 2);
+    memset(escritor->tipos, 0, TRACO_EVENTOS_POR_BLOCO / 4);
+}
+
+/**
+ * Cria um arquivo de traço
+ * @param caminho Caminho do arquivo de saída
+ * @param escritor Escritor a inicializar
+ * @return 1 se bem-sucedido, 0 caso contrário
+ */
+static inline int abrirEscritorTraco(const char* caminho, EscritorTraco* escritor) {
+    memset(escritor, 0, sizeof(*escritor));
+    escritor->fd = open(caminho, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (escritor->fd < 0) {
+        return 0;
+    }
+
+    escritor->modeloInicial = malloc(TRACO_TAM_MODELO_MAX);
+    escritor->ops = malloc(TRACO_EVENTOS_POR_BLOCO / 2);
+    escritor->tipos = malloc(TRACO_EVENTOS_POR_BLOCO / 4);
+    escritor->resultados = malloc(TRACO_EVENTOS_POR_BLOCO);
+    escritor->desvios = malloc(TRACO_TAM_DESVIOS_MAX);
+    escritor->brutos = malloc((size_t)TRACO_EVENTOS_POR_BLOCO * EVENTOS_TAM_QUADRO);
+    escritor->saida = malloc(TRACO_TAM_BLOCO_MAX);
+    if (escritor->modeloInicial == NULL || escritor->ops == NULL || escritor->tipos == NULL ||
+        escritor->resultados == NULL || escritor->desvios == NULL || escritor->brutos == NULL ||
+        escritor->saida == NULL) {
+        close(escritor->fd);
+        return 0;
+    }
+
+    unsigned char cabecalho[TRACO_TAM_CABECALHO] = {0};
+    memcpy(cabecalho, TRACO_MAGICO, 4);
+    escreverU16((char*)cabecalho + 4, TRACO_VERSAO);
+    if (!gravarTudoTraco(escritor->fd, cabecalho, sizeof(cabecalho))) {
+        close(escritor->fd);
+        return 0;
+    }
+    escritor->posicaoArquivo = TRACO_TAM_CABECALHO;
+
+    reiniciarModeloTraco(&escritor->modelo);
+    iniciarBlocoTraco(escritor);
+    return 1;
+}
+
+/**
+ * Monta e grava o bloco atual (se não estiver vazio)
+ * @return 1 se bem-sucedido, 0 em erro de escrita
+ */
+static inline int gravarBlocoTraco(EscritorTraco* escritor) {
+    if (escritor->eventosBloco == 0) {
+        return 1;
+    }
+    escritor->tamanhoDesvios += escreverVarintTraco(escritor->desvios + escritor->tamanhoDesvios, escritor->acertos);
+
+    uint32_t tamanhoOps = (escritor->eventosBloco + 1) / 2;
+    uint32_t tamanhoTipos = (escritor->numTipos + 3) / 4;
+    char* p = (char*)escritor->saida;
+    escreverU32(p, escritor->eventosBloco);
+    escreverU32(p + 4, escritor->sequenciaInicialBloco);
+    escreverU32(p + 8, tamanhoOps);
+    escreverU32(p + 12, tamanhoTipos);
+    escreverU32(p + 16, (uint32_t)escritor->tamanhoResultados);
+    escreverU32(p + 20, (uint32_t)escritor->tamanhoDesvios);
+    escreverU32(p + 24, (uint32_t)escritor->tamanhoBrutos);
+    p += 28;
+
+    #define COPIAR(origem, tamanho) do { memcpy(p, (origem), (tamanho)); p += (tamanho); } while (0)
+    COPIAR(escritor->modeloInicial, escritor->tamanhoModeloInicial);
+    COPIAR(escritor->ops, tamanhoOps);
+    COPIAR(escritor->tipos, tamanhoTipos);
+    COPIAR(escritor->resultados, escritor->tamanhoResultados);
+    COPIAR(escritor->desvios, escritor->tamanhoDesvios);
+    COPIAR(escritor->brutos, escritor->tamanhoBrutos);
+    #undef COPIAR
+
+    size_t tamanho = (size_t)(p - (char*)escritor->saida);
+    if (!gravarTudoTraco(escritor->fd, escritor->saida, tamanho)) {
+        return 0;
+    }
+
+    if (escritor->numBlocos == escritor->capacidadeIndice) {
+        escritor->capacidadeIndice = escritor->capacidadeIndice ? 2 * escritor->capacidadeIndice : 256;
+        escritor->indice = realloc(escritor->indice, sizeof(uint64_t) * escritor->capacidadeIndice);
+    }
+    escritor->indice[escritor->numBlocos++] = escritor->posicaoArquivo;
+    escritor->posicaoArquivo += tamanho;
+
+    iniciarBlocoTraco(escritor);
+    return 1;
+}
+
+/**
+ * Registra uma peça: conta um acerto se o modelo a previu, senão grava o desvio
+ */
+static inline void codificarPecaTraco(EscritorTraco* escritor, PecaTraco prevista, char nome, int32_t id) {
+    if (nome == prevista.nome && id == prevista.id) {
+        escritor->acertos++;
+        return;
+    }
+    unsigned char* d = escritor->desvios + escritor->tamanhoDesvios;
+    d += escreverVarintTraco(d, escritor->acertos);
+    *d++ = (unsigned char)nome;
+    d += escreverVarintTraco(d, zigzagTraco((int64_t)id - prevista.id));
+    escritor->tamanhoDesvios = (size_t)(d - escritor->desvios);
+    escritor->acertos = 0;
+}
+
+/**
+ * Verifica se o evento segue o padrão das operações do mestre.c
+ * (senão ele é gravado inteiro na coluna de brutos)
+ */
+static inline int eventoPadraoTraco(const EscritorTraco* escritor, const Evento* evento) {
+    if (evento->sequencia != escritor->sequenciaEsperada ||
+        evento->tipo < EVT_PECA_GERADA || evento->tipo > EVT_TROCA_MULTIPLA ||
+        evento->resultado >= EVT_NUM_RESULTADOS) {
+        return 0;
+    }
+    if (evento->tipo == EVT_TROCA_MULTIPLA) {
+        return evento->nomeA == 0 && evento->nomeB == 0 && evento->idB == -1;
+    }
+    if (evento->resultado != EVT_OK) {
+        return evento->tipo != EVT_PECA_GERADA && evento->nomeA == 0 && evento->idA == -1 &&
+               evento->nomeB == 0 && evento->idB == -1;
+    }
+    if (evento->tipo == EVT_PECA_GERADA && codigoTipoTraco(evento->nomeA) < 0) {
+        return 0;
+    }
+    if (evento->tipo == EVT_TROCA_SIMPLES) {
+        return evento->nomeA != 0 && evento->nomeB != 0;
+    }
+    return evento->nomeA != 0 && evento->nomeB == 0 && evento->idB == -1;
+}
+
+/**
+ * Acrescenta um evento ao traço
+ * @param escritor Escritor aberto
+ * @param evento Evento a gravar
+ * @return 1 se bem-sucedido, 0 em erro de escrita
+ */
+static inline int escreverEventoTraco(EscritorTraco* escritor, const Evento* evento) {
+    uint32_t indice = escritor->eventosBloco;
+    ModeloTraco* modelo = &escritor->modelo;
+    unsigned op;
+
+    if (!eventoPadraoTraco(escritor, evento)) {
+        op = TRACO_OP_BRUTO;
+        char* quadro = (char*)escritor->brutos + escritor->tamanhoBrutos;
+        escreverU32(quadro, evento->sequencia);
+        quadro[4] = (char)evento->tipo;
+        quadro[5] = (char)evento->resultado;
+        quadro[6] = evento->nomeA;
+        quadro[7] = evento->nomeB;
+        escreverU32(quadro + 8, (uint32_t)evento->idA);
+        escreverU32(quadro + 12, (uint32_t)evento->idB);
+        escritor->tamanhoBrutos += EVENTOS_TAM_QUADRO;
+    } else if (evento->resultado != EVT_OK) {
+        op = TRACO_OP_FALHA + evento->tipo;
+        escritor->resultados[escritor->tamanhoResultados++] = evento->resultado;
+        if (evento->tipo == EVT_TROCA_MULTIPLA) {
+            PecaTraco previsto = { 0, modelo->ultimoK };
+            codificarPecaTraco(escritor, previsto, 0, evento->idA);
+        }
+    } else {
+        op = TRACO_OP_OK + evento->tipo;
+        switch (evento->tipo) {
+            case EVT_PECA_GERADA: {
+                PecaTraco prevista = { evento->nomeA, modelo->ultimoIdGerado + 1 };
+                escritor->tipos[escritor->numTipos / 4] |=
+                    (unsigned char)(codigoTipoTraco(evento->nomeA) << (2 * (escritor->numTipos % 4)));
+                escritor->numTipos++;
+                codificarPecaTraco(escritor, prevista, evento->nomeA, evento->idA);
+                break;
+            }
+            case EVT_JOGAR:
+            case EVT_RESERVAR:
+                codificarPecaTraco(escritor, previsaoFilaTraco(modelo), evento->nomeA, evento->idA);
+                break;
+            case EVT_USAR_RESERVA:
+                codificarPecaTraco(escritor, previsaoPilhaTraco(modelo), evento->nomeA, evento->idA);
+                break;
+            case EVT_TROCA_SIMPLES:
+                codificarPecaTraco(escritor, previsaoFilaTraco(modelo), evento->nomeA, evento->idA);
+                codificarPecaTraco(escritor, previsaoPilhaTraco(modelo), evento->nomeB, evento->idB);
+                break;
+            default: { // EVT_TROCA_MULTIPLA
+                PecaTraco previsto = { 0, modelo->ultimoK };
+                codificarPecaTraco(escritor, previsto, 0, evento->idA);
+                break;
+            }
+        }
+    }
+
+    escritor->ops[indice / 2] |= (unsigned char)(op << (4 * (indice % 2)));
+    aplicarModeloTraco(modelo, evento);
+    escritor->sequenciaEsperada = evento->sequencia + 1;
+    escritor->numEventos++;
+
+    if (++escritor->eventosBloco == TRACO_EVENTOS_POR_BLOCO) {
+        return gravarBlocoTraco(escritor);
+    }
+    return 1;
+}
+
+/**
+ * Grava o último bloco, o índice e o rodapé e fecha o arquivo
+ * @return 1 se bem-sucedido, 0 em erro de escrita
+ */
+static inline int fecharEscritorTraco(EscritorTraco* escritor) {
+    int ok = gravarBlocoTraco(escritor);
+
+    unsigned char* indice = malloc(8 * escritor->numBlocos + TRACO_TAM_RODAPE);
+    if (ok && indice != NULL) {
+        for (size_t b = 0; b < escritor->numBlocos; b++) {
+            escreverU32((char*)indice + 8 * b, (uint32_t)escritor->indice[b]);
+            escreverU32((char*)indice + 8 * b + 4, (uint32_t)(escritor->indice[b] >> 32));
+        }
+        unsigned char* rodape = indice + 8 * escritor->numBlocos;
+        escreverU32((char*)rodape, (uint32_t)escritor->posicaoArquivo);
+        escreverU32((char*)rodape + 4, (uint32_t)(escritor->posicaoArquivo >> 32));
+        escreverU32((char*)rodape + 8, (uint32_t)escritor->numEventos);
+        escreverU32((char*)rodape + 12, (uint32_t)(escritor->numEventos >> 32));
+        memcpy(rodape + 16, TRACO_MAGICO_INDICE, 4);
+        escreverU32((char*)rodape + 20, (uint32_t)escritor->numBlocos);
+        ok = gravarTudoTraco(escritor->fd, indice, 8 * escritor->numBlocos + TRACO_TAM_RODAPE);
+    } else {
+        ok = 0;
+    }
+    free(indice);
+
+    close(escritor->fd);
+    free(escritor->indice);
+    free(escritor->modeloInicial);
+    free(escritor->ops);
+    free(escritor->tipos);
+    free(escritor->resultados);
+    free(escritor->desvios);
+    free(escritor->brutos);
+    free(escritor->saida);
+    return ok;
+}
+
+// ============================================================================
+// LEITOR
+// ============================================================================
+
+/**
+ * Leitor de traço (arquivo mapeado em memória)
+ */
+typedef struct {
+    const unsigned char* mapa;
+    size_t tamanhoMapa;
+    const unsigned char* indice;
+    uint32_t numBlocos;
+    uint64_t numEventos;
+    uint64_t posicao;               // Número do próximo evento a ler
+
+    // Bloco atual
+    uint32_t restantesBloco;
+    uint32_t indiceOp;
+    uint32_t indiceTipo;
+    uint32_t sequenciaEsperada;
+    uint64_t acertos;
+    const unsigned char* ops;
+    const unsigned char* tipos;
+    const unsigned char* resultados;
+    const unsigned char* desvios;
+    const unsigned char* fimDesvios;
+    const unsigned char* brutos;
+    int corrompido;                 // 1 se a coluna de desvios do bloco acabou antes da hora
+
+    ModeloTraco modelo;             // Fila e pilha após o último evento lido
+} LeitorTraco;
+
+static inline uint64_t lerU64Traco(const unsigned char* origem) {
+    return (uint64_t)lerU32(origem) | (uint64_t)lerU32(origem + 4) << 32;
+}
+
+/**
+ * O que cada código de operação consome das colunas de tamanho fixo, em
+ * campos de 21 bits: peças geradas (tipos), falhas (resultados), brutos
+ */
+#define TRACO_CONSUMO_GERADA    1ULL
+#define TRACO_CONSUMO_FALHA     (1ULL << 21)
+#define TRACO_CONSUMO_BRUTO     (1ULL << 42)
+
+static const uint64_t consumoOpTraco[16] = {
+    [TRACO_OP_BRUTO]                        = TRACO_CONSUMO_BRUTO,
+    [TRACO_OP_OK + EVT_PECA_GERADA]         = TRACO_CONSUMO_GERADA,
+    [TRACO_OP_FALHA + EVT_PECA_GERADA]      = TRACO_CONSUMO_FALHA,
+    [TRACO_OP_FALHA + EVT_JOGAR]            = TRACO_CONSUMO_FALHA,
+    [TRACO_OP_FALHA + EVT_RESERVAR]         = TRACO_CONSUMO_FALHA,
+    [TRACO_OP_FALHA + EVT_USAR_RESERVA]     = TRACO_CONSUMO_FALHA,
+    [TRACO_OP_FALHA + EVT_TROCA_SIMPLES]    = TRACO_CONSUMO_FALHA,
+    [TRACO_OP_FALHA + EVT_TROCA_MULTIPLA]   = TRACO_CONSUMO_FALHA,
+    [13] = TRACO_CONSUMO_BRUTO,
+    [14] = TRACO_CONSUMO_BRUTO,
+    [15] = TRACO_CONSUMO_BRUTO,
+};
+
+/**
+ * Prepara a decodificação de um bloco
+ * @return 1 se bem-sucedido, 0 se o bloco é inválido
+ */
+static inline int abrirBlocoTraco(LeitorTraco* leitor, uint32_t bloco) {
+    if (bloco >= leitor->numBlocos) {
+        return 0;
+    }
+    uint64_t inicio = lerU64Traco(leitor->indice + 8 * (size_t)bloco);
+    uint64_t fim = bloco + 1 < leitor->numBlocos ? lerU64Traco(leitor->indice + 8 * (size_t)(bloco + 1)) :
+                   (uint64_t)(leitor->indice - leitor->mapa);
+    if (inicio < TRACO_TAM_CABECALHO || fim > leitor->tamanhoMapa || fim < inicio + 28) {
+        return 0;
+    }
+
+    const unsigned char* p = leitor->mapa + inicio;
+    leitor->restantesBloco = lerU32(p);
+    leitor->sequenciaEsperada = lerU32(p + 4);
+    uint64_t tamanhos[5];
+    uint64_t soma = 0;
+    for (int c = 0; c < 5; c++) {
+        tamanhos[c] = lerU32(p + 8 + 4 * c);
+        soma += tamanhos[c];
+    }
+    p += 28;
+
+    // Todo bloco tem TRACO_EVENTOS_POR_BLOCO eventos, exceto o último, que tem o resto
+    uint64_t eventosAntes = (uint64_t)bloco * TRACO_EVENTOS_POR_BLOCO;
+    uint64_t esperados = leitor->numEventos - eventosAntes;
+    if (esperados > TRACO_EVENTOS_POR_BLOCO) {
+        esperados = TRACO_EVENTOS_POR_BLOCO;
+    }
+
+    size_t tamanhoModelo = desserializarModeloTraco(&leitor->modelo, p, (size_t)(fim - inicio - 28));
+    if (tamanhoModelo == 0 || inicio + 28 + tamanhoModelo + soma != fim ||
+        leitor->numEventos <= eventosAntes || leitor->restantesBloco != esperados ||
+        tamanhos[0] < (leitor->restantesBloco + 1) / 2) {
+        return 0;
+    }
+    p += tamanhoModelo;
+    leitor->ops = p;
+    leitor->tipos = leitor->ops + tamanhos[0];
+    leitor->resultados = leitor->tipos + tamanhos[1];
+    leitor->desvios = leitor->resultados + tamanhos[2];
+    leitor->brutos = leitor->desvios + tamanhos[3];
+    leitor->fimDesvios = leitor->brutos;
+
+    // As colunas de tamanho fixo por op (tipos, resultados, brutos) precisam
+    // cobrir o que os ops do bloco consomem: contagem sem desvios, dois ops
+    // por byte, somando campos de 21 bits (gerados | falhas | brutos)
+    uint64_t contagem = 0;
+    for (uint32_t i = 0; i < leitor->restantesBloco / 2; i++) {
+        contagem += consumoOpTraco[leitor->ops[i] & 0xF] + consumoOpTraco[leitor->ops[i] >> 4];
+    }
+    if (leitor->restantesBloco % 2) {
+        contagem += consumoOpTraco[leitor->ops[leitor->restantesBloco / 2] & 0xF];
+    }
+    uint64_t gerados = contagem & 0x1FFFFF, falhas = (contagem >> 21) & 0x1FFFFF, brutos = contagem >> 42;
+    if (tamanhos[1] < (gerados + 3) / 4 || tamanhos[2] < falhas || tamanhos[4] < brutos * EVENTOS_TAM_QUADRO) {
+        return 0;
+    }
+
+    leitor->indiceOp = 0;
+    leitor->indiceTipo = 0;
+    leitor->corrompido = 0;
+    return lerVarintTraco(&leitor->desvios, leitor->fimDesvios, &leitor->acertos);
+}
+
+/**
+ * Abre e mapeia um arquivo de traço, posicionado no primeiro evento
+ * @param caminho Caminho do arquivo
+ * @param leitor Leitor a inicializar
+ * @return 1 se bem-sucedido, 0 se o arquivo não existe ou é inválido
+ */
+static inline int abrirLeitorTraco(const char* caminho, LeitorTraco* leitor) {
+    memset(leitor, 0, sizeof(*leitor));
+    int fd = open(caminho, O_RDONLY);
+    if (fd < 0) {
+        return 0;
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size < TRACO_TAM_CABECALHO + TRACO_TAM_RODAPE) {
+        close(fd);
+        return 0;
+    }
+    void* mapa = mmap(NULL, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (mapa == MAP_FAILED) {
+        return 0;
+    }
+    madvise(mapa, (size_t)info.st_size, MADV_SEQUENTIAL);
+
+    leitor->mapa = mapa;
+    leitor->tamanhoMapa = (size_t)info.st_size;
+    const unsigned char* rodape = leitor->mapa + leitor->tamanhoMapa - TRACO_TAM_RODAPE;
+    uint64_t posicaoIndice = lerU64Traco(rodape);
+    leitor->numEventos = lerU64Traco(rodape + 8);
+    leitor->numBlocos = lerU32(rodape + 20);
+
+    leitor->indice = leitor->mapa + posicaoIndice;
+    reiniciarModeloTraco(&leitor->modelo);
+
+    if (memcmp(leitor->mapa, TRACO_MAGICO, 4) != 0 || (leitor->mapa[4] | leitor->mapa[5] << 8) != TRACO_VERSAO ||
+        memcmp(rodape + 16, TRACO_MAGICO_INDICE, 4) != 0 ||
+        posicaoIndice > leitor->tamanhoMapa ||
+        posicaoIndice + 8 * (uint64_t)leitor->numBlocos + TRACO_TAM_RODAPE != leitor->tamanhoMapa ||
+        (leitor->numEventos + TRACO_EVENTOS_POR_BLOCO - 1) / TRACO_EVENTOS_POR_BLOCO != leitor->numBlocos ||
+        (leitor->numBlocos > 0 && !abrirBlocoTraco(leitor, 0))) {
+        munmap(mapa, leitor->tamanhoMapa);
+        memset(leitor, 0, sizeof(*leitor));
+        return 0;
+    }
+    return 1;
+}
+
+/**
+ * Efeito de cada código de operação no caminho rápido (troca múltipla e
+ * eventos brutos seguem o caminho geral)
+ */
+typedef struct {
+    uint8_t tipo;
+    uint8_t pecas;          // Peças no evento (0 a 2)
+    uint8_t geral;          // 1: decodificado por decodificarEventoTraco
+} EfeitoOpTraco;
+
+static const EfeitoOpTraco efeitosOpTraco[16] = {
+    [TRACO_OP_BRUTO]                        = { 0, 0, 1 },
+    [TRACO_OP_OK + EVT_PECA_GERADA]         = { EVT_PECA_GERADA, 1, 0 },
+    [TRACO_OP_OK + EVT_JOGAR]               = { EVT_JOGAR, 1, 0 },
+    [TRACO_OP_OK + EVT_RESERVAR]            = { EVT_RESERVAR, 1, 0 },
+    [TRACO_OP_OK + EVT_USAR_RESERVA]        = { EVT_USAR_RESERVA, 1, 0 },
+    [TRACO_OP_OK + EVT_TROCA_SIMPLES]       = { EVT_TROCA_SIMPLES, 2, 0 },
+    [TRACO_OP_OK + EVT_TROCA_MULTIPLA]      = { 0, 0, 1 },
+    [TRACO_OP_FALHA + EVT_PECA_GERADA]      = { 0, 0, 1 },
+    [TRACO_OP_FALHA + EVT_JOGAR]            = { EVT_JOGAR, 0, 0 },
+    [TRACO_OP_FALHA + EVT_RESERVAR]         = { EVT_RESERVAR, 0, 0 },
+    [TRACO_OP_FALHA + EVT_USAR_RESERVA]     = { EVT_USAR_RESERVA, 0, 0 },
+    [TRACO_OP_FALHA + EVT_TROCA_SIMPLES]    = { EVT_TROCA_SIMPLES, 0, 0 },
+    [TRACO_OP_FALHA + EVT_TROCA_MULTIPLA]   = { 0, 0, 1 },
+    [13] = { 0, 0, 1 },
+    [14] = { 0, 0, 1 },
+    [15] = { 0, 0, 1 },
+};
+
+/**
+ * Decodifica a próxima peça: a prevista, ou a do próximo desvio
+ */
+static inline PecaTraco decodificarPecaTraco(LeitorTraco* leitor, PecaTraco prevista) {
+    if (leitor->acertos > 0) {
+        leitor->acertos--;
+        return prevista;
+    }
+    PecaTraco peca;
+    uint64_t desvio;
+    if (leitor->desvios >= leitor->fimDesvios) {
+        leitor->corrompido = 1;
+    } else {
+        peca.nome = (char)*leitor->desvios++;
+        if (lerVarintTraco(&leitor->desvios, leitor->fimDesvios, &desvio) &&
+            lerVarintTraco(&leitor->desvios, leitor->fimDesvios, &leitor->acertos)) {
+            peca.id = (int32_t)(prevista.id + desfazerZigzagTraco(desvio));
+            return peca;
+        }
+        leitor->corrompido = 1;
+    }
+    // Coluna esgotada: o resto do bloco sai das previsões e é descartado
+    leitor->acertos = UINT64_MAX;
+    return prevista;
+}
+
+/**
+ * Caminho geral: decodifica um evento qualquer (brutos, troca múltipla,
+ * peças fora da previsão) e o aplica ao modelo com aplicarModeloTraco,
+ * exatamente como o escritor
+ * @param leitor Leitor com um bloco aberto (modelo e colunas atualizados)
+ * @param op Código da operação, já consumido da coluna
+ * @param evento Recebe o evento
+ */
+static __attribute__((noinline)) void decodificarEventoTraco(LeitorTraco* leitor, unsigned op, Evento* evento) {
+    ModeloTraco* modelo = &leitor->modelo;
+
+    if (op == TRACO_OP_BRUTO || op > TRACO_OP_FALHA + EVT_TROCA_MULTIPLA) {
+        decodificarEvento(leitor->brutos, evento);
+        leitor->brutos += EVENTOS_TAM_QUADRO;
+        aplicarModeloTraco(modelo, evento);
+        leitor->sequenciaEsperada = evento->sequencia + 1;
+        return;
+    }
+
+    evento->sequencia = leitor->sequenciaEsperada++;
+    evento->nomeA = 0;
+    evento->nomeB = 0;
+    evento->idA = -1;
+    evento->idB = -1;
+
+    if (op > TRACO_OP_FALHA) {
+        evento->tipo = (uint8_t)(op - TRACO_OP_FALHA);
+        evento->resultado = *leitor->resultados++;
+        if (evento->tipo == EVT_TROCA_MULTIPLA) {
+            PecaTraco previsto = { 0, modelo->ultimoK };
+            evento->idA = decodificarPecaTraco(leitor, previsto).id;
+        }
+    } else {
+        PecaTraco peca;
+        evento->tipo = (uint8_t)op;
+        evento->resultado = EVT_OK;
+        switch (op) {
+            case EVT_PECA_GERADA: {
+                PecaTraco prevista = {
+                    tiposTraco[(leitor->tipos[leitor->indiceTipo / 4] >> (2 * (leitor->indiceTipo % 4))) & 3],
+                    modelo->ultimoIdGerado + 1
+                };
+                leitor->indiceTipo++;
+                peca = decodificarPecaTraco(leitor, prevista);
+                break;
+            }
+            case EVT_JOGAR:
+            case EVT_RESERVAR:
+                peca = decodificarPecaTraco(leitor, previsaoFilaTraco(modelo));
+                break;
+            case EVT_USAR_RESERVA:
+                peca = decodificarPecaTraco(leitor, previsaoPilhaTraco(modelo));
+                break;
+            case EVT_TROCA_SIMPLES: {
+                peca = decodificarPecaTraco(leitor, previsaoFilaTraco(modelo));
+                PecaTraco pecaB = decodificarPecaTraco(leitor, previsaoPilhaTraco(modelo));
+                evento->nomeB = pecaB.nome;
+                evento->idB = pecaB.id;
+                break;
+            }
+            default: { // EVT_TROCA_MULTIPLA
+                PecaTraco previsto = { 0, modelo->ultimoK };
+                peca = decodificarPecaTraco(leitor, previsto);
+                break;
+            }
+        }
+        evento->nomeA = peca.nome;
+        evento->idA = peca.id;
+    }
+    aplicarModeloTraco(modelo, evento);
+}
+
+/**
+ * Decodifica eventos do bloco atual. No caso comum (operação com código
+ * próprio, exceto troca múltipla, e peças previstas pelo modelo) o evento
+ * e a atualização do modelo saem direto das previsões, com o estado em
+ * variáveis locais; o resultado é o mesmo de aplicarModeloTraco, usado
+ * pelo escritor.
+ * @param leitor Leitor com um bloco aberto
+ * @param destino Recebe os eventos
+ * @param n Número de eventos (no máximo os que restam no bloco)
+ */
+static inline void decodificarTrechoTraco(LeitorTraco* leitor, Evento* destino, uint32_t n) {
+    ModeloTraco* modelo = &leitor->modelo;
+    PecaTraco* fila = modelo->fila;
+    PecaTraco* pilha = modelo->pilha;
+    const unsigned char* ops = leitor->ops;
+    const unsigned char* tipos = leitor->tipos;
+    const uint32_t mascara = TRACO_MAX_PECAS - 1;
+    const PecaTraco semPeca = { 0, -1 };
+
+    // Estado em variáveis locais (os eventos gravados em destino poderiam,
+    // para o compilador, alterar os campos do leitor)
+    uint32_t frente = modelo->frente;
+    uint32_t tamanhoFila = modelo->tamanhoFila;
+    uint32_t tamanhoPilha = modelo->tamanhoPilha;
+    int32_t ultimoIdGerado = modelo->ultimoIdGerado;
+    uint64_t acertos = leitor->acertos;
+    uint32_t indiceOp = leitor->indiceOp;
+    uint32_t indiceTipo = leitor->indiceTipo;
+    uint32_t sequencia = leitor->sequenciaEsperada;
+    const unsigned char* resultados = leitor->resultados;
+
+    for (uint32_t i = 0; i < n; i++) {
+        unsigned op = (ops[indiceOp / 2] >> (4 * (indiceOp % 2))) & 0xF;
+        const EfeitoOpTraco efeito = efeitosOpTraco[op];
+        indiceOp++;
+
+        if (__builtin_expect(efeito.geral || acertos < efeito.pecas, 0)) {
+            modelo->frente = frente;
+            modelo->tamanhoFila = tamanhoFila;
+            modelo->tamanhoPilha = tamanhoPilha;
+            modelo->ultimoIdGerado = ultimoIdGerado;
+            leitor->acertos = acertos;
+            leitor->indiceTipo = indiceTipo;
+            leitor->sequenciaEsperada = sequencia;
+            leitor->resultados = resultados;
+            decodificarEventoTraco(leitor, op, &destino[i]);
+            frente = modelo->frente;
+            tamanhoFila = modelo->tamanhoFila;
+            tamanhoPilha = modelo->tamanhoPilha;
+            ultimoIdGerado = modelo->ultimoIdGerado;
+            acertos = leitor->acertos;
+            indiceTipo = leitor->indiceTipo;
+            sequencia = leitor->sequenciaEsperada;
+            resultados = leitor->resultados;
+            continue;
+        }
+        acertos -= efeito.pecas;
+
+        Evento evento;
+        evento.sequencia = sequencia++;
+        evento.tipo = efeito.tipo;
+        evento.resultado = EVT_OK;
+        evento.nomeA = 0;
+        evento.nomeB = 0;
+        evento.idA = -1;
+        evento.idB = -1;
+
+        switch (op) {
+            case TRACO_OP_OK + EVT_PECA_GERADA: {
+                PecaTraco peca = {
+                    tiposTraco[(tipos[indiceTipo / 4] >> (2 * (indiceTipo % 4))) & 3], ultimoIdGerado + 1
+                };
+                indiceTipo++;
+                ultimoIdGerado = peca.id;
+                evento.nomeA = peca.nome;
+                evento.idA = peca.id;
+                if (tamanhoFila < TRACO_MAX_PECAS) {
+                    fila[(frente + tamanhoFila) & mascara] = peca;
+                    tamanhoFila++;
+                }
+                break;
+            }
+            case TRACO_OP_OK + EVT_JOGAR:
+            case TRACO_OP_OK + EVT_RESERVAR:
+                if (tamanhoFila > 0) {
+                    PecaTraco peca = fila[frente];
+                    evento.nomeA = peca.nome;
+                    evento.idA = peca.id;
+                    frente = (frente + 1) & mascara;
+                    tamanhoFila--;
+                    if (op == TRACO_OP_OK + EVT_RESERVAR && tamanhoPilha < TRACO_MAX_PECAS) {
+                        pilha[tamanhoPilha++] = peca;
+                    }
+                }
+                break;
+            case TRACO_OP_OK + EVT_USAR_RESERVA:
+                if (tamanhoPilha > 0) {
+                    PecaTraco peca = pilha[--tamanhoPilha];
+                    evento.nomeA = peca.nome;
+                    evento.idA = peca.id;
+                }
+                break;
+            case TRACO_OP_OK + EVT_TROCA_SIMPLES: {
+                PecaTraco pecaA = tamanhoFila > 0 ? fila[frente] : semPeca;
+                PecaTraco pecaB = tamanhoPilha > 0 ? pilha[tamanhoPilha - 1] : semPeca;
+                evento.nomeA = pecaA.nome;
+                evento.idA = pecaA.id;
+                evento.nomeB = pecaB.nome;
+                evento.idB = pecaB.id;
+                if (tamanhoFila > 0 && tamanhoPilha > 0) {
+                    fila[frente] = pecaB;
+                    pilha[tamanhoPilha - 1] = pecaA;
+                }
+                break;
+            }
+            default: // Falhas: o modelo não muda
+                evento.resultado = *resultados++;
+                break;
+        }
+        destino[i] = evento;
+    }
+
+    modelo->frente = frente;
+    modelo->tamanhoFila = tamanhoFila;
+    modelo->tamanhoPilha = tamanhoPilha;
+    modelo->ultimoIdGerado = ultimoIdGerado;
+    leitor->acertos = acertos;
+    leitor->indiceOp = indiceOp;
+    leitor->indiceTipo = indiceTipo;
+    leitor->sequenciaEsperada = sequencia;
+    leitor->resultados = resultados;
+}
+
+/**
+ * Lê os próximos eventos
+ * @param leitor Leitor aberto
+ * @param destino Recebe os eventos
+ * @param maximo Número máximo de eventos a ler
+ * @return Eventos lidos (0 no fim do traço)
+ */
+static inline size_t lerEventosTraco(LeitorTraco* leitor, Evento* destino, size_t maximo) {
+    size_t lidos = 0;
+
+    while (lidos < maximo && leitor->posicao < leitor->numEventos && !leitor->corrompido) {
+        if (leitor->restantesBloco == 0 &&
+            !abrirBlocoTraco(leitor, (uint32_t)(leitor->posicao / TRACO_EVENTOS_POR_BLOCO))) {
+            break;
+        }
+        uint32_t n = maximo - lidos < leitor->restantesBloco ? (uint32_t)(maximo - lidos) : leitor->restantesBloco;
+        decodificarTrechoTraco(leitor, destino + lidos, n);
+        if (leitor->corrompido) {
+            break;  // Os eventos deste trecho não são confiáveis
+        }
+        leitor->restantesBloco -= n;
+        leitor->posicao += n;
+        lidos += n;
+    }
+    return lidos;
+}
+
+/**
+ * Posiciona o leitor em um evento qualquer: decodifica só o bloco que o
+ * contém, a partir do modelo gravado no início do bloco
+ * @param leitor Leitor aberto
+ * @param posicao Número do evento (0 = primeiro)
+ * @return 1 se bem-sucedido, 0 se a posição não existe
+ */
+static inline int posicionarTraco(LeitorTraco* leitor, uint64_t posicao) {
+    if (posicao > leitor->numEventos) {
+        return 0;
+    }
+    uint32_t bloco = (uint32_t)(posicao / TRACO_EVENTOS_POR_BLOCO);
+    if (bloco == leitor->numBlocos) {
+        leitor->posicao = posicao;
+        leitor->restantesBloco = 0;
+        return 1;
+    }
+    if (!abrirBlocoTraco(leitor, bloco)) {
+        return 0;
+    }
+    leitor->posicao = (uint64_t)bloco * TRACO_EVENTOS_POR_BLOCO;
+
+    Evento descartados[256];
+    while (leitor->posicao < posicao) {
+        uint64_t falta = posicao - leitor->posicao;
+        if (lerEventosTraco(leitor, descartados, falta < 256 ? (size_t)falta : 256) == 0) {
+            return 0;   // Bloco corrompido antes da posição
+        }
+    }
+    return 1;
+}
+
+/**
+ * Desfaz o mapeamento do leitor
+ */
+static inline void fecharLeitorTraco(LeitorTraco* leitor) {
+    if (leitor->mapa != NULL) {
+        munmap((void*)leitor->mapa, leitor->tamanhoMapa);
+    }
+    memset(leitor, 0, sizeof(*leitor));
+}
+
+#endif // TRACO_H
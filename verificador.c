@@ -0,0 +1,694 @@
+/*
+ * TETRIS STACK - VERIFICADOR DE SESSÕES GRAVADAS
+ *
+ * Reexecuta fluxos de eventos binários (--eventos-bin, formato em eventos.h)
+ * com a lógica atual do mestre.c e confere, operação por operação, se o
+ * resultado e as peças envolvidas são os registrados, e se o checksum do
+ * estado final bate com o do evento "fim". Serve para revalidar um acervo de
+ * sessões sempre que a lógica do jogo muda (ex.: a ordem da troca múltipla).
+ *
+ * - as peças vêm dos eventos peca_gerada (enqueueFila), nunca do sorteio
+ * - cada thread reexecuta sessões inteiras em sua própria fila e pilha; as
+ *   sessões são distribuídas sob demanda, na ordem em que aparecem
+ * - arquivos tar (ustar, sem compressão) são mapeados em memória e lidos
+ *   sequencialmente, sem cópia; arquivos soltos são lidos com read()
+ * - sessões com problema são relatadas assim que terminam, com o primeiro
+ *   passo divergente; o resumo vem no final
+ *
+ * Uso: verificador [--threads N] [--todas] CAMINHO...
+ *        CAMINHO  fluxo de eventos, diretório (percorrido recursivamente,
+ *                 cada arquivo é uma sessão) ou arquivo tar de fluxos
+ *        --todas  relata também as sessões corretas
+ * Código de saída: 0 se todas as sessões conferem, 2 se alguma não confere
+ * Compilação: gcc -O2 verificador.c -o verificador -lpthread
+ */
+
+#define MESTRE_SEM_MAIN
+#include "mestre.c"
+
+#include <dirent.h>
+#include <errno.h>
+#include <pthread.h>
+#include <sys/stat.h>
+
+// ============================================================================
+// DEFINIÇÕES E ESTRUTURAS
+// ============================================================================
+
+#define TAR_TAM_BLOCO     512
+#define MAX_NOME_SESSAO   4096
+
+/**
+ * Situação de uma sessão após a verificação
+ */
+typedef enum {
+    SESSAO_OK,
+    SESSAO_DIVERGENTE,      // Operação ou checksum diferente do registrado
+    SESSAO_INCOMPLETA,      // Fluxo termina sem o evento "fim"
+    SESSAO_INVALIDA,        // Não é um fluxo de eventos válido
+    SESSAO_INCOMPATIVEL,    // Capacidades diferentes das deste binário
+    NUM_SITUACOES
+} SituacaoSessao;
+
+static const char* nomesSituacoes[NUM_SITUACOES] = {
+    "OK", "DIVERGENTE", "INCOMPLETA", "INVALIDA", "INCOMPATIVEL"
+};
+
+/**
+ * Resultado da reexecução de uma sessão
+ */
+typedef struct {
+    SituacaoSessao situacao;
+    uint32_t eventos;               // Eventos lidos
+    Evento registrado;              // Primeiro evento divergente, como gravado
+    Evento reexecutado;             // O mesmo evento, como reexecutado
+    const char* motivo;             // Descrição para os casos sem par de eventos
+} ResultadoVerificacao;
+
+/**
+ * Entrada da linha de comando (ou arquivo encontrado em um diretório)
+ */
+typedef struct {
+    char* caminho;
+    int ehTar;
+    const unsigned char* mapa;      // Arquivo tar mapeado (NULL até ser aberto)
+    size_t tamanho;
+} EntradaVerificacao;
+
+/**
+ * Fonte compartilhada de sessões: as threads pegam a próxima sessão sob a
+ * trava, percorrendo as entradas e os membros dos arquivos tar em ordem
+ */
+typedef struct {
+    pthread_mutex_t trava;
+    EntradaVerificacao* entradas;
+    size_t numEntradas;
+    size_t capacidadeEntradas;
+    size_t proximaEntrada;
+    EntradaVerificacao* tarAtual;   // Arquivo tar sendo percorrido
+    size_t cursorTar;               // Próximo cabeçalho do tar atual
+    int relatarTodas;
+} FonteSessoes;
+
+/**
+ * Uma sessão a verificar: dados já mapeados (membro de tar) ou caminho
+ */
+typedef struct {
+    char nome[MAX_NOME_SESSAO];
+    const unsigned char* dados;     // NULL para arquivos soltos
+    size_t tamanho;
+    const char* caminho;
+} SessaoVerificacao;
+
+/**
+ * Estado de cada thread: buffer de leitura e totais
+ */
+typedef struct {
+    FonteSessoes* fonte;
+    unsigned char* buffer;
+    size_t capacidadeBuffer;
+    uint64_t sessoes[NUM_SITUACOES];
+    uint64_t eventos;
+    uint64_t bytes;
+    uint64_t errosLeitura;
+} __attribute__((aligned(64))) TrabalhadorVerificacao;
+
+// ============================================================================
+// REEXECUÇÃO
+// ============================================================================
+
+/**
+ * Monta o evento que a operação produziu na reexecução
+ */
+static Evento eventoReexecutado(uint32_t sequencia, TipoEvento tipo, ResultadoEvento resultado,
+                                char nome, int32_t id) {
+    Evento evento = { sequencia, (uint8_t)tipo, (uint8_t)resultado, nome, 0, id, -1 };
+    return evento;
+}
+
+/**
+ * Reaplica uma operação registrada com as funções do mestre.c (jogar,
+ * reservar e usar seguem os mesmos passos do laço principal)
+ * @param evento Evento registrado
+ * @param fila Fila da reexecução
+ * @param pilha Pilha da reexecução
+ * @return Evento produzido pela reexecução
+ */
+static Evento reaplicarOperacao(const Evento* evento, FilaPecas* fila, PilhaReserva* pilha) {
+    Peca peca;
+
+    switch (evento->tipo) {
+        case EVT_JOGAR:
+            if (dequeueFila(fila, &peca)) {
+                return eventoReexecutado(evento->sequencia, EVT_JOGAR, EVT_OK, peca.nome, peca.id);
+            }
+            return eventoReexecutado(evento->sequencia, EVT_JOGAR, EVT_ERRO_FILA_VAZIA, 0, -1);
+
+        case EVT_RESERVAR:
+            if (pilhaCheia(pilha)) {
+                return eventoReexecutado(evento->sequencia, EVT_RESERVAR, EVT_ERRO_PILHA_CHEIA, 0, -1);
+            }
+            if (dequeueFila(fila, &peca) && pushPilha(pilha, peca)) {
+                return eventoReexecutado(evento->sequencia, EVT_RESERVAR, EVT_OK, peca.nome, peca.id);
+            }
+            return eventoReexecutado(evento->sequencia, EVT_RESERVAR, EVT_ERRO_FILA_VAZIA, 0, -1);
+
+        case EVT_USAR_RESERVA:
+            if (popPilha(pilha, &peca)) {
+                return eventoReexecutado(evento->sequencia, EVT_USAR_RESERVA, EVT_OK, peca.nome, peca.id);
+            }
+            return eventoReexecutado(evento->sequencia, EVT_USAR_RESERVA, EVT_ERRO_PILHA_VAZIA, 0, -1);
+
+        case EVT_TROCA_SIMPLES:
+            trocarSimples(fila, pilha);
+            break;
+
+        default: // EVT_TROCA_MULTIPLA: k = CAPACIDADE_PILHA é a opção 5, os demais a opção 7
+            if (evento->idA == CAPACIDADE_PILHA) {
+                trocarMultipla(fila, pilha);
+            } else {
+                trocarBloco(fila, pilha, evento->idA);
+            }
+            break;
+    }
+
+    // As trocas emitem o próprio evento; o resumo da thread guarda o último
+    Evento emitido = resumoEventos.ultima;
+    emitido.sequencia = evento->sequencia;
+    return emitido;
+}
+
+/**
+ * Registra a primeira divergência de uma sessão
+ */
+static void marcarDivergencia(ResultadoVerificacao* resultado, const Evento* registrado,
+                              const Evento* reexecutado, const char* motivo) {
+    resultado->situacao = SESSAO_DIVERGENTE;
+    resultado->registrado = *registrado;
+    resultado->reexecutado = *reexecutado;
+    resultado->motivo = motivo;
+}
+
+/**
+ * Reexecuta uma sessão gravada e compara cada operação com o registro
+ * @param dados Fluxo de eventos binário completo
+ * @param tamanho Tamanho do fluxo em bytes
+ * @param resultado Recebe a situação e a primeira divergência
+ */
+static void verificarSessao(const unsigned char* dados, size_t tamanho, ResultadoVerificacao* resultado) {
+    memset(resultado, 0, sizeof(*resultado));
+
+    if (tamanho < EVENTOS_TAM_CABECALHO || memcmp(dados, EVENTOS_MAGICO, 4) != 0 ||
+        (dados[4] | dados[5] << 8) != EVENTOS_VERSAO || (dados[6] | dados[7] << 8) != EVENTOS_TAM_QUADRO) {
+        resultado->situacao = SESSAO_INVALIDA;
+        resultado->motivo = "cabecalho de fluxo de eventos ausente ou de outra versao";
+        return;
+    }
+    if ((dados[8] | dados[9] << 8) != CAPACIDADE_FILA || (dados[10] | dados[11] << 8) != CAPACIDADE_PILHA) {
+        resultado->situacao = SESSAO_INCOMPATIVEL;
+        resultado->motivo = "capacidades da fila/pilha diferentes das deste verificador";
+        return;
+    }
+
+    FilaPecas fila;
+    PilhaReserva pilha;
+    fila.frente = 0;
+    fila.tras = 0;
+    fila.tamanho = 0;
+    inicializarPilha(&pilha);
+
+    size_t numQuadros = (tamanho - EVENTOS_TAM_CABECALHO) / EVENTOS_TAM_QUADRO;
+    const unsigned char* quadro = dados + EVENTOS_TAM_CABECALHO;
+
+    for (size_t i = 0; i < numQuadros; i++, quadro += EVENTOS_TAM_QUADRO) {
+        Evento evento;
+        decodificarEvento(quadro, &evento);
+        resultado->eventos++;
+
+        if (evento.sequencia != (uint32_t)i || evento.tipo >= EVT_NUM_TIPOS ||
+            evento.resultado >= EVT_NUM_RESULTADOS || (evento.tipo == EVT_INICIO) != (i == 0)) {
+            resultado->situacao = SESSAO_INVALIDA;
+            resultado->registrado = evento;
+            resultado->motivo = "evento fora de ordem ou desconhecido";
+            return;
+        }
+
+        if (evento.tipo == EVT_INICIO) {
+            continue;
+        }
+
+        if (evento.tipo == EVT_PECA_GERADA) {
+            Peca peca = { evento.nomeA, evento.idA };
+            if (!enqueueFila(&fila, peca)) {
+                Evento obtido = eventoReexecutado(evento.sequencia, EVT_PECA_GERADA, EVT_OK, 0, -1);
+                marcarDivergencia(resultado, &evento, &obtido, "fila cheia ao receber a peca gerada");
+                return;
+            }
+            continue;
+        }
+
+        if (evento.tipo == EVT_FIM) {
+            uint64_t registrado = (uint64_t)(uint32_t)evento.idA | (uint64_t)(uint32_t)evento.idB << 32;
+            uint64_t reexecutado = checksumEstado(&fila, &pilha);
+            if (registrado != reexecutado) {
+                Evento obtido = evento;
+                obtido.idA = (int32_t)(uint32_t)reexecutado;
+                obtido.idB = (int32_t)(uint32_t)(reexecutado >> 32);
+                marcarDivergencia(resultado, &evento, &obtido, "checksum do estado final");
+            }
+            return;
+        }
+
+        Evento obtido = reaplicarOperacao(&evento, &fila, &pilha);
+        if (obtido.resultado != evento.resultado || obtido.nomeA != evento.nomeA ||
+            obtido.idA != evento.idA || obtido.nomeB != evento.nomeB || obtido.idB != evento.idB) {
+            marcarDivergencia(resultado, &evento, &obtido, NULL);
+            return;
+        }
+    }
+
+    resultado->situacao = SESSAO_INCOMPLETA;
+    resultado->motivo = (tamanho - EVENTOS_TAM_CABECALHO) % EVENTOS_TAM_QUADRO != 0 ?
+                        "fluxo cortado no meio de um evento" : "fluxo termina sem o evento fim";
+}
+
+// ============================================================================
+// RELATÓRIO
+// ============================================================================
+
+/**
+ * Descreve o resultado e as peças de um evento (ex.: "ok [T 12] <-> [I 9]")
+ */
+static int descreverEvento(const Evento* evento, char* destino, size_t tamanho) {
+    if (evento->tipo == EVT_FIM) {
+        return snprintf(destino, tamanho, "checksum %08x%08x", (uint32_t)evento->idB, (uint32_t)evento->idA);
+    }
+    if (evento->tipo == EVT_PECA_GERADA && evento->nomeA == 0) {
+        return snprintf(destino, tamanho, "recusada");
+    }
+    int n = snprintf(destino, tamanho, "%s", evento->tipo == EVT_PECA_GERADA ? "ok" :
+                     nomesResultados[evento->resultado]);
+    if (evento->tipo == EVT_TROCA_MULTIPLA) {
+        n += snprintf(destino + n, tamanho - n, " k=%d", evento->idA);
+    } else if (evento->nomeA != 0) {
+        n += snprintf(destino + n, tamanho - n, " [%c %d]", evento->nomeA, evento->idA);
+        if (evento->nomeB != 0) {
+            n += snprintf(destino + n, tamanho - n, " <-> [%c %d]", evento->nomeB, evento->idB);
+        }
+    }
+    return n;
+}
+
+/**
+ * Escreve a linha de uma sessão (uma única escrita, sem misturar com as
+ * linhas de outras threads)
+ */
+static void relatarSessao(const char* nome, const ResultadoVerificacao* resultado) {
+    char linha[MAX_NOME_SESSAO + 512];
+    int n = snprintf(linha, sizeof(linha), "%-12s %s", nomesSituacoes[resultado->situacao], nome);
+
+    if (resultado->situacao == SESSAO_DIVERGENTE) {
+        char registrado[128], reexecutado[128];
+        descreverEvento(&resultado->registrado, registrado, sizeof(registrado));
+        descreverEvento(&resultado->reexecutado, reexecutado, sizeof(reexecutado));
+        n += snprintf(linha + n, sizeof(linha) - n, ": passo %u (%s%s%s): registrado %s, reexecutado %s",
+                      resultado->registrado.sequencia, nomesEventos[resultado->registrado.tipo],
+                      resultado->motivo != NULL ? ", " : "", resultado->motivo != NULL ? resultado->motivo : "",
+                      registrado, reexecutado);
+    } else if (resultado->situacao != SESSAO_OK) {
+        n += snprintf(linha + n, sizeof(linha) - n, ": %s (%u eventos)", resultado->motivo, resultado->eventos);
+    } else {
+        n += snprintf(linha + n, sizeof(linha) - n, " (%u eventos)", resultado->eventos);
+    }
+    if (n > (int)sizeof(linha) - 2) {
+        n = (int)sizeof(linha) - 2;
+    }
+    linha[n++] = '\n';
+
+    flockfile(stdout);
+    fwrite(linha, 1, (size_t)n, stdout);
+    fflush(stdout);
+    funlockfile(stdout);
+}
+
+// ============================================================================
+// FONTES DE SESSÕES
+// ============================================================================
+
+static void adicionarEntrada(FonteSessoes* fonte, const char* caminho, int ehTar) {
+    if (fonte->numEntradas == fonte->capacidadeEntradas) {
+        fonte->capacidadeEntradas = fonte->capacidadeEntradas ? 2 * fonte->capacidadeEntradas : 1024;
+        fonte->entradas = realloc(fonte->entradas, sizeof(EntradaVerificacao) * fonte->capacidadeEntradas);
+    }
+    EntradaVerificacao* entrada = &fonte->entradas[fonte->numEntradas++];
+    entrada->caminho = strdup(caminho);
+    entrada->ehTar = ehTar;
+    entrada->mapa = NULL;
+    entrada->tamanho = 0;
+}
+
+/**
+ * Acrescenta todos os arquivos de um diretório e de seus subdiretórios
+ * @return 1 se bem-sucedido, 0 se o diretório não pôde ser lido
+ */
+static int adicionarDiretorio(FonteSessoes* fonte, const char* caminho) {
+    DIR* diretorio = opendir(caminho);
+    if (diretorio == NULL) {
+        return 0;
+    }
+
+    struct dirent* item;
+    char completo[MAX_NOME_SESSAO];
+    while ((item = readdir(diretorio)) != NULL) {
+        if (strcmp(item->d_name, ".") == 0 || strcmp(item->d_name, "..") == 0) {
+            continue;
+        }
+        snprintf(completo, sizeof(completo), "%s/%s", caminho, item->d_name);
+
+        int tipo = item->d_type;
+        if (tipo == DT_UNKNOWN) {
+            struct stat info;
+            if (stat(completo, &info) != 0) {
+                continue;
+            }
+            tipo = S_ISDIR(info.st_mode) ? DT_DIR : S_ISREG(info.st_mode) ? DT_REG : DT_UNKNOWN;
+        }
+        if (tipo == DT_DIR) {
+            adicionarDiretorio(fonte, completo);
+        } else if (tipo == DT_REG) {
+            adicionarEntrada(fonte, completo, 0);
+        }
+    }
+    closedir(diretorio);
+    return 1;
+}
+
+/**
+ * Verifica se um arquivo é um tar (assinatura "ustar" no primeiro cabeçalho)
+ */
+static int ehArquivoTar(const char* caminho) {
+    unsigned char cabecalho[TAR_TAM_BLOCO];
+    int fd = open(caminho, O_RDONLY);
+    if (fd < 0) {
+        return 0;
+    }
+    ssize_t lidos = pread(fd, cabecalho, sizeof(cabecalho), 0);
+    close(fd);
+    return lidos == TAR_TAM_BLOCO && memcmp(cabecalho + 257, "ustar", 5) == 0;
+}
+
+/**
+ * Mapeia um arquivo tar para leitura sequencial
+ * @return 1 se bem-sucedido, 0 caso contrário
+ */
+static int abrirTar(EntradaVerificacao* entrada) {
+    int fd = open(entrada->caminho, O_RDONLY);
+    if (fd < 0) {
+        return 0;
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size < TAR_TAM_BLOCO) {
+        close(fd);
+        return 0;
+    }
+    void* mapa = mmap(NULL, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (mapa == MAP_FAILED) {
+        return 0;
+    }
+    madvise(mapa, (size_t)info.st_size, MADV_SEQUENTIAL);
+    entrada->mapa = mapa;
+    entrada->tamanho = (size_t)info.st_size;
+    return 1;
+}
+
+/**
+ * Lê um campo numérico octal de um cabeçalho tar
+ */
+static uint64_t lerOctalTar(const unsigned char* campo, int tamanho) {
+    uint64_t valor = 0;
+    for (int i = 0; i < tamanho && campo[i] >= '0' && campo[i] <= '7'; i++) {
+        valor = valor * 8 + (uint64_t)(campo[i] - '0');
+    }
+    return valor;
+}
+
+/**
+ * Avança o tar atual até o próximo arquivo regular. Nomes longos
+ * (extensões GNU 'L' e pax "path=") são aplicados ao membro seguinte.
+ * Chamada com a trava da fonte.
+ * @param fonte Fonte com um tar atual
+ * @param sessao Recebe o membro encontrado
+ * @return 1 se encontrou um membro, 0 no fim do arquivo
+ */
+static int proximoMembroTar(FonteSessoes* fonte, SessaoVerificacao* sessao) {
+    EntradaVerificacao* tar = fonte->tarAtual;
+    char nomeLongo[MAX_NOME_SESSAO] = "";
+
+    while (fonte->cursorTar + TAR_TAM_BLOCO <= tar->tamanho) {
+        const unsigned char* cabecalho = tar->mapa + fonte->cursorTar;
+        if (cabecalho[0] == 0) {
+            return 0; // Bloco zerado: fim do arquivo
+        }
+
+        uint64_t tamanho = lerOctalTar(cabecalho + 124, 12);
+        size_t inicio = fonte->cursorTar + TAR_TAM_BLOCO;
+        if (tamanho > tar->tamanho - inicio) {
+            return 0; // Arquivo truncado
+        }
+        fonte->cursorTar = inicio + (size_t)((tamanho + TAR_TAM_BLOCO - 1) / TAR_TAM_BLOCO) * TAR_TAM_BLOCO;
+
+        char tipo = (char)cabecalho[156];
+        const char* dados = (const char*)tar->mapa + inicio;
+        if (tipo == 'L') {
+            snprintf(nomeLongo, sizeof(nomeLongo), "%.*s", (int)tamanho, dados);
+        } else if (tipo == 'x') {
+            // Registros pax: "<tamanho> chave=valor\n"
+            const char* caminho = memmem(dados, (size_t)tamanho, " path=", 6);
+            if (caminho != NULL) {
+                const char* fimCaminho = memchr(caminho, '\n', (size_t)(dados + tamanho - caminho));
+                if (fimCaminho != NULL) {
+                    snprintf(nomeLongo, sizeof(nomeLongo), "%.*s", (int)(fimCaminho - caminho - 6), caminho + 6);
+                }
+            }
+        } else if (tipo == '0' || tipo == '\0') {
+            if (nomeLongo[0] != '\0') {
+                snprintf(sessao->nome, sizeof(sessao->nome), "%s:%s", tar->caminho, nomeLongo);
+            } else if (cabecalho[345] != 0) {
+                snprintf(sessao->nome, sizeof(sessao->nome), "%s:%.155s/%.100s",
+                         tar->caminho, cabecalho + 345, cabecalho);
+            } else {
+                snprintf(sessao->nome, sizeof(sessao->nome), "%s:%.100s", tar->caminho, cabecalho);
+            }
+            sessao->dados = tar->mapa + inicio;
+            sessao->tamanho = (size_t)tamanho;
+            sessao->caminho = NULL;
+            return 1;
+        } else {
+            nomeLongo[0] = '\0'; // Diretórios, links etc. não são sessões
+        }
+    }
+    return 0;
+}
+
+/**
+ * Entrega a próxima sessão a verificar
+ * @param fonte Fonte compartilhada
+ * @param sessao Recebe a sessão
+ * @return 1 se há sessão, 0 quando acabaram
+ */
+static int proximaSessao(FonteSessoes* fonte, SessaoVerificacao* sessao) {
+    pthread_mutex_lock(&fonte->trava);
+    for (;;) {
+        if (fonte->tarAtual != NULL) {
+            if (proximoMembroTar(fonte, sessao)) {
+                break;
+            }
+            fonte->tarAtual = NULL;
+        }
+        if (fonte->proximaEntrada == fonte->numEntradas) {
+            pthread_mutex_unlock(&fonte->trava);
+            return 0;
+        }
+
+        EntradaVerificacao* entrada = &fonte->entradas[fonte->proximaEntrada++];
+        if (!entrada->ehTar) {
+            snprintf(sessao->nome, sizeof(sessao->nome), "%s", entrada->caminho);
+            sessao->dados = NULL;
+            sessao->caminho = entrada->caminho;
+            break;
+        }
+        if (abrirTar(entrada)) {
+            fonte->tarAtual = entrada;
+            fonte->cursorTar = 0;
+        } else {
+            fprintf(stderr, "Erro: nao foi possivel ler o arquivo '%s'.\n", entrada->caminho);
+        }
+    }
+    pthread_mutex_unlock(&fonte->trava);
+    return 1;
+}
+
+/**
+ * Lê um arquivo solto inteiro no buffer da thread
+ * @return 1 se bem-sucedido, 0 caso contrário
+ */
+static int lerArquivoSessao(TrabalhadorVerificacao* trabalhador, SessaoVerificacao* sessao) {
+    int fd = open(sessao->caminho, O_RDONLY);
+    if (fd < 0) {
+        return 0;
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0) {
+        close(fd);
+        return 0;
+    }
+    if ((size_t)info.st_size > trabalhador->capacidadeBuffer) {
+        free(trabalhador->buffer);
+        trabalhador->capacidadeBuffer = (size_t)info.st_size;
+        trabalhador->buffer = malloc(trabalhador->capacidadeBuffer);
+    }
+    posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+
+    size_t lidos = 0;
+    while (lidos < (size_t)info.st_size) {
+        ssize_t n = read(fd, trabalhador->buffer + lidos, (size_t)info.st_size - lidos);
+        if (n <= 0) {
+            break;
+        }
+        lidos += (size_t)n;
+    }
+    close(fd);
+
+    sessao->dados = trabalhador->buffer;
+    sessao->tamanho = lidos;
+    return 1;
+}
+
+// ============================================================================
+// VERIFICAÇÃO EM PARALELO
+// ============================================================================
+
+/**
+ * Laço de cada thread: pega sessões até acabarem
+ * @param argumento Ponteiro para o TrabalhadorVerificacao da thread
+ * @return NULL
+ */
+static void* threadVerificadora(void* argumento) {
+    TrabalhadorVerificacao* trabalhador = argumento;
+    SessaoVerificacao sessao;
+    ResultadoVerificacao resultado;
+
+    while (proximaSessao(trabalhador->fonte, &sessao)) {
+        if (sessao.caminho != NULL && !lerArquivoSessao(trabalhador, &sessao)) {
+            fprintf(stderr, "Erro: nao foi possivel ler '%s'.\n", sessao.caminho);
+            trabalhador->errosLeitura++;
+            continue;
+        }
+
+        verificarSessao(sessao.dados, sessao.tamanho, &resultado);
+        trabalhador->sessoes[resultado.situacao]++;
+        trabalhador->eventos += resultado.eventos;
+        trabalhador->bytes += sessao.tamanho;
+
+        if (resultado.situacao != SESSAO_OK || trabalhador->fonte->relatarTodas) {
+            relatarSessao(sessao.nome, &resultado);
+        }
+    }
+    return NULL;
+}
+
+// ============================================================================
+// PROGRAMA PRINCIPAL
+// ============================================================================
+
+int main(int argc, char* argv[]) {
+    long numThreads = sysconf(_SC_NPROCESSORS_ONLN);
+    FonteSessoes fonte;
+    memset(&fonte, 0, sizeof(fonte));
+    pthread_mutex_init(&fonte.trava, NULL);
+    modoSilencioso = 1;
+
+    int numCaminhos = 0;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            numThreads = strtol(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--todas") == 0) {
+            fonte.relatarTodas = 1;
+        } else {
+            struct stat info;
+            if (stat(argv[i], &info) != 0) {
+                fprintf(stderr, "Erro: '%s' nao existe.\n", argv[i]);
+                return 1;
+            }
+            if (S_ISDIR(info.st_mode)) {
+                if (!adicionarDiretorio(&fonte, argv[i])) {
+                    fprintf(stderr, "Erro: nao foi possivel ler o diretorio '%s'.\n", argv[i]);
+                    return 1;
+                }
+            } else {
+                adicionarEntrada(&fonte, argv[i], ehArquivoTar(argv[i]));
+            }
+            numCaminhos++;
+        }
+    }
+    if (numCaminhos == 0 || numThreads < 1) {
+        fprintf(stderr, "Uso: %s [--threads N] [--todas] CAMINHO...\n", argv[0]);
+        return 1;
+    }
+
+    struct timespec inicio, fim;
+    clock_gettime(CLOCK_MONOTONIC, &inicio);
+
+    TrabalhadorVerificacao* trabalhadores = aligned_alloc(64, sizeof(TrabalhadorVerificacao) * (size_t)numThreads);
+    pthread_t* threads = malloc(sizeof(pthread_t) * (size_t)numThreads);
+    memset(trabalhadores, 0, sizeof(TrabalhadorVerificacao) * (size_t)numThreads);
+    for (long t = 0; t < numThreads; t++) {
+        trabalhadores[t].fonte = &fonte;
+        pthread_create(&threads[t], NULL, threadVerificadora, &trabalhadores[t]);
+    }
+
+    uint64_t sessoes[NUM_SITUACOES] = {0};
+    uint64_t totalSessoes = 0, eventos = 0, bytes = 0, errosLeitura = 0;
+    for (long t = 0; t < numThreads; t++) {
+        pthread_join(threads[t], NULL);
+        for (int s = 0; s < NUM_SITUACOES; s++) {
+            sessoes[s] += trabalhadores[t].sessoes[s];
+            totalSessoes += trabalhadores[t].sessoes[s];
+        }
+        eventos += trabalhadores[t].eventos;
+        bytes += trabalhadores[t].bytes;
+        errosLeitura += trabalhadores[t].errosLeitura;
+        free(trabalhadores[t].buffer);
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &fim);
+    double segundos = (fim.tv_sec - inicio.tv_sec) + (fim.tv_nsec - inicio.tv_nsec) / 1e9;
+
+    printf("=== VERIFICACAO DE SESSOES ===\n");
+    printf("Sessoes: %llu  ok: %llu  divergentes: %llu  incompletas: %llu  invalidas: %llu  "
+           "incompativeis: %llu\n",
+           (unsigned long long)totalSessoes, (unsigned long long)sessoes[SESSAO_OK],
+           (unsigned long long)sessoes[SESSAO_DIVERGENTE], (unsigned long long)sessoes[SESSAO_INCOMPLETA],
+           (unsigned long long)sessoes[SESSAO_INVALIDA], (unsigned long long)sessoes[SESSAO_INCOMPATIVEL]);
+    if (errosLeitura > 0) {
+        printf("Arquivos ilegiveis: %llu\n", (unsigned long long)errosLeitura);
+    }
+    printf("Eventos: %llu  Dados: %.1f MiB  Tempo: %.3f s (%.1f MiB/s, %.0f sessoes/s, %ld threads)\n",
+           (unsigned long long)eventos, bytes / 1048576.0, segundos,
+           segundos > 0 ? bytes / 1048576.0 / segundos : 0.0,
+           segundos > 0 ? totalSessoes / segundos : 0.0, numThreads);
+
+    for (size_t e = 0; e < fonte.numEntradas; e++) {
+        if (fonte.entradas[e].mapa != NULL) {
+            munmap((void*)fonte.entradas[e].mapa, fonte.entradas[e].tamanho);
+        }
+        free(fonte.entradas[e].caminho);
+    }
+    free(fonte.entradas);
+    free(threads);
+    free(trabalhadores);
+    pthread_mutex_destroy(&fonte.trava);
+
+    return (totalSessoes == sessoes[SESSAO_OK] && errosLeitura == 0) ? 0 : 2;
+}